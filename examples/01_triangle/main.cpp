@@ -121,7 +121,7 @@ int main() {
         0.0, 0.0, 1.0 // Top Center
     };
 
-    const unsigned int indices[] = {
+    const vector<GLuint> indices = {
         0, 1, 2, // First Triangle
     };
 
@@ -132,7 +132,7 @@ int main() {
     array.bind();
     array.bufferData(0, sizeof(vertices), vertices);
     array.bufferData(1, sizeof(colors), colors);
-    array.bufferElements(sizeof(indices), indices);
+    array.bufferElements(indices);
     array.unbind();
 
     // uncomment this call to draw in wireframe polygons.
@@ -145,7 +145,7 @@ int main() {
 
         shader.bind();
         array.drawArrays(Buffer::Triangles, 0, 3);
-        array.drawElements(Buffer::Triangles, 3, GL_UNSIGNED_INT, 0);
+        array.drawElements(Buffer::Triangles);
 
         glfwSwapBuffers(window);
     }
@@ -16,11 +16,17 @@ static const char * vertexShaderSource = R"(
 #version 330 core
 layout (location = 0) in vec3 aPos;
 layout (location = 1) in vec3 aCol;
-uniform mat4 vp;
+layout (std140) uniform Frame {
+    mat4 view;
+    mat4 projection;
+    mat4 viewProj;
+    vec3 cameraPos;
+    vec2 screenSize;
+};
 uniform mat4 model;
 out vec3 color;
 void main() {
-    gl_Position = vp * model * vec4(aPos, 1.0);
+    gl_Position = viewProj * model * vec4(aPos, 1.0);
     color = aCol;
 })";
 
@@ -100,7 +106,7 @@ int main() {
     scam = &camera;
 
     Shader shader(vertexShaderSource, fragmentShaderSource);
-    auto vpUniform = shader.uniform("vp");
+    shader.bindUniformBlock("Frame", FrameUniforms::binding);
     auto modelUniform = shader.uniform("model");
 
     const float vertices[] = {
@@ -168,8 +174,9 @@ int main() {
             }
         }
 
+        camera.bindFrame();
+
         shader.bind();
-        vpUniform.setMat4(camera.projMatrix() * camera.viewMatrix());
         modelUniform.setMat4(glm::mat4(1));
         array.drawArrays(Buffer::Triangles, 0, 9);
 
@@ -1,5 +1,7 @@
 #include <glpp/Buffer.hpp>
+#include <glpp/BufferArena.hpp>
 #include <glpp/Shader.hpp>
+#include <glpp/VertexArrayCache.hpp>
 #include <glpp/extra/debug.hpp>
 using namespace glpp;
 
@@ -17,11 +19,17 @@ static const char * vertexShaderSource = R"(
 #version 330 core
 layout (location = 0) in vec3 aPos;
 layout (location = 1) in vec3 aCol;
-uniform mat4 vp;
+layout (std140) uniform Frame {
+    mat4 view;
+    mat4 projection;
+    mat4 viewProj;
+    vec3 cameraPos;
+    vec2 screenSize;
+};
 uniform mat4 model;
 out vec3 color;
 void main() {
-    gl_Position = vp * model * vec4(aPos, 1.0);
+    gl_Position = viewProj * model * vec4(aPos, 1.0);
     color = aCol;
 })";
 
@@ -101,7 +109,7 @@ int main() {
     scam = &camera;
 
     Shader shader(vertexShaderSource, fragmentShaderSource);
-    auto vpUniform = shader.uniform("vp");
+    shader.bindUniformBlock("Frame", FrameUniforms::binding);
     auto modelUniform = shader.uniform("model");
 
     Grid grid(10, {1, 1, 1, 1}, true);
@@ -172,16 +180,21 @@ int main() {
             }
         }
 
+        camera.bindFrame();
+
         shader.bind();
-        vpUniform.setMat4(camera.projMatrix() * camera.viewMatrix());
         modelUniform.setMat4(glm::mat4(1));
         array.drawArrays(Buffer::Triangles, 0, 9);
 
-        grid.draw(camera.projMatrix() * camera.viewMatrix());
+        grid.draw(glm::mat4(1));
 
         glfwSwapBuffers(window);
     }
 
+    // Cached vertex arrays and arena pages belong to this context
+    VertexArrayCache::current().clear();
+    BufferArena::current().clear();
+
     glfwDestroyWindow(window);
     glfwTerminate();
 
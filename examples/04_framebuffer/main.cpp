@@ -1,6 +1,8 @@
 #include <glpp/Buffer.hpp>
+#include <glpp/BufferArena.hpp>
 #include <glpp/FrameBuffer.hpp>
 #include <glpp/Shader.hpp>
+#include <glpp/VertexArrayCache.hpp>
 #include <glpp/extra/debug.hpp>
 using namespace glpp;
 
@@ -121,7 +123,7 @@ int main() {
         0.0f,  0.5f, // Top Center
     };
 
-    const unsigned int indices[] = {
+    const vector<GLuint> indices = {
         0, 1, 2, // First Triangle
     };
 
@@ -132,7 +134,7 @@ int main() {
     array.bind();
     array.bufferData(0, sizeof(vertices), vertices);
     array.bufferData(1, sizeof(texCoords), texCoords);
-    array.bufferElements(sizeof(indices), indices);
+    array.bufferElements(indices);
     array.unbind();
 
     Quad quad ({0, 0}, {1, 1});
@@ -192,7 +194,7 @@ int main() {
 
         shader.bind();
         texture.bind();
-        array.drawElements(Buffer::Triangles, 3, GL_UNSIGNED_INT, 0);
+        array.drawElements(Buffer::Triangles);
 
         FrameBuffer::getDefault().bind();
         FrameBuffer::getDefault().setViewport();
@@ -209,6 +211,10 @@ int main() {
         glfwSwapBuffers(window);
     }
 
+    // Cached vertex arrays and arena pages belong to this context
+    VertexArrayCache::current().clear();
+    BufferArena::current().clear();
+
     glfwDestroyWindow(window);
     glfwTerminate();
 
@@ -1,6 +1,8 @@
 #include <glpp/Buffer.hpp>
+#include <glpp/BufferArena.hpp>
 #include <glpp/FrameBuffer.hpp>
 #include <glpp/Shader.hpp>
+#include <glpp/VertexArrayCache.hpp>
 #include <glpp/extra/debug.hpp>
 using namespace glpp;
 
@@ -263,8 +265,11 @@ int main() {
 
     Grid grid(10, {1, 1, 1, 1}, true);
 
+    // Share the 4 corners of each face instead of drawing 36 vertices
+    IndexedMesh cubeMesh = IndexedMesh::weld(cube);
+
     VertexBufferArray vba;
-    vba.bufferData(cube);
+    vba.bufferData(cubeMesh);
     vba.unbind();
 
     GeometryBuffer gb(uvec2(width, height));
@@ -273,7 +278,6 @@ int main() {
     gb.unbind();
 
     Shader & gShader = GeometryBuffer::getShader();
-    auto gvp = gShader.uniform("vp");
     auto gmodel = gShader.uniform("model");
 
     Shader screenShader(screenVertexShaderSource, screenFragmentShaderSource);
@@ -325,11 +329,11 @@ int main() {
 
         {
             glEnable(GL_DEPTH_TEST);
+            camera.bindFrame();
             gShader.bind();
             texture.bind();
-            gvp.setMat4(camera.projMatrix() * camera.viewMatrix());
             gmodel.setMat4(glm::mat4(1));
-            vba.drawArrays(Buffer::Triangles, 0, cube.size());
+            vba.drawElements(Buffer::Triangles);
         }
 
         FrameBuffer::getDefault().bind();
@@ -350,7 +354,7 @@ int main() {
 
         {
             // glEnable(GL_DEPTH_TEST);
-            // grid.draw(camera.projMatrix() * camera.viewMatrix());
+            // grid.draw(glm::mat4(1));
 
             glDisable(GL_DEPTH_TEST);
             screenShader.bind();
@@ -363,6 +367,10 @@ int main() {
         glfwSwapBuffers(window);
     }
 
+    // Cached vertex arrays and arena pages belong to this context
+    VertexArrayCache::current().clear();
+    BufferArena::current().clear();
+
     glfwDestroyWindow(window);
     glfwTerminate();
 
@@ -1,5 +1,7 @@
 #include <glpp/Buffer.hpp>
+#include <glpp/BufferArena.hpp>
 #include <glpp/Shader.hpp>
+#include <glpp/VertexArrayCache.hpp>
 #include <glpp/extra/debug.hpp>
 using namespace glpp;
 
@@ -146,17 +148,21 @@ int main() {
             }
         }
 
-        auto vp = camera.projMatrix() * camera.viewMatrix();
+        camera.bindFrame();
 
-        line1.draw(vp);
-        line2.draw(vp);
-        line3.draw(vp);
-        axm.draw(vp);
-        dm.draw(vp);
+        line1.draw(glm::mat4(1));
+        line2.draw(glm::mat4(1));
+        line3.draw(glm::mat4(1));
+        axm.draw(glm::mat4(1));
+        dm.draw(glm::mat4(1));
 
         glfwSwapBuffers(window);
     }
 
+    // Cached vertex arrays and arena pages belong to this context
+    VertexArrayCache::current().clear();
+    BufferArena::current().clear();
+
     glfwDestroyWindow(window);
     glfwTerminate();
 
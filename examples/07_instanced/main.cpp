@@ -1,14 +1,26 @@
 #include <glpp/Buffer.hpp>
+#include <glpp/InstanceBuffer.hpp>
 #include <glpp/Shader.hpp>
+#include <glpp/VertexLayout.hpp>
 #include <glpp/extra/debug.hpp>
 using namespace glpp;
 
 #include <GLFW/glfw3.h>
 
+#include <cmath>
 #include <iostream>
+#include <memory>
 #include <vector>
 using namespace std;
 
+struct Instance {
+    float scale;
+    glm::vec2 offset;
+};
+
+using InstanceLayout =
+    VertexLayout<Instance, &Instance::scale, &Instance::offset>;
+
 static const char * vertexShaderSource = R"(
 #version 330 core
 layout (location = 0) in vec3 aPos;
@@ -98,34 +110,27 @@ int main() {
         1.0, 0.0, 1.0, //
     };
 
-    const float iScale[] = {
-        0.1, //
-        0.2, //
-        0.1, //
-        0.1, //
-        0.1, //
-    };
-
-    const float iOffset[] = {
-        -1.0, -1.0, //
-        0.0,  0.0, //
-        -1.0, 0.8, //
-        -0.8, 0.8, //
-        -0.6, 0.8, //
-    };
-
     Buffer::Attribute a0 (0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float));
     Buffer::Attribute a1 (1, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float));
-    Buffer::Attribute a2 (2, 1, GL_FLOAT, GL_FALSE, 1 * sizeof(float), nullptr, 1);
-    Buffer::Attribute a3 (3, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), nullptr, 1);
 
-    BufferArray array(vector<vector<Buffer::Attribute>> {{a0}, {a1}, {a2}, {a3}});
-    array.drawArrays(Buffer::LineStrip, 0, 4);
-    array.bind();
+    // Scale and offset at locations 2 and 3 with a divisor of 1
+    auto instances = make_shared<InstanceBuffer<Instance>>(
+        InstanceLayout::attributes(2, 1));
+    instances->assign({
+        {0.1, {-1.0, -1.0}},
+        {0.2, {0.0, 0.0}},
+        {0.1, {-1.0, 0.8}},
+        {0.1, {-0.8, 0.8}},
+        {0.1, {-0.6, 0.8}},
+    });
+
+    BufferArray array(vector<Buffer::Ptr> {
+        make_shared<Buffer>(vector<Buffer::Attribute> {a0}),
+        make_shared<Buffer>(vector<Buffer::Attribute> {a1}),
+        instances,
+    });
     array.bufferData(0, sizeof(vertices), vertices);
     array.bufferData(1, sizeof(colors), colors);
-    array.bufferData(2, sizeof(iScale), iScale);
-    array.bufferData(3, sizeof(iOffset), iOffset);
     array.unbind();
 
     // uncomment this call to draw in wireframe polygons.
@@ -136,8 +141,11 @@ int main() {
 
         glClear(GL_COLOR_BUFFER_BIT);
 
+        // Only the changed instance is uploaded
+        instances->edit(1).scale = 0.2 + 0.1 * sin(glfwGetTime());
+
         shader.bind();
-        array.drawArraysInstanced(Buffer::TriangleStrip, 0, 4, 5);
+        instances->drawArrays(array, Buffer::TriangleStrip, 0, 4);
 
         glfwSwapBuffers(window);
     }
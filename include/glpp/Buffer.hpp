@@ -7,12 +7,20 @@
 #include <cstddef>
 #include <glm/glm.hpp>
 #include <memory>
+#include <stdexcept>
 #include <vector>
 
 namespace glpp {
     using std::vector;
     using std::shared_ptr;
 
+    class IndirectCommandBuffer;
+
+    class BufferException : public std::runtime_error {
+    public:
+        using std::runtime_error::runtime_error;
+    };
+
     /**
      * A single array buffer.
      */
@@ -32,6 +40,8 @@ namespace glpp {
             GLsizei stride;
             const void * pointer;
             GLuint divisor = 0;
+            /// Read as int, ivec or uvec with glVertexAttribIPointer
+            bool integer = false;
 
             Attribute(GLuint index,
                       GLint size,
@@ -39,7 +49,8 @@ namespace glpp {
                       bool normalized,
                       GLsizei stride,
                       const void * pointer = nullptr,
-                      GLuint divisor = 0);
+                      GLuint divisor = 0,
+                      bool integer = false);
 
             Attribute(const Attribute & other) = default;
 
@@ -54,6 +65,28 @@ namespace glpp {
             void disable() const;
 
             bool isInstanced() const;
+
+            /**
+             * Check if type is an integer type that can be read without
+             * conversion to float.
+             *
+             * @param type the component type
+             *
+             * @return true for GL_BYTE through GL_UNSIGNED_INT
+             */
+            static constexpr bool isIntegerType(GLenum type) {
+                switch (type) {
+                    case GL_BYTE:
+                    case GL_UNSIGNED_BYTE:
+                    case GL_SHORT:
+                    case GL_UNSIGNED_SHORT:
+                    case GL_INT:
+                    case GL_UNSIGNED_INT:
+                        return true;
+                    default:
+                        return false;
+                }
+            }
         };
 
         enum Target {
@@ -64,6 +97,9 @@ namespace glpp {
             TransformFeedback = GL_TRANSFORM_FEEDBACK_BUFFER,
             PixelPack = GL_PIXEL_PACK_BUFFER,
             PixelUnpack = GL_PIXEL_UNPACK_BUFFER,
+            CopyRead = GL_COPY_READ_BUFFER,
+            CopyWrite = GL_COPY_WRITE_BUFFER,
+            DrawIndirect = GL_DRAW_INDIRECT_BUFFER,
         };
 
         /**
@@ -76,12 +112,16 @@ namespace glpp {
             Stream = GL_STREAM_DRAW,
             /// Data will be buffered and used once
             Dynamic = GL_DYNAMIC_DRAW,
+            /// Data will be written by OpenGL and read back once
+            StreamRead = GL_STREAM_READ,
         };
 
         /**
          * OpenGL Draw mode.
          */
         enum Mode {
+            Points = GL_POINTS,
+
             Lines = GL_LINES,
             LineStrip = GL_LINE_STRIP,
             LineLoop = GL_LINE_LOOP,
@@ -95,6 +135,40 @@ namespace glpp {
         Target target;
         GLuint buffer;
         vector<Attribute> attrib;
+        GLsizeiptr size;
+        GLsizeiptr capacity;
+        Usage usage;
+        std::size_t reallocations;
+        bool immutable;
+
+        /**
+         * Allocate storage with glBufferData, or glNamedBufferData when
+         * direct state access is available.
+         */
+        void storeData(GLsizeiptr size, const void * data, Usage usage);
+
+        /**
+         * Report the current capacity to the ResourceTracker.
+         */
+        void trackMemory() const;
+
+        /**
+         * Delete the buffer and forget it in the caches.
+         */
+        void release();
+
+    protected:
+        /**
+         * Record storage allocated by a subclass outside of bufferData, such
+         * as immutable storage from glBufferStorage. The size and capacity
+         * are both set to capacity and reported to the ResourceTracker. The
+         * buffer is marked immutable, after which reserve, bufferData and
+         * bufferSubData throw BufferException.
+         *
+         * @param capacity the size in bytes of the storage
+         * @param usage the usage hint to report
+         */
+        void setStorage(GLsizeiptr capacity, Usage usage);
 
     public:
         /**
@@ -129,6 +203,13 @@ namespace glpp {
 
         Target getTarget() const;
 
+        /**
+         * Get the attributes this buffer was created with.
+         *
+         * @return the attributes, empty for buffers without vertex data
+         */
+        const vector<Attribute> & getAttributes() const;
+
         GLuint getBufferId() const;
 
         bool isInstanced() const;
@@ -139,11 +220,192 @@ namespace glpp {
 
         void unbind() const;
 
+        /**
+         * Bind the buffer to an indexed binding point of its target with
+         * glBindBufferBase. Only valid for the Uniform, ShaderStorage and
+         * TransformFeedback targets.
+         *
+         * @param index the binding index
+         */
+        void bindBase(GLuint index) const;
+
+        /**
+         * Bind part of the buffer to an indexed binding point of its target
+         * with glBindBufferRange. The offset must be a multiple of the
+         * target's offset alignment, such as
+         * GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT.
+         *
+         * @param index the binding index
+         * @param offset the offset in bytes
+         * @param size the size in bytes
+         */
+        void bindRange(GLuint index, GLintptr offset, GLsizeiptr size) const;
+
+        /**
+         * Get the size in bytes of the data from the last call to bufferData.
+         *
+         * @return the data size
+         */
+        GLsizeiptr getSize() const;
+
+        /**
+         * Get the size in bytes of the allocated storage, which may be larger
+         * than getSize().
+         *
+         * @return the storage capacity
+         */
+        GLsizeiptr getCapacity() const;
+
+        /**
+         * Get the usage hint of the allocated storage.
+         *
+         * @return the usage
+         */
+        Usage getUsage() const;
+
+        /**
+         * Get the number of times storage was allocated with glBufferData.
+         *
+         * @return the number of allocations
+         */
+        std::size_t getReallocations() const;
+
+        /**
+         * Check if the storage is immutable, allocated by a subclass such as
+         * StreamBuffer with glBufferStorage.
+         *
+         * @return true if the storage can not be changed with bufferData
+         */
+        bool isImmutable() const;
+
+        /**
+         * Allocate storage for at least capacity bytes. Does nothing if the
+         * capacity and usage already match, otherwise the current contents
+         * are discarded. Reserving 0 bytes before any storage is allocated
+         * only sets the usage used by later calls.
+         *
+         * @param capacity the minimum capacity in bytes
+         * @param usage the usage hint
+         *
+         * @throws BufferException if the storage is immutable
+         */
+        void reserve(GLsizeiptr capacity, Usage usage = Static);
+
+        /**
+         * Send data to the buffer.
+         *
+         * Storage is only allocated if size is larger than the current
+         * capacity or usage changed. The new capacity is at least double the
+         * old capacity. Otherwise the data is written with glBufferSubData into
+         * the existing storage. Stream and Dynamic buffers are orphaned first
+         * so the write does not wait for draws still using the old data.
+         *
+         * @param size the data size in bytes
+         * @param data the data, or nullptr to only allocate
+         * @param usage the usage hint
+         *
+         * @throws BufferException if the storage is immutable
+         */
         void bufferData(GLsizeiptr size, const void * data, Usage usage = Static);
 
+        /**
+         * Write data into the existing storage.
+         *
+         * @param offset the offset in bytes
+         * @param size the data size in bytes
+         * @param data the data
+         *
+         * @throws BufferException if the storage is immutable
+         */
         void bufferSubData(GLintptr offset, GLsizeiptr size, const void * data);
     };
 
+    /**
+     * A Buffer with the Index target that remembers the count and type of
+     * its indices.
+     *
+     * Indices given as GLuint are stored with the smallest type that can
+     * hold the largest index.
+     */
+    class ElementBuffer : public Buffer {
+    public:
+        using Ptr = shared_ptr<ElementBuffer>;
+        using ConstPtr = const shared_ptr<ElementBuffer>;
+
+    private:
+        GLsizei count;
+        GLenum type;
+
+    public:
+        /**
+         * Create an empty element buffer.
+         */
+        ElementBuffer();
+
+        ElementBuffer(ElementBuffer && other);
+
+        ElementBuffer & operator=(ElementBuffer && other);
+
+        ElementBuffer(const ElementBuffer &) = delete;
+        ElementBuffer & operator=(const ElementBuffer &) = delete;
+
+        virtual ~ElementBuffer();
+
+        /**
+         * Get the number of indices.
+         *
+         * @return the index count
+         */
+        GLsizei getCount() const;
+
+        /**
+         * Get the index type.
+         *
+         * @return GL_UNSIGNED_BYTE, GL_UNSIGNED_SHORT or GL_UNSIGNED_INT
+         */
+        GLenum getType() const;
+
+        /**
+         * Send indices to the buffer using the smallest type that can hold
+         * the largest index.
+         *
+         * @param indices the indices
+         * @param usage the buffer usage hint
+         */
+        void bufferElements(const vector<GLuint> & indices, Usage usage = Static);
+
+        /**
+         * Send indices that are already in type to the buffer.
+         *
+         * @param size the data size in bytes
+         * @param data the index data
+         * @param type the index type
+         * @param usage the buffer usage hint
+         */
+        void bufferElements(GLsizeiptr size,
+                            const void * data,
+                            GLenum type,
+                            Usage usage = Static);
+
+        /**
+         * Get the smallest index type that can hold maxIndex.
+         *
+         * @param maxIndex the largest index
+         *
+         * @return GL_UNSIGNED_BYTE, GL_UNSIGNED_SHORT or GL_UNSIGNED_INT
+         */
+        static GLenum typeFor(GLuint maxIndex);
+
+        /**
+         * Get the size in bytes of an index type.
+         *
+         * @param type GL_UNSIGNED_BYTE, GL_UNSIGNED_SHORT or GL_UNSIGNED_INT
+         *
+         * @return the size of one index
+         */
+        static GLsizeiptr typeSize(GLenum type);
+    };
+
     class BufferArray {
     public:
         using Ptr = shared_ptr<BufferArray>;
@@ -152,7 +414,7 @@ namespace glpp {
     private:
         GLuint array;
         vector<Buffer::Ptr> buffers;
-        Buffer::Ptr elementBuffer;
+        ElementBuffer::Ptr elementBuffer;
 
     public:
         using Usage = Buffer::Usage;
@@ -190,6 +452,21 @@ namespace glpp {
 
         static void unbind();
 
+        /**
+         * Bind buffer to this array and enable attributes with their pointer
+         * moved by offset. Use this to source vertex data from a range of a
+         * shared buffer, like a BufferArena::Block.
+         *
+         * The buffer is not added to getBuffers().
+         *
+         * @param buffer the buffer to source vertex data from
+         * @param attributes the attributes to enable
+         * @param offset offset in bytes added to the pointer of each attribute
+         */
+        void attach(const Buffer & buffer,
+                    const vector<Buffer::Attribute> & attributes,
+                    GLintptr offset = 0);
+
         inline void bufferData(size_t index,
                                GLsizeiptr size,
                                const void * data,
@@ -204,10 +481,38 @@ namespace glpp {
             buffers[index]->bufferSubData(offset, size, data);
         }
 
+        /**
+         * Send raw index data to the element buffer.
+         *
+         * @param size the data size in bytes
+         * @param data the index data
+         * @param usage the buffer usage hint
+         * @param type the index type used by drawElements(Mode)
+         */
         void bufferElements(GLsizeiptr size,
                             const void * data,
+                            Usage usage = Usage::Static,
+                            GLenum type = GL_UNSIGNED_INT);
+
+        /**
+         * Send indices to the element buffer with the smallest index type
+         * that can hold them.
+         *
+         * @param indices the indices
+         * @param usage the buffer usage hint
+         *
+         * @see ElementBuffer::bufferElements
+         */
+        void bufferElements(const vector<GLuint> & indices,
                             Usage usage = Usage::Static);
 
+        /**
+         * Get the element buffer.
+         *
+         * @return the element buffer, or nullptr before bufferElements
+         */
+        const ElementBuffer::Ptr & getElementBuffer() const;
+
         void drawArrays(Mode mode, GLint first, GLsizei count) const;
 
 
@@ -221,11 +526,56 @@ namespace glpp {
                           GLenum type,
                           const void * indices) const;
 
+        /**
+         * Draw all indices in the element buffer with their stored type.
+         *
+         * @param mode the draw mode
+         */
+        void drawElements(Mode mode) const;
+
 
         void drawElementsInstanced(Mode mode,
                                    GLsizei count,
                                    GLenum type,
                                    const void * indices,
                                    GLsizei primcount) const;
+
+        /**
+         * Draw primcount instances of all indices in the element buffer.
+         *
+         * @param mode the draw mode
+         * @param primcount the number of instances
+         */
+        void drawElementsInstanced(Mode mode, GLsizei primcount) const;
+
+        /**
+         * Draw all array commands of commands in a single
+         * glMultiDrawArraysIndirect call. The commands are uploaded first if
+         * they changed.
+         *
+         * Without OpenGL 4.3 or ARB_multi_draw_indirect, each command is
+         * drawn with a separate instanced draw call.
+         *
+         * @param mode the draw mode
+         * @param commands the command buffer
+         */
+        void multiDrawArraysIndirect(Mode mode,
+                                     IndirectCommandBuffer & commands) const;
+
+        /**
+         * Draw all element commands of commands in a single
+         * glMultiDrawElementsIndirect call. The commands are uploaded first if
+         * they changed.
+         *
+         * Without OpenGL 4.3 or ARB_multi_draw_indirect, each command is
+         * drawn with a separate instanced base vertex draw call.
+         *
+         * @param mode the draw mode
+         * @param type the type of the element buffer indices
+         * @param commands the command buffer
+         */
+        void multiDrawElementsIndirect(Mode mode,
+                                       GLenum type,
+                                       IndirectCommandBuffer & commands) const;
     };
 }
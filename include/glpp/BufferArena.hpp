@@ -0,0 +1,180 @@
+#pragma once
+
+#include <GL/glew.h>
+// gl.h after glew.h, clang-format don't sort
+#include <GL/gl.h>
+
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <vector>
+
+#include "Buffer.hpp"
+
+namespace glpp {
+    using std::vector;
+    using std::shared_ptr;
+
+    /**
+     * Sub-allocator that hands out ranges of a few large Buffer pages to many
+     * small objects.
+     *
+     * Each page keeps a free list of unused ranges ordered by offset.
+     * Allocation is first fit and freed ranges are merged with their
+     * neighbors. An allocation larger than the page size gets a page of its
+     * own.
+     *
+     * Allocations are reference counted and return their range to the arena
+     * when the last reference is dropped. Calling defragment may move an
+     * allocation to a different offset in the same page, in which case
+     * Block::version is incremented so the owner can update any attribute
+     * pointers that use the offset.
+     */
+    class BufferArena {
+    public:
+        using Ptr = shared_ptr<BufferArena>;
+        using ConstPtr = const shared_ptr<BufferArena>;
+
+        /**
+         * A range of bytes in one of the arena pages.
+         */
+        struct Block {
+            /// The page buffer this block lives in
+            Buffer::Ptr buffer;
+            /// Offset in bytes from the start of the page buffer
+            GLintptr offset;
+            /// Size in bytes of the block
+            GLsizeiptr size;
+            /// Alignment in bytes of offset
+            GLsizeiptr alignment;
+            /// Incremented every time the block is moved by defragment
+            unsigned int version;
+            /// Index of the page in the arena
+            std::size_t page;
+
+            /**
+             * Replace a subset of the block with new data.
+             *
+             * @param offset offset in bytes from the start of the block
+             * @param size the number of bytes to write
+             * @param data the data to write
+             */
+            void bufferSubData(GLintptr offset,
+                               GLsizeiptr size,
+                               const void * data) const;
+        };
+
+        using Allocation = shared_ptr<Block>;
+
+    private:
+        struct Page {
+            Buffer::Ptr buffer;
+            GLsizeiptr size;
+            std::map<GLintptr, GLsizeiptr> freeList;
+            vector<Block *> blocks;
+        };
+
+        shared_ptr<vector<Page>> pages;
+        GLsizeiptr pageSize;
+        Buffer::Usage usage;
+
+        std::size_t addPage(GLsizeiptr size);
+
+        static void release(vector<Page> & pages, Block * block);
+
+    public:
+        /**
+         * Create an empty arena. No buffers are created until the first
+         * allocation.
+         *
+         * @param pageSize the size in bytes of each page buffer
+         * @param usage the usage hint for the page buffers
+         */
+        BufferArena(GLsizeiptr pageSize = 1 << 20,
+                    Buffer::Usage usage = Buffer::Dynamic);
+
+        BufferArena(BufferArena && other) = default;
+
+        BufferArena & operator=(BufferArena && other) = default;
+
+        BufferArena(const BufferArena &) = delete;
+        BufferArena & operator=(const BufferArena &) = delete;
+
+        /**
+         * Destroy the arena and its page buffers. Outstanding allocations
+         * keep their page Buffer alive but are no longer returned to the
+         * arena.
+         */
+        virtual ~BufferArena();
+
+        /**
+         * Get the size in bytes of a regular page.
+         *
+         * @return the page size
+         */
+        GLsizeiptr getPageSize() const;
+
+        /**
+         * Get the number of page buffers.
+         *
+         * @return the number of pages
+         */
+        std::size_t getPageCount() const;
+
+        /**
+         * Get the total size in bytes of all page buffers.
+         *
+         * @return the capacity in bytes
+         */
+        GLsizeiptr getCapacity() const;
+
+        /**
+         * Get the total size in bytes of all live allocations.
+         *
+         * @return the allocated bytes
+         */
+        GLsizeiptr getAllocated() const;
+
+        /**
+         * Get the number of live allocations.
+         *
+         * @return the number of blocks
+         */
+        std::size_t getBlockCount() const;
+
+        /**
+         * Reserve a range of size bytes in one of the page buffers. A new page
+         * is created if no page has a large enough free range.
+         *
+         * @param size the number of bytes to reserve
+         * @param alignment the alignment in bytes of the block offset
+         *
+         * @return the allocation, freed when the last reference is dropped
+         */
+        Allocation allocate(GLsizeiptr size, GLsizeiptr alignment = 16);
+
+        /**
+         * Move all blocks of each page to the start of the page, merging the
+         * free space into a single range at the end of the page. Block
+         * contents are copied on the GPU and the version of every moved block
+         * is incremented.
+         */
+        void defragment();
+
+        /**
+         * Drop all page buffers. Outstanding allocations keep their page
+         * Buffer alive but are no longer returned to the arena. Call this
+         * before destroying the context the pages were created in.
+         */
+        void clear();
+
+        /**
+         * Get the arena shared by the glpp::extra primitives on the calling
+         * thread. The pages belong to the context current on that thread,
+         * call clear before destroying it.
+         *
+         * @return the thread's arena
+         */
+        static BufferArena & current();
+    };
+}
@@ -4,10 +4,12 @@
 // gl.h after glew.h, clang-format don't sort
 #include <GL/gl.h>
 
+#include <cstddef>
 #include <glm/glm.hpp>
 #include <memory>
 #include <vector>
 
+#include "Buffer.hpp"
 #include "Texture.hpp"
 
 namespace glpp {
@@ -52,6 +54,95 @@ namespace glpp {
         void unbind() const;
     };
 
+    /**
+     * Handle to pixels being copied from a FrameBuffer into a PixelPack
+     * buffer, returned by FrameBuffer::readPixelsAsync.
+     *
+     * The copy is finished when the fence is signaled. Poll isReady or call
+     * wait before map to avoid stalling. Rows are padded to a multiple of 4
+     * bytes, the default GL_PACK_ALIGNMENT.
+     */
+    class PixelReadback {
+        Buffer::Ptr buffer;
+        GLsync fence;
+        glm::uvec4 rect;
+        GLsizeiptr rowSize;
+        const void * mapped;
+
+    public:
+        /**
+         * Create a handle for a read that was already sent to OpenGL.
+         *
+         * @param buffer the PixelPack buffer the pixels are read into
+         * @param fence the fence placed after the read, owned by the handle
+         * @param rect the read rectangle as x, y, width, height
+         * @param rowSize the size in bytes of each row in buffer
+         */
+        PixelReadback(const Buffer::Ptr & buffer,
+                      GLsync fence,
+                      const glm::uvec4 & rect,
+                      GLsizeiptr rowSize);
+
+        PixelReadback(PixelReadback && other);
+
+        PixelReadback & operator=(PixelReadback && other);
+
+        PixelReadback(const PixelReadback &) = delete;
+        PixelReadback & operator=(const PixelReadback &) = delete;
+
+        virtual ~PixelReadback();
+
+        /**
+         * Get the read rectangle.
+         *
+         * @return the rectangle as x, y, width, height
+         */
+        const glm::uvec4 & getRect() const;
+
+        /**
+         * Get the size in bytes of each row including padding.
+         *
+         * @return the row size
+         */
+        GLsizeiptr getRowSize() const;
+
+        /**
+         * Get the size in bytes of all rows.
+         *
+         * @return the data size
+         */
+        GLsizeiptr getSize() const;
+
+        /**
+         * Check if the read has finished without waiting.
+         *
+         * @return true if the pixels can be mapped without stalling
+         */
+        bool isReady();
+
+        /**
+         * Wait for the read to finish.
+         *
+         * @param timeout the maximum time to wait in nanoseconds
+         *
+         * @return true if the read finished before timeout
+         */
+        bool wait(GLuint64 timeout = ~GLuint64(0));
+
+        /**
+         * Wait for the read to finish and map the pixels for reading. The
+         * pointer is valid until unmap or the handle is destroyed.
+         *
+         * @return the pixel data, or nullptr if mapping failed
+         */
+        const void * map();
+
+        /**
+         * Unmap the pixels if they are mapped.
+         */
+        void unmap();
+    };
+
     /**
      * Manage a single frame buffer object.
      */
@@ -79,11 +170,18 @@ namespace glpp {
         };
 
     private:
+        /// Number of PixelPack buffers used by readPixelsAsync
+        static constexpr std::size_t readBufferCount = 3;
+
         GLuint buffer;
         vector<Attachment> attachments;
         glm::uvec2 size;
+        vector<Buffer::Ptr> readBuffers;
+        std::size_t nextReadBuffer;
 
-        FrameBuffer(GLuint buffer) : buffer(buffer) {}
+        FrameBuffer(GLuint buffer) : buffer(buffer), nextReadBuffer(0) {}
+
+        void attachTexture(const Attachment & att) const;
 
     public:
         FrameBuffer(const glm::uvec2 & size);
@@ -129,6 +227,14 @@ namespace glpp {
          */
         const glm::uvec2 & getSize() const;
 
+        /**
+         * Get the GPU memory used by all attachments as recorded by the
+         * ResourceTracker.
+         *
+         * @return the attachment memory in bytes
+         */
+        std::size_t getMemoryUsage() const;
+
         /**
          * Set the size in pixels. This will also resize each
          * FrameBufferTexture under this FrameBuffer.
@@ -161,6 +267,27 @@ namespace glpp {
                   GLbitfield mask = GL_COLOR_BUFFER_BIT,
                   GLenum filter = GL_NEAREST) const;
 
+        /**
+         * Start copying pixels from the FrameBuffer into a PixelPack buffer
+         * without waiting for rendering to finish.
+         *
+         * Buffers are reused from a ring of readBufferCount buffers. A buffer
+         * that is still held by a PixelReadback is replaced instead of being
+         * overwritten.
+         *
+         * @param rect the rectangle to read as x, y, width, height
+         * @param format the pixel format like GL_RGBA or GL_DEPTH_COMPONENT
+         * @param type the pixel data type
+         * @param attachment the color attachment to read, ignored for the
+         *                   default FrameBuffer
+         *
+         * @return the handle to poll and map the pixels
+         */
+        PixelReadback readPixelsAsync(const glm::uvec4 & rect,
+                                      GLenum format = GL_RGBA,
+                                      GLenum type = GL_UNSIGNED_BYTE,
+                                      GLenum attachment = GL_COLOR_ATTACHMENT0);
+
         /**
          * Bind the FrameBuffer. All draw calls after this will be sent to the
          * FrameBuffer.
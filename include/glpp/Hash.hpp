@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+
+namespace glpp {
+    /// Offset basis of the 64 bit FNV-1a hash
+    constexpr std::uint64_t fnv1aBasis = 0xcbf29ce484222325ull;
+
+    /// Prime of the 64 bit FNV-1a hash
+    constexpr std::uint64_t fnv1aPrime = 0x100000001b3ull;
+
+    /**
+     * Hash data with 64 bit FNV-1a. Hashing data in parts, passing the
+     * previous hash as seed, gives the same hash as the whole data.
+     *
+     * @param data the bytes to hash
+     * @param seed the hash of previous data, fnv1aBasis to start
+     *
+     * @return the hash
+     */
+    constexpr std::uint64_t fnv1a(std::string_view data,
+                                  std::uint64_t seed = fnv1aBasis) {
+        for (char c : data) {
+            seed ^= static_cast<unsigned char>(c);
+            seed *= fnv1aPrime;
+        }
+        return seed;
+    }
+}
@@ -0,0 +1,142 @@
+#pragma once
+
+#include <GL/glew.h>
+// gl.h after glew.h, clang-format don't sort
+#include <GL/gl.h>
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "Buffer.hpp"
+
+namespace glpp {
+    using std::vector;
+    using std::shared_ptr;
+
+    /**
+     * Command record read by glMultiDrawArraysIndirect.
+     */
+    struct DrawArraysIndirectCommand {
+        GLuint count;
+        GLuint instanceCount;
+        GLuint first;
+        GLuint baseInstance;
+    };
+
+    /**
+     * Command record read by glMultiDrawElementsIndirect.
+     */
+    struct DrawElementsIndirectCommand {
+        GLuint count;
+        GLuint instanceCount;
+        GLuint firstIndex;
+        GLint baseVertex;
+        GLuint baseInstance;
+    };
+
+    /**
+     * A Buffer with the DrawIndirect target that accumulates draw commands
+     * for BufferArray::multiDrawArraysIndirect and
+     * BufferArray::multiDrawElementsIndirect.
+     *
+     * Commands are collected on the CPU and uploaded in one bufferData call
+     * the next time the buffer is drawn after a change. Array and element
+     * commands are stored in separate lists and are drawn by separate calls.
+     */
+    class IndirectCommandBuffer : public Buffer {
+    public:
+        using Ptr = shared_ptr<IndirectCommandBuffer>;
+        using ConstPtr = const shared_ptr<IndirectCommandBuffer>;
+
+    private:
+        vector<DrawArraysIndirectCommand> arrays;
+        vector<DrawElementsIndirectCommand> elements;
+        bool dirty;
+
+    public:
+        /**
+         * Create an empty command buffer.
+         *
+         * @param usage the usage hint used when uploading the commands
+         */
+        IndirectCommandBuffer(Usage usage = Stream);
+
+        IndirectCommandBuffer(IndirectCommandBuffer && other);
+
+        IndirectCommandBuffer & operator=(IndirectCommandBuffer && other);
+
+        IndirectCommandBuffer(const IndirectCommandBuffer &) = delete;
+        IndirectCommandBuffer & operator=(const IndirectCommandBuffer &) = delete;
+
+        virtual ~IndirectCommandBuffer();
+
+        /**
+         * Add a command for glDrawArrays style drawing.
+         *
+         * @param count the number of vertices
+         * @param first the first vertex
+         * @param instanceCount the number of instances
+         * @param baseInstance the first instance, ignored before OpenGL 4.2
+         */
+        void addArrays(GLuint count,
+                       GLuint first = 0,
+                       GLuint instanceCount = 1,
+                       GLuint baseInstance = 0);
+
+        /**
+         * Add a command for glDrawElements style drawing.
+         *
+         * @param count the number of indices
+         * @param firstIndex the first index in the element buffer
+         * @param baseVertex value added to each index
+         * @param instanceCount the number of instances
+         * @param baseInstance the first instance, ignored before OpenGL 4.2
+         */
+        void addElements(GLuint count,
+                         GLuint firstIndex = 0,
+                         GLint baseVertex = 0,
+                         GLuint instanceCount = 1,
+                         GLuint baseInstance = 0);
+
+        /**
+         * Remove all commands.
+         */
+        void clear();
+
+        /**
+         * Get the array commands.
+         *
+         * @return the array commands
+         */
+        const vector<DrawArraysIndirectCommand> & getArrayCommands() const;
+
+        /**
+         * Get the element commands.
+         *
+         * @return the element commands
+         */
+        const vector<DrawElementsIndirectCommand> & getElementCommands() const;
+
+        /**
+         * Get the offset in bytes of the first element command in the buffer.
+         * Array commands start at offset 0.
+         *
+         * @return the element command offset
+         */
+        GLintptr getElementOffset() const;
+
+        /**
+         * Upload the commands if they changed since the last upload.
+         */
+        void upload();
+
+        /**
+         * Check if glMultiDraw*Indirect is available. If it is not, the
+         * commands are drawn one at a time.
+         *
+         * @return true if OpenGL 4.3 or ARB_multi_draw_indirect is present
+         */
+        static bool isSupported();
+    };
+}
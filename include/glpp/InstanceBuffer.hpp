@@ -0,0 +1,320 @@
+#pragma once
+
+#include <GL/glew.h>
+// gl.h after glew.h, clang-format don't sort
+#include <GL/gl.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+#include "Buffer.hpp"
+
+namespace glpp {
+    using std::vector;
+    using std::shared_ptr;
+
+    /**
+     * A Buffer of per instance data with a CPU copy of every instance.
+     *
+     * Changed instances are recorded as index ranges. upload merges
+     * overlapping and nearby ranges and writes only those bytes with
+     * glBufferSubData. The whole buffer is sent when it grows or when most
+     * of it changed. The attributes should have a divisor of 1, see
+     * VertexLayout::attributes.
+     *
+     * @code
+     * using Layout = VertexLayout<Particle, &Particle::offset, &Particle::scale>;
+     * auto particles = make_shared<InstanceBuffer<Particle>>(Layout::attributes(2, 1));
+     * BufferArray array({quad, particles});
+     * particles->edit(i).offset = pos;
+     * particles->drawArrays(array, Buffer::TriangleStrip, 0, 4);
+     * @endcode
+     *
+     * @tparam T the instance struct
+     */
+    template<typename T>
+    class InstanceBuffer : public Buffer {
+        static_assert(std::is_trivially_copyable_v<T>,
+                      "Instance data must be trivially copyable");
+
+    public:
+        using Ptr = shared_ptr<InstanceBuffer>;
+        using ConstPtr = const shared_ptr<InstanceBuffer>;
+
+        /**
+         * A range of instance indices.
+         */
+        struct Range {
+            std::size_t first;
+            std::size_t count;
+        };
+
+    private:
+        vector<T> instances;
+        mutable vector<Range> dirty;
+        std::size_t mergeGap;
+        std::size_t uploadedBytes;
+        std::size_t uploadCalls;
+
+    public:
+        /**
+         * Create an empty instance buffer.
+         *
+         * @param attributes the instance attributes
+         * @param usage the usage hint
+         */
+        InstanceBuffer(const vector<Attribute> & attributes, Usage usage = Dynamic)
+            : Buffer(attributes, Array),
+              mergeGap(0),
+              uploadedBytes(0),
+              uploadCalls(0) {
+            reserve(0, usage);
+        }
+
+        InstanceBuffer(InstanceBuffer && other) = default;
+
+        InstanceBuffer & operator=(InstanceBuffer && other) = default;
+
+        InstanceBuffer(const InstanceBuffer &) = delete;
+        InstanceBuffer & operator=(const InstanceBuffer &) = delete;
+
+        /**
+         * Get the number of instances.
+         *
+         * @return the instance count
+         */
+        std::size_t size() const {
+            return instances.size();
+        }
+
+        /**
+         * Get the CPU copy of all instances.
+         *
+         * @return the instances
+         */
+        const vector<T> & getInstances() const {
+            return instances;
+        }
+
+        const T & operator[](std::size_t index) const {
+            return instances[index];
+        }
+
+        /**
+         * Get an instance for writing and mark it as changed.
+         *
+         * @param index the instance index
+         *
+         * @return the instance
+         */
+        T & edit(std::size_t index) {
+            markDirty(index, 1);
+            return instances[index];
+        }
+
+        /**
+         * Replace an instance.
+         *
+         * @param index the instance index
+         * @param value the new value
+         */
+        void set(std::size_t index, const T & value) {
+            edit(index) = value;
+        }
+
+        /**
+         * Add an instance to the end.
+         *
+         * @param value the new instance
+         */
+        void push_back(const T & value) {
+            instances.push_back(value);
+            markDirty(instances.size() - 1, 1);
+        }
+
+        /**
+         * Replace all instances.
+         *
+         * @param values the new instances
+         */
+        void assign(const vector<T> & values) {
+            instances = values;
+            dirty.clear();
+            markDirty(0, instances.size());
+        }
+
+        /**
+         * Change the number of instances. New instances are value
+         * initialized.
+         *
+         * @param count the new instance count
+         */
+        void resize(std::size_t count) {
+            std::size_t old = instances.size();
+            instances.resize(count);
+            if (count > old)
+                markDirty(old, count - old);
+        }
+
+        /**
+         * Remove all instances.
+         */
+        void clear() {
+            instances.clear();
+            dirty.clear();
+        }
+
+        /**
+         * Mark a range of instances as changed, after writing them through a
+         * pointer or reference that was not obtained from edit.
+         *
+         * @param first the first instance
+         * @param count the number of instances
+         */
+        void markDirty(std::size_t first, std::size_t count) {
+            if (count == 0)
+                return;
+            // Sequential edits extend the last range instead of adding one
+            if (!dirty.empty()) {
+                Range & last = dirty.back();
+                if (first >= last.first && first <= last.first + last.count) {
+                    last.count = std::max(last.count, first + count - last.first);
+                    return;
+                }
+            }
+            dirty.push_back({first, count});
+        }
+
+        /**
+         * Set how many unchanged instances may lie between two changed
+         * ranges for them to be uploaded as one range. Larger values upload
+         * more bytes with fewer calls.
+         *
+         * @param count the largest gap in instances, default 0
+         */
+        void setMergeGap(std::size_t count) {
+            mergeGap = count;
+        }
+
+        /**
+         * Get the changed ranges sorted and merged as they will be uploaded.
+         *
+         * @return the merged ranges
+         */
+        const vector<Range> & getDirtyRanges() const {
+            std::sort(dirty.begin(), dirty.end(),
+                      [](const Range & a, const Range & b) {
+                          return a.first < b.first;
+                      });
+
+            std::size_t merged = 0;
+            for (std::size_t i = 1; i < dirty.size(); i++) {
+                Range & last = dirty[merged];
+                std::size_t end = last.first + last.count;
+                if (dirty[i].first <= end + mergeGap) {
+                    std::size_t newEnd =
+                        std::max(end, dirty[i].first + dirty[i].count);
+                    last.count = newEnd - last.first;
+                }
+                else {
+                    dirty[++merged] = dirty[i];
+                }
+            }
+            if (!dirty.empty())
+                dirty.resize(merged + 1);
+            return dirty;
+        }
+
+        /**
+         * Send the changed instances to the buffer. Does nothing if no
+         * instance changed since the last upload.
+         */
+        void upload() {
+            if (dirty.empty())
+                return;
+
+            const GLsizeiptr total = instances.size() * sizeof(T);
+            auto & ranges = getDirtyRanges();
+
+            std::size_t changed = 0;
+            for (auto & r : ranges) {
+                changed += r.count;
+            }
+
+            uploadedBytes = 0;
+            uploadCalls = 0;
+            if (total > getCapacity() || changed * 2 > instances.size()) {
+                // Grown or mostly changed, one call that can orphan the old
+                // storage is cheaper than many partial writes
+                bufferData(total, instances.data(), getUsage());
+                uploadedBytes = total;
+                uploadCalls = 1;
+            }
+            else {
+                for (auto & r : ranges) {
+                    std::size_t count =
+                        std::min(r.count, instances.size() - std::min(r.first, instances.size()));
+                    if (count == 0)
+                        continue;
+                    bufferSubData(r.first * sizeof(T), count * sizeof(T),
+                                  &instances[r.first]);
+                    uploadedBytes += count * sizeof(T);
+                    uploadCalls++;
+                }
+            }
+            dirty.clear();
+        }
+
+        /**
+         * Get the number of bytes sent by the last upload that changed
+         * anything.
+         *
+         * @return the uploaded bytes
+         */
+        std::size_t getUploadedBytes() const {
+            return uploadedBytes;
+        }
+
+        /**
+         * Get the number of buffer writes made by the last upload that
+         * changed anything.
+         *
+         * @return the number of bufferData and bufferSubData calls
+         */
+        std::size_t getUploadCalls() const {
+            return uploadCalls;
+        }
+
+        /**
+         * Upload changes then draw every instance with
+         * BufferArray::drawArraysInstanced.
+         *
+         * @param array the array this buffer is attached to
+         * @param mode the draw mode
+         * @param first the first vertex
+         * @param count the number of vertices
+         */
+        void drawArrays(const BufferArray & array,
+                        Mode mode,
+                        GLint first,
+                        GLsizei count) {
+            upload();
+            array.drawArraysInstanced(mode, first, count, instances.size());
+        }
+
+        /**
+         * Upload changes then draw every instance with
+         * BufferArray::drawElementsInstanced.
+         *
+         * @param array the array this buffer is attached to
+         * @param mode the draw mode
+         */
+        void drawElements(const BufferArray & array, Mode mode) {
+            upload();
+            array.drawElementsInstanced(mode, instances.size());
+        }
+    };
+}
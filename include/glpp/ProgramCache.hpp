@@ -0,0 +1,182 @@
+#pragma once
+
+#include <GL/glew.h>
+// gl.h after glew.h, clang-format don't sort
+#include <GL/gl.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Hash.hpp"
+
+namespace glpp {
+    using std::shared_ptr;
+    using std::string;
+    using std::string_view;
+    using std::vector;
+
+    /**
+     * Stores linked shader programs on disk with glGetProgramBinary and loads
+     * them with glProgramBinary, skipping compile and link on later runs.
+     *
+     * Programs are identified by a 64 bit FNV-1a hash of their sources,
+     * transform feedback varyings and the GL_VENDOR, GL_RENDERER and
+     * GL_VERSION strings, so a driver update creates new entries. Each entry
+     * is one file named by the hash in the cache directory.
+     *
+     * A missing, corrupt or rejected binary is treated as a miss and the
+     * program is compiled from source, then stored again. Write errors are
+     * ignored, the cache never prevents a Shader from being created.
+     *
+     * Shader uses the cache set with setDefault. There is no default cache,
+     * so programs are always compiled until one is set.
+     *
+     * Requires OpenGL 4.1 or ARB_get_program_binary and at least one binary
+     * format, see isSupported.
+     */
+    class ProgramCache {
+    public:
+        using Ptr = shared_ptr<ProgramCache>;
+        using ConstPtr = const shared_ptr<ProgramCache>;
+
+        /**
+         * Number of programs loaded, compiled and binaries rejected.
+         */
+        struct Counters {
+            std::size_t hits = 0;
+            std::size_t misses = 0;
+            std::size_t rejected = 0;
+        };
+
+    private:
+        std::filesystem::path directory;
+        mutable std::mutex mutex;
+        Counters counters;
+
+    public:
+        /// Offset basis of the 64 bit FNV-1a hash
+        static constexpr std::uint64_t hashBasis = fnv1aBasis;
+
+        /**
+         * Create a cache that stores binaries in directory. The directory is
+         * created if it does not exist.
+         *
+         * @param directory the cache directory
+         *
+         * @throws std::filesystem::filesystem_error if directory can not be
+         *         created
+         */
+        ProgramCache(const std::filesystem::path & directory);
+
+        ProgramCache(const ProgramCache &) = delete;
+        ProgramCache & operator=(const ProgramCache &) = delete;
+
+        /**
+         * Get the cache directory.
+         *
+         * @return the directory path
+         */
+        const std::filesystem::path & getDirectory() const;
+
+        /**
+         * Get the key of a program for the driver of the current context.
+         *
+         * @param sources the source of each shader stage, in stage order
+         * @param varyings the transform feedback varyings, may be empty
+         * @param bufferMode the transform feedback buffer mode
+         *
+         * @return the program key
+         */
+        std::uint64_t key(const vector<string_view> & sources,
+                          const vector<string> & varyings = {},
+                          GLenum bufferMode = GL_INTERLEAVED_ATTRIBS) const;
+
+        /**
+         * Get the path of the file storing the program for key.
+         *
+         * @param key the program key
+         *
+         * @return the file path
+         */
+        std::filesystem::path pathOf(std::uint64_t key) const;
+
+        /**
+         * Create a program from the stored binary for key. The file is
+         * removed if the binary is corrupt or the driver rejects it.
+         *
+         * @param key the program key
+         *
+         * @return the linked program, or 0 if there is no usable binary
+         */
+        GLuint load(std::uint64_t key);
+
+        /**
+         * Store the binary of program for key. The program should be linked
+         * with GL_PROGRAM_BINARY_RETRIEVABLE_HINT set.
+         *
+         * @param key the program key
+         * @param program the linked program
+         *
+         * @return false if the binary could not be retrieved or written
+         */
+        bool store(std::uint64_t key, GLuint program);
+
+        /**
+         * Remove all stored binaries.
+         */
+        void clear();
+
+        /**
+         * Get the hit, miss and rejected counts of load.
+         *
+         * @return the counters
+         */
+        Counters getCounters() const;
+
+        /**
+         * Set all counters to 0.
+         */
+        void resetCounters();
+
+        /**
+         * Hash data with 64 bit FNV-1a.
+         *
+         * @param data the bytes to hash
+         * @param seed the hash of previous data, hashBasis to start
+         *
+         * @return the hash
+         */
+        static constexpr std::uint64_t hash(string_view data,
+                                            std::uint64_t seed = hashBasis) {
+            return fnv1a(data, seed);
+        }
+
+        /**
+         * Check if the current context can store program binaries.
+         *
+         * @return true if OpenGL 4.1 or ARB_get_program_binary is available
+         *         with at least one binary format
+         */
+        static bool isSupported();
+
+        /**
+         * Get the cache used by Shader.
+         *
+         * @return the cache, or nullptr if caching is disabled
+         */
+        static Ptr getDefault();
+
+        /**
+         * Set the cache used by Shader.
+         *
+         * @param cache the cache, or nullptr to disable caching
+         */
+        static void setDefault(const Ptr & cache);
+    };
+}
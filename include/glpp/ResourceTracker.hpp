@@ -0,0 +1,202 @@
+#pragma once
+
+#include <GL/glew.h>
+// gl.h after glew.h, clang-format don't sort
+#include <GL/gl.h>
+
+#include <array>
+#include <cstddef>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <utility>
+#include <vector>
+
+namespace glpp {
+    using std::vector;
+
+    /**
+     * Records the GPU memory allocated by glpp objects.
+     *
+     * Buffer, Texture and RenderBuffer report their storage each time it is
+     * allocated and remove it when they are destroyed. Sizes are computed
+     * from the requested storage, drivers may allocate more for alignment or
+     * padding.
+     *
+     * The tracker is shared by all threads and locks a mutex on each call.
+     * Objects are identified by their kind and OpenGL id.
+     */
+    class ResourceTracker {
+    public:
+        /**
+         * The kinds of object that own GPU memory.
+         */
+        enum Kind {
+            BufferMemory,
+            TextureMemory,
+            RenderBufferMemory,
+            KindCount,
+        };
+
+        /**
+         * The storage of a single object.
+         */
+        struct Record {
+            Kind kind;
+            GLuint id;
+            /// Buffer or texture target, GL_RENDERBUFFER for render buffers
+            GLenum target;
+            /// Buffer usage, 0 for immutable buffer storage and images
+            GLenum usage;
+            /// Internal format of images, 0 for buffers
+            GLenum format;
+            GLsizei width;
+            GLsizei height;
+            GLsizei samples;
+            GLsizei levels;
+            std::size_t bytes;
+        };
+
+        /**
+         * Current and highest total bytes.
+         */
+        struct Totals {
+            std::size_t current = 0;
+            std::size_t peak = 0;
+        };
+
+    private:
+        mutable std::mutex mutex;
+        std::map<std::pair<Kind, GLuint>, Record> records;
+        std::array<Totals, KindCount> kindTotals;
+        Totals totals;
+
+        void add(Kind kind, std::size_t bytes);
+
+        void remove(Kind kind, std::size_t bytes);
+
+    public:
+        ResourceTracker() = default;
+
+        ResourceTracker(const ResourceTracker &) = delete;
+        ResourceTracker & operator=(const ResourceTracker &) = delete;
+
+        /**
+         * Add the storage of an object, replacing the previous record of the
+         * same object.
+         *
+         * @param record the object storage
+         */
+        void track(const Record & record);
+
+        /**
+         * Remove the storage of an object. Does nothing if the object is not
+         * tracked.
+         *
+         * @param kind the kind of object
+         * @param id the OpenGL id
+         */
+        void untrack(Kind kind, GLuint id);
+
+        /**
+         * Get the total bytes of all objects.
+         *
+         * @return the current and peak totals
+         */
+        Totals getTotals() const;
+
+        /**
+         * Get the total bytes of one kind of object.
+         *
+         * @param kind the kind of object
+         *
+         * @return the current and peak totals
+         */
+        Totals getTotals(Kind kind) const;
+
+        /**
+         * Get the current bytes of one object.
+         *
+         * @param kind the kind of object
+         * @param id the OpenGL id
+         *
+         * @return the bytes, or 0 if the object is not tracked
+         */
+        std::size_t getBytes(Kind kind, GLuint id) const;
+
+        /**
+         * Get the current buffer bytes for each Buffer::Target.
+         *
+         * @return bytes by target
+         */
+        std::map<GLenum, std::size_t> getBytesByTarget() const;
+
+        /**
+         * Get the current buffer bytes for each Buffer::Usage. Immutable
+         * storage is listed under 0.
+         *
+         * @return bytes by usage
+         */
+        std::map<GLenum, std::size_t> getBytesByUsage() const;
+
+        /**
+         * Get the current texture and render buffer bytes for each internal
+         * format.
+         *
+         * @return bytes by internal format
+         */
+        std::map<GLenum, std::size_t> getBytesByFormat() const;
+
+        /**
+         * Get a copy of all records.
+         *
+         * @return the records ordered by kind and id
+         */
+        vector<Record> getRecords() const;
+
+        /**
+         * Write one line for each object followed by the totals.
+         *
+         * @param os the output stream
+         */
+        void dump(std::ostream & os) const;
+
+        /**
+         * Set the peak totals to the current totals.
+         */
+        void resetPeak();
+
+        /**
+         * Get the size in bytes of one pixel of an internal format.
+         *
+         * @param format the internal format
+         *
+         * @return the pixel size, or 4 for unknown formats
+         */
+        static std::size_t pixelSize(GLenum format);
+
+        /**
+         * Get the size in bytes of an image with a mip chain.
+         *
+         * @param format the internal format
+         * @param width the width of level 0
+         * @param height the height of level 0
+         * @param levels the number of mipmap levels
+         * @param samples the number of samples, 0 without multisampling
+         *
+         * @return the image size
+         */
+        static std::size_t imageSize(GLenum format,
+                                     GLsizei width,
+                                     GLsizei height,
+                                     GLsizei levels = 1,
+                                     GLsizei samples = 0);
+
+        /**
+         * Get the tracker used by all glpp objects.
+         *
+         * @return the global tracker
+         */
+        static ResourceTracker & getDefault();
+    };
+}
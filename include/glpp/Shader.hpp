@@ -4,11 +4,17 @@
 // gl.h after glew.h, clang-format don't sort
 #include <GL/gl.h>
 
+#include <cstddef>
+#include <cstdint>
 #include <glm/glm.hpp>
 #include <memory>
 #include <stdexcept>
 #include <string>
 #include <string_view>
+#include <vector>
+
+#include "Buffer.hpp"
+#include "Hash.hpp"
 
 // https://www.khronos.org/opengl/wiki/Shader_Compilation
 
@@ -16,6 +22,7 @@ namespace glpp {
     using std::string;
     using std::string_view;
     using std::shared_ptr;
+    using std::vector;
 
     class ShaderCompileException : public std::runtime_error {
     public:
@@ -27,6 +34,37 @@ namespace glpp {
         ShaderLinkException(GLuint program);
     };
 
+    class ShaderLayoutException : public std::runtime_error {
+    public:
+        using std::runtime_error::runtime_error;
+    };
+
+    /**
+     * An active vertex input or uniform of a Shader.
+     */
+    struct ShaderVariable {
+        string name;
+        /// OpenGL type, like GL_FLOAT_VEC3
+        GLenum type;
+        /// Number of array elements, 1 if not an array
+        GLint size;
+        /// Input or uniform location, -1 for built-ins and block members
+        GLint location;
+    };
+
+    /**
+     * An active uniform block or shader storage block of a Shader.
+     */
+    struct ShaderBlock {
+        string name;
+        /// Index of the block in the program
+        GLuint index;
+        /// Binding index, see Shader::bindUniformBlock
+        GLint binding;
+        /// Minimum size in bytes of the bound buffer range
+        GLint size;
+    };
+
     /**
      * Open a source file at path and read it's content.
      *
@@ -36,10 +74,88 @@ namespace glpp {
      */
     string shaderSource(const string & path);
 
+    /**
+     * Hash of a uniform name, see Shader::uniform(UniformHash).
+     */
+    using UniformHash = std::uint64_t;
+
+    /**
+     * Hash a uniform name with 64 bit FNV-1a.
+     *
+     * @param name the uniform name
+     *
+     * @return the name hash
+     */
+    constexpr UniformHash uniformHash(string_view name) {
+        return fnv1a(name);
+    }
+
+    inline namespace literals {
+        /**
+         * Hash a uniform name at compile time.
+         *
+         * @code
+         * auto model = shader.uniform<"model"_h>();
+         * @endcode
+         */
+        constexpr UniformHash operator""_h(const char * name, std::size_t size) {
+            return uniformHash(string_view(name, size));
+        }
+    }
+
+    /**
+     * A uniform location in the currently bound shader.
+     *
+     * Uniforms from Shader::uniform share a copy of their last value with the
+     * Shader. Setters compare against it and only call OpenGL when the value
+     * changed. The copy is reference counted, so a Uniform stays valid when
+     * its Shader is moved, move assigned or destroyed.
+     */
     class Uniform {
+    public:
+        /**
+         * Last value set on a uniform, large enough for a mat4.
+         */
+        struct Value {
+            bool valid = false;
+            alignas(16) unsigned char data[64];
+        };
+
+        /**
+         * Number of set calls sent to OpenGL and number of calls skipped
+         * because the value did not change.
+         */
+        struct Counters {
+            std::size_t issued = 0;
+            std::size_t skipped = 0;
+        };
+
+    private:
         GLuint location;
+        /// Points into the shadow of the Shader and keeps it alive
+        shared_ptr<Value> value;
+        /// Owned by the same shadow as value
+        Counters * counters;
+
+        friend class Shader;
+
+        Uniform(GLuint location, shared_ptr<Value> value, Counters * counters);
+
+        /**
+         * Compare newValue to the last value and store it.
+         *
+         * @return true if the value changed and should be sent to OpenGL
+         */
+        template<typename T>
+        bool update(const T & newValue) const;
 
     public:
+        /**
+         * Create a Uniform for location that is not shadowed, every set is
+         * sent to OpenGL.
+         *
+         * @param location the uniform location
+         */
         Uniform(GLuint location = 0);
 
         GLuint getLocation() const;
@@ -132,7 +248,29 @@ namespace glpp {
         using ConstPtr = const shared_ptr<Shader>;
 
     private:
+        struct UniformSlot {
+            UniformHash hash;
+            GLint location;
+            /// Index in UniformShadow::values
+            std::size_t value;
+        };
+
+        /// Shared with the Uniforms so they stay valid when the Shader is moved
+        struct UniformShadow {
+            vector<Uniform::Value> values;
+            Uniform::Counters counters;
+        };
+
         GLuint program;
+        /// Open addressing table of active uniform locations by name hash
+        vector<UniformSlot> uniforms;
+        shared_ptr<UniformShadow> shadow;
+
+        friend class ShaderBuilder;
+
+        explicit Shader(GLuint program);
+
+        void loadUniforms();
 
     public:
         /**
@@ -146,6 +284,24 @@ namespace glpp {
         Shader(const string_view & vertexSource,
                const string_view & fragmentSource);
 
+        /**
+         * Create a new Shader with program from vertex and fragment source
+         * that captures varyings with transform feedback.
+         *
+         * @param vertexSource the vertex shader source
+         * @param fragmentSource the fragment shader source
+         * @param varyings the names of the vertex shader outputs to capture
+         * @param bufferMode GL_INTERLEAVED_ATTRIBS to write all varyings to
+         *                   one buffer or GL_SEPARATE_ATTRIBS to write each
+         *                   varying to the buffer at the same index
+         *
+         * @pre vertexSource and fragmentSource must be null terminated.
+         */
+        Shader(const string_view & vertexSource,
+               const string_view & fragmentSource,
+               const vector<string> & varyings,
+               GLenum bufferMode = GL_INTERLEAVED_ATTRIBS);
+
         Shader(Shader && other);
 
         Shader & operator=(Shader && other);
@@ -176,12 +332,161 @@ namespace glpp {
         /**
          * Get the uniform for name in this shader.
          *
+         * Active uniforms are listed once after linking, this does not query
+         * OpenGL. Array uniforms can be found by the array name, the name of
+         * the first element or the name of any element.
+         *
          * @param name the uniform name
          *
-         * @return the uniform
+         * @return the uniform, which does not exist if name is not active
          */
         Uniform uniform(const char * name) const;
 
+        /**
+         * Get the uniform for a name hash from uniformHash or operator""_h.
+         *
+         * @param hash the uniform name hash
+         *
+         * @return the uniform, which does not exist if name is not active
+         */
+        Uniform uniform(UniformHash hash) const;
+
+        /**
+         * Get the uniform for a name hash known at compile time.
+         *
+         * @code
+         * shader.uniform<"model"_h>().setMat4(transform);
+         * @endcode
+         *
+         * @tparam Hash the uniform name hash
+         *
+         * @return the uniform, which does not exist if name is not active
+         */
+        template<UniformHash Hash>
+        Uniform uniform() const {
+            return uniform(Hash);
+        }
+
+        /**
+         * Get the issued and skipped counts of Uniform setters for this
+         * shader.
+         *
+         * @return the counters
+         */
+        const Uniform::Counters & getUniformCounters() const;
+
+        /**
+         * Set the uniform counters to 0.
+         */
+        void resetUniformCounters();
+
+        /**
+         * Forget the last value of all uniforms so the next set of each is
+         * sent to OpenGL. Call this after setting uniforms of this shader
+         * with raw OpenGL calls.
+         */
+        void invalidateUniforms();
+
+        /**
+         * Connect the uniform block name to a binding index, where a
+         * UniformBlock is bound with Buffer::bindBase.
+         *
+         * @param name the uniform block name
+         * @param binding the binding index
+         *
+         * @return false if the block does not exist in this shader
+         */
+        bool bindUniformBlock(const char * name, GLuint binding) const;
+
+        /**
+         * Connect the shader storage block name to a binding index, where a
+         * StorageBlock is bound with Buffer::bindBase. Requires OpenGL 4.3 or
+         * ARB_shader_storage_buffer_object.
+         *
+         * @param name the shader storage block name
+         * @param binding the binding index
+         *
+         * @return false if the block does not exist in this shader or shader
+         *         storage blocks are not supported
+         */
+        bool bindStorageBlock(const char * name, GLuint binding) const;
+
+        /**
+         * Get the active vertex inputs.
+         *
+         * @return the inputs ordered by location
+         */
+        vector<ShaderVariable> getAttributes() const;
+
+        /**
+         * Get the active uniforms, including members of uniform blocks.
+         * Arrays are listed once with the name of the first element.
+         *
+         * @return the uniforms
+         */
+        vector<ShaderVariable> getUniforms() const;
+
+        /**
+         * Get the active uniform blocks.
+         *
+         * @return the uniform blocks
+         */
+        vector<ShaderBlock> getUniformBlocks() const;
+
+        /**
+         * Get the active shader storage blocks. Requires OpenGL 4.3 or
+         * ARB_program_interface_query.
+         *
+         * @return the storage blocks, empty if they can not be queried
+         */
+        vector<ShaderBlock> getStorageBlocks() const;
+
+        /**
+         * Check vertex attributes against the active vertex inputs. Each
+         * location used by an input needs an attribute. Integer inputs need
+         * integer attributes and float inputs can not read integer
+         * attributes. Double inputs are reported because
+         * Buffer::Attribute::enable does not use glVertexAttribLPointer.
+         * Attributes not used by the shader are allowed.
+         *
+         * Layouts that are valid but often a mistake are only reported as
+         * warnings: a component count different from the input, where
+         * OpenGL fills missing components from (0, 0, 0, 1) and ignores
+         * extra ones, and unnormalized integers read by a float input.
+         *
+         * Call this when setting up a BufferArray, not before each draw.
+         *
+         * @param attributes the attributes that will be enabled
+         * @param warnings receives a description of each warning, may be
+         *                 nullptr
+         *
+         * @return a description of each problem, empty if the layout matches
+         */
+        vector<string> checkLayout(const vector<Buffer::Attribute> & attributes,
+                                   vector<string> * warnings = nullptr) const;
+
+        /**
+         * Check vertex attributes against the active vertex inputs, see
+         * checkLayout. Warnings are ignored.
+         *
+         * @param attributes the attributes that will be enabled
+         *
+         * @throws ShaderLayoutException listing all problems
+         */
+        void validateLayout(const vector<Buffer::Attribute> & attributes) const;
+
+        /**
+         * Check the attributes of all buffers in array against the active
+         * vertex inputs, see checkLayout. Buffers added with
+         * BufferArray::attach are not included, validate their attributes
+         * directly.
+         *
+         * @param array the array to check
+         *
+         * @throws ShaderLayoutException listing all problems
+         */
+        void validateLayout(const BufferArray & array) const;
+
         /**
          * Load the default shader from the internal source.
          *
@@ -192,8 +497,8 @@ namespace glpp {
          * OpenGL context.
          *
          * Uniforms:
-         * - mvp: mat4
          * - model: mat4
+         * - Frame: FrameUniforms block, see extra::Camera::bindFrame
          *
          * @return the default shader
          */
@@ -205,8 +510,8 @@ namespace glpp {
          * This shader takes a Vertex from VBO.hpp,
          *
          * Uniforms:
-         * - mvp: mat4
          * - model: mat4
+         * - Frame: FrameUniforms block, see extra::Camera::bindFrame
          *
          * Out to fragment shader:
          * - FragPos: vec3
@@ -221,6 +526,23 @@ namespace glpp {
          */
         static Shader fromFragmentSource(const string_view & source);
 
+        /**
+         * Load a vertex only shader that captures varyings with transform
+         * feedback. Used to update vertex data on the GPU with
+         * GL_RASTERIZER_DISCARD enabled.
+         *
+         * @param source the vertex shader source
+         * @param varyings the names of the vertex shader outputs to capture
+         * @param bufferMode GL_INTERLEAVED_ATTRIBS or GL_SEPARATE_ATTRIBS
+         *
+         * @pre source must be null terminated.
+         *
+         * @return the shader
+         */
+        static Shader fromVertexSource(const string_view & source,
+                                       const vector<string> & varyings,
+                                       GLenum bufferMode = GL_INTERLEAVED_ATTRIBS);
+
         /**
          * Load a shader using a vertex and fragment shader path.
          *
@@ -238,8 +560,8 @@ namespace glpp {
          * This shader takes a Vertex from VBO.hpp,
          *
          * Uniforms:
-         * - mvp: mat4
          * - model: mat4
+         * - Frame: FrameUniforms block, see extra::Camera::bindFrame
          *
          * Out to fragment shader:
          * - FragPos: vec3
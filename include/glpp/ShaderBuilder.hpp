@@ -0,0 +1,234 @@
+#pragma once
+
+#include <GL/glew.h>
+// gl.h after glew.h, clang-format don't sort
+#include <GL/gl.h>
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Shader.hpp"
+
+namespace glpp {
+    using std::shared_ptr;
+    using std::string;
+    using std::string_view;
+    using std::vector;
+
+    /**
+     * Compiles and links many shader programs without waiting for each one.
+     *
+     * The Shader constructors check the compile and link status right away,
+     * which blocks until the driver is done. ShaderBuilder submits the
+     * compile and link calls and only checks the status when the Shader is
+     * requested with Handle::get, so drivers can compile in the background
+     * and in parallel.
+     *
+     * With KHR_parallel_shader_compile or ARB_parallel_shader_compile, the
+     * driver is asked to use as many compiler threads as it likes and
+     * Handle::ready polls GL_COMPLETION_STATUS_KHR without blocking.
+     * Without it, ready always returns true and get blocks until the program
+     * is linked.
+     *
+     * Programs are loaded from and stored in the default ProgramCache, like
+     * Shader. All calls must be made with the same context current.
+     *
+     * @code
+     * ShaderBuilder builder;
+     * auto sky = builder.add(skyVertex, skyFragment);
+     * auto mesh = builder.add(meshVertex, meshFragment);
+     * extra::Line::warmShader(builder);
+     * // ... load other resources
+     * Shader & skyShader = sky.get();
+     * @endcode
+     */
+    class ShaderBuilder {
+    public:
+        using Ptr = shared_ptr<ShaderBuilder>;
+        using ConstPtr = const shared_ptr<ShaderBuilder>;
+
+        /**
+         * A program submitted to a ShaderBuilder. Copies share the same
+         * program.
+         */
+        class Handle {
+            struct State;
+            shared_ptr<State> state;
+
+            friend class ShaderBuilder;
+
+        public:
+            /**
+             * Create a Handle without a program.
+             */
+            Handle() = default;
+
+            /**
+             * Check if this handle has a program.
+             *
+             * @return true if returned by a ShaderBuilder
+             */
+            explicit operator bool() const;
+
+            /**
+             * Check if get will return without waiting for the driver.
+             *
+             * @return true if the program is done compiling and linking, or
+             *         if the driver can not report it, false for a Handle
+             *         without a program
+             */
+            bool ready() const;
+
+            /**
+             * Wait for the program and get the Shader. The first call checks
+             * the compile and link status, later calls return the same
+             * Shader or throw the same exception.
+             *
+             * @throws ShaderCompileException if a stage failed to compile
+             * @throws ShaderLinkException if the program failed to link
+             *
+             * @return the linked shader, owned by the handle
+             */
+            Shader & get();
+        };
+
+    private:
+        vector<Handle> handles;
+
+        static Shader * createShader(GLuint program);
+
+        Handle submit(const vector<string_view> & sources,
+                      const vector<string> & varyings,
+                      GLenum bufferMode);
+
+    public:
+        /**
+         * Create a builder. Enables parallel compile threads if the driver
+         * supports it.
+         */
+        ShaderBuilder();
+
+        ShaderBuilder(const ShaderBuilder &) = delete;
+        ShaderBuilder & operator=(const ShaderBuilder &) = delete;
+
+        /**
+         * Submit a program from vertex and fragment source.
+         *
+         * @param vertexSource the vertex shader source
+         * @param fragmentSource the fragment shader source
+         * @param varyings the names of the vertex shader outputs to capture
+         *                 with transform feedback, may be empty
+         * @param bufferMode GL_INTERLEAVED_ATTRIBS or GL_SEPARATE_ATTRIBS
+         *
+         * @pre vertexSource and fragmentSource must be null terminated.
+         *
+         * @return the handle of the program
+         */
+        Handle add(const string_view & vertexSource,
+                   const string_view & fragmentSource,
+                   const vector<string> & varyings = {},
+                   GLenum bufferMode = GL_INTERLEAVED_ATTRIBS);
+
+        /**
+         * Submit a vertex only program that captures varyings with transform
+         * feedback, see Shader::fromVertexSource.
+         *
+         * @param source the vertex shader source
+         * @param varyings the names of the vertex shader outputs to capture
+         * @param bufferMode GL_INTERLEAVED_ATTRIBS or GL_SEPARATE_ATTRIBS
+         *
+         * @pre source must be null terminated.
+         *
+         * @return the handle of the program
+         */
+        Handle addVertex(const string_view & source,
+                         const vector<string> & varyings,
+                         GLenum bufferMode = GL_INTERLEAVED_ATTRIBS);
+
+        /**
+         * Get the number of submitted programs that are not ready.
+         *
+         * @return the number of programs still compiling
+         */
+        std::size_t getPending() const;
+
+        /**
+         * Wait for all submitted programs and check their status.
+         *
+         * @throws ShaderCompileException if a stage failed to compile
+         * @throws ShaderLinkException if a program failed to link
+         */
+        void finish();
+
+        /**
+         * Check if the current context can report completion without
+         * blocking.
+         *
+         * @return true if KHR_parallel_shader_compile or
+         *         ARB_parallel_shader_compile is available
+         */
+        static bool hasParallelCompile();
+    };
+
+    /**
+     * A Shader created on first use that can be submitted to a ShaderBuilder
+     * ahead of time, used for the built-in shaders of the extra classes.
+     *
+     * @code
+     * static WarmShader lineShader(vertexSource, fragmentSource);
+     * void Line::warmShader(ShaderBuilder & builder) {
+     *     lineShader.warm(builder);
+     * }
+     * Shader & Line::shader() {
+     *     return lineShader.get();
+     * }
+     * @endcode
+     */
+    class WarmShader {
+        string_view vertexSource;
+        string_view fragmentSource;
+        std::function<void(Shader &)> setup;
+        ShaderBuilder::Handle pending;
+        std::unique_ptr<Shader> shader;
+
+    public:
+        /**
+         * Create the holder without compiling anything.
+         *
+         * @param vertexSource the vertex shader source
+         * @param fragmentSource the fragment shader source
+         * @param setup called once with the new Shader, may be empty
+         *
+         * @pre vertexSource and fragmentSource must be null terminated and
+         *      outlive the holder.
+         */
+        WarmShader(const string_view & vertexSource,
+                   const string_view & fragmentSource,
+                   std::function<void(Shader &)> setup = nullptr);
+
+        WarmShader(const WarmShader &) = delete;
+        WarmShader & operator=(const WarmShader &) = delete;
+
+        /**
+         * Submit the program to builder. Does nothing if it was already
+         * submitted or the Shader was created.
+         *
+         * @param builder the builder to compile with
+         */
+        void warm(ShaderBuilder & builder);
+
+        /**
+         * Get the Shader. The first call takes the program submitted by warm,
+         * or compiles it now if warm was not called.
+         *
+         * @throws ShaderCompileException if a stage failed to compile
+         * @throws ShaderLinkException if the program failed to link
+         *
+         * @return the shader, owned by the holder
+         */
+        Shader & get();
+    };
+}
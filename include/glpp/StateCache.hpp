@@ -0,0 +1,244 @@
+#pragma once
+
+#include <GL/glew.h>
+// gl.h after glew.h, clang-format don't sort
+#include <GL/gl.h>
+
+#include <array>
+#include <cstddef>
+#include <unordered_map>
+#include <vector>
+
+namespace glpp {
+    using std::vector;
+
+    /**
+     * Shadow copy of the OpenGL binding state used to skip redundant binds.
+     *
+     * All binds in glpp go through the StateCache of the current thread. A
+     * bind is only sent to OpenGL when the cached binding differs from the
+     * requested one. Counters of issued and skipped calls are kept for each
+     * kind of binding.
+     *
+     * There is one StateCache per thread, matching the OpenGL context that is
+     * current on that thread. Call invalidate after making a different
+     * context current, or after binding objects with raw OpenGL calls, so the
+     * next bind of each kind is always sent.
+     *
+     * The cache also selects between direct state access and bind-to-edit
+     * for objects created on this thread.
+     */
+    class StateCache {
+    public:
+        /**
+         * The kinds of binding tracked by the cache.
+         */
+        enum Kind {
+            BufferBind,
+            VertexArrayBind,
+            ProgramBind,
+            ActiveTextureBind,
+            TextureBind,
+            FrameBufferBind,
+            RenderBufferBind,
+            TransformFeedbackBind,
+            KindCount,
+        };
+
+        /**
+         * Number of calls sent to OpenGL and number of calls skipped.
+         */
+        struct Counters {
+            std::size_t issued = 0;
+            std::size_t skipped = 0;
+        };
+
+    private:
+        std::unordered_map<GLenum, GLuint> buffers;
+        GLuint vertexArray;
+        GLuint program;
+        GLuint activeUnit;
+        vector<std::unordered_map<GLenum, GLuint>> textures;
+        GLuint drawFrameBuffer;
+        GLuint readFrameBuffer;
+        GLuint renderBuffer;
+        GLuint transformFeedback;
+        std::array<Counters, KindCount> counters;
+        bool directStateAccess;
+
+        bool update(Kind kind, GLuint & cached, GLuint value);
+
+    public:
+        /**
+         * Create a cache with all bindings unknown.
+         */
+        StateCache();
+
+        StateCache(const StateCache &) = delete;
+        StateCache & operator=(const StateCache &) = delete;
+
+        /**
+         * Forget all cached bindings. The next bind of each kind will be sent
+         * to OpenGL. Counters are not reset.
+         *
+         * Direct state access is enabled again if the current context
+         * supports it.
+         */
+        void invalidate();
+
+        /**
+         * Check if objects are created and edited with direct state access
+         * instead of binding them first.
+         *
+         * @return true if OpenGL 4.5 or ARB_direct_state_access is used
+         */
+        bool hasDirectStateAccess() const;
+
+        /**
+         * Enable or disable direct state access. It can only be enabled if
+         * the current context supports it. Objects must be used with the same
+         * setting they were created with.
+         *
+         * @param enabled true to use direct state access when available
+         */
+        void setDirectStateAccess(bool enabled);
+
+        /**
+         * Bind buffer to target with glBindBuffer.
+         *
+         * @param target the buffer target
+         * @param buffer the buffer id
+         */
+        void bindBuffer(GLenum target, GLuint buffer);
+
+        /**
+         * Bind a vertex array with glBindVertexArray. This also forgets the
+         * cached element array buffer, which is part of vertex array state.
+         *
+         * @param array the vertex array id
+         */
+        void bindVertexArray(GLuint array);
+
+        /**
+         * Bind a shader program with glUseProgram.
+         *
+         * @param program the program id
+         */
+        void useProgram(GLuint program);
+
+        /**
+         * Select the active texture unit with glActiveTexture.
+         *
+         * @param unit the texture unit index, not including GL_TEXTURE0
+         */
+        void activeTexture(GLuint unit);
+
+        /**
+         * Bind texture to target of unit with glBindTexture. The unit is left
+         * as the active texture unit, so the texture can be edited after.
+         *
+         * @param unit the texture unit index, not including GL_TEXTURE0
+         * @param target the texture target
+         * @param texture the texture id
+         */
+        void bindTexture(GLuint unit, GLenum target, GLuint texture);
+
+        /**
+         * Bind texture to target of the active texture unit.
+         *
+         * @param target the texture target
+         * @param texture the texture id
+         */
+        void bindTexture(GLenum target, GLuint texture);
+
+        /**
+         * Bind a frame buffer with glBindFramebuffer. GL_FRAMEBUFFER binds
+         * both the draw and read frame buffer.
+         *
+         * @param target GL_FRAMEBUFFER, GL_DRAW_FRAMEBUFFER or
+         *               GL_READ_FRAMEBUFFER
+         * @param buffer the frame buffer id
+         */
+        void bindFrameBuffer(GLenum target, GLuint buffer);
+
+        /**
+         * Bind a render buffer with glBindRenderbuffer.
+         *
+         * @param buffer the render buffer id
+         */
+        void bindRenderBuffer(GLuint buffer);
+
+        /**
+         * Bind a transform feedback object with glBindTransformFeedback. This
+         * also forgets the cached GL_TRANSFORM_FEEDBACK_BUFFER binding.
+         *
+         * @param feedback the transform feedback id
+         */
+        void bindTransformFeedback(GLuint feedback);
+
+        /// Notify the cache that buffer was deleted
+        void deleteBuffer(GLuint buffer);
+
+        /// Notify the cache that array was deleted
+        void deleteVertexArray(GLuint array);
+
+        /// Notify the cache that program was deleted
+        void deleteProgram(GLuint program);
+
+        /// Notify the cache that texture was deleted
+        void deleteTexture(GLuint texture);
+
+        /// Notify the cache that buffer was deleted
+        void deleteFrameBuffer(GLuint buffer);
+
+        /// Notify the cache that buffer was deleted
+        void deleteRenderBuffer(GLuint buffer);
+
+        /// Notify the cache that feedback was deleted
+        void deleteTransformFeedback(GLuint feedback);
+
+        /**
+         * Get the active texture unit index.
+         *
+         * @return the active unit, not including GL_TEXTURE0
+         */
+        GLuint getActiveTexture() const;
+
+        /**
+         * Get the issued and skipped counts for a kind of binding.
+         *
+         * @param kind the kind of binding
+         *
+         * @return the counters
+         */
+        const Counters & getCounters(Kind kind) const;
+
+        /**
+         * Get the number of skipped calls of all kinds.
+         *
+         * @return the total skipped calls
+         */
+        std::size_t getSkipped() const;
+
+        /**
+         * Set all counters to 0.
+         */
+        void resetCounters();
+
+        /**
+         * Get the cache for the context current on the calling thread.
+         *
+         * @return the thread's cache
+         */
+        static StateCache & current();
+
+        /**
+         * Get the cache of the calling thread without creating it. Objects
+         * deleted after the thread's cache was destroyed, such as statics
+         * destroyed at exit, use this to skip notifying it.
+         *
+         * @return the thread's cache, or nullptr if it does not exist
+         */
+        static StateCache * existing();
+    };
+}
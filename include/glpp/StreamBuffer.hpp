@@ -0,0 +1,182 @@
+#pragma once
+
+#include <GL/glew.h>
+// gl.h after glew.h, clang-format don't sort
+#include <GL/gl.h>
+
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#include "Buffer.hpp"
+
+namespace glpp {
+    using std::vector;
+    using std::shared_ptr;
+
+    class StreamBufferException : public std::runtime_error {
+    public:
+        using std::runtime_error::runtime_error;
+    };
+
+    /**
+     * A persistently mapped Buffer used to stream data to the GPU every frame.
+     *
+     * The buffer is created with immutable storage from glBufferStorage and is
+     * split into a number of equally sized regions, one per frame in flight.
+     * Data is written directly into the mapping through allocate, without
+     * bufferData or bufferSubData. When a frame is done, call nextFrame to
+     * fence the current region and move to the next one. A region is only
+     * written to again after the GPU has signaled its fence.
+     *
+     * The storage is immutable, so reserve, bufferData and bufferSubData are
+     * deleted. Calling them through a Buffer reference throws BufferException.
+     *
+     * Requires OpenGL 4.4 or ARB_buffer_storage.
+     */
+    class StreamBuffer : public Buffer {
+    public:
+        using Ptr = shared_ptr<StreamBuffer>;
+        using ConstPtr = const shared_ptr<StreamBuffer>;
+
+        /**
+         * A block of mapped memory returned by StreamBuffer::allocate.
+         */
+        struct Allocation {
+            /// Pointer to the mapped memory to write to
+            void * data;
+            /// Offset in bytes from the start of the buffer, use this for draws
+            GLintptr offset;
+            /// Size in bytes of the block
+            GLsizeiptr size;
+        };
+
+    private:
+        GLsizeiptr regionSize;
+        std::size_t regionCount;
+        std::size_t region;
+        GLsizeiptr head;
+        unsigned char * mapping;
+        vector<GLsync> fences;
+
+        void waitRegion();
+
+        void deleteFences();
+
+        /// Leave a moved from buffer without regions
+        void reset();
+
+    public:
+        /**
+         * Create a new StreamBuffer with empty attributes.
+         *
+         * @param regionSize the size in bytes of a single frame region
+         * @param regionCount the number of frame regions, usually 2 or 3
+         * @param target the target buffer
+         *
+         * @throws StreamBufferException if buffer storage is not supported,
+         *                               regionCount is 0 or mapping the buffer
+         *                               failed
+         */
+        StreamBuffer(GLsizeiptr regionSize,
+                     std::size_t regionCount = 3,
+                     Target target = Array);
+
+        /**
+         * Create a new StreamBuffer with attributes.
+         *
+         * @param attrib the VBO attributes
+         * @param regionSize the size in bytes of a single frame region
+         * @param regionCount the number of frame regions, usually 2 or 3
+         * @param target the target buffer
+         *
+         * @throws StreamBufferException if buffer storage is not supported,
+         *                               regionCount is 0 or mapping the buffer
+         *                               failed
+         */
+        StreamBuffer(const vector<Attribute> & attrib,
+                     GLsizeiptr regionSize,
+                     std::size_t regionCount = 3,
+                     Target target = Array);
+
+        StreamBuffer(StreamBuffer && other);
+
+        StreamBuffer & operator=(StreamBuffer && other);
+
+        StreamBuffer(const StreamBuffer &) = delete;
+        StreamBuffer & operator=(const StreamBuffer &) = delete;
+
+        /// Delete any pending fences, the buffer is unmapped when deleted
+        virtual ~StreamBuffer();
+
+        void reserve(GLsizeiptr capacity, Usage usage = Static) = delete;
+
+        void bufferData(GLsizeiptr size,
+                        const void * data,
+                        Usage usage = Static) = delete;
+
+        void bufferSubData(GLintptr offset, GLsizeiptr size, const void * data) = delete;
+
+        /**
+         * Get the size in bytes of a single frame region.
+         *
+         * @return the region size
+         */
+        GLsizeiptr getRegionSize() const;
+
+        /**
+         * Get the number of frame regions.
+         *
+         * @return the region count
+         */
+        std::size_t getRegionCount() const;
+
+        /**
+         * Get the index of the region being written to this frame.
+         *
+         * @return the current region index
+         */
+        std::size_t getRegion() const;
+
+        /**
+         * Get the offset in bytes of the current region from the start of the
+         * buffer.
+         *
+         * @return the current region offset
+         */
+        GLintptr getRegionOffset() const;
+
+        /**
+         * Get the number of bytes still available in the current region.
+         *
+         * @return the bytes remaining
+         */
+        GLsizeiptr getRemaining() const;
+
+        /**
+         * Reserve size bytes in the current region and return a pointer to
+         * write the data to. The first allocation of a frame waits for the GPU
+         * to finish with the region if it is still in use.
+         *
+         * @param size the number of bytes to reserve
+         * @param alignment the alignment of the returned offset, this should
+         *                  be the vertex stride when offset is used as the
+         *                  first vertex of a draw
+         *
+         * @return the allocation with pointer and buffer offset
+         *
+         * @throws StreamBufferException if size does not fit in the remaining
+         *                               space of the region, waiting for the
+         *                               region failed or timed out, or the
+         *                               buffer was moved from
+         */
+        Allocation allocate(GLsizeiptr size, GLsizeiptr alignment = 4);
+
+        /**
+         * Fence the current region and move to the next region. Call once per
+         * frame after the last draw that uses data from this frame.
+         */
+        void nextFrame();
+    };
+}
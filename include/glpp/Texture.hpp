@@ -20,6 +20,9 @@ namespace glpp {
 
     /**
      * Manages a single OpenGL texture.
+     *
+     * With direct state access the texture uses immutable storage, so the
+     * texture id changes each time the texture is loaded or resized.
      */
     class Texture {
     public:
@@ -68,6 +71,20 @@ namespace glpp {
         Wrap wrap;
         bool mipmaps;
 
+        /**
+         * Replace the texture with a new one that has immutable storage for
+         * the current size. Used with direct state access.
+         */
+        void createStorage();
+
+        /**
+         * Report the current storage to the ResourceTracker.
+         *
+         * @param format the internal format of the storage
+         * @param levels the number of allocated mipmap levels
+         */
+        void trackMemory(GLenum format, GLsizei levels) const;
+
     public:
         /**
          * Create a texture from an image.
@@ -149,7 +166,8 @@ namespace glpp {
                       size_t nrComponents);
 
         /**
-         * Get the OpenGL texture id.
+         * Get the OpenGL texture id. This changes after loadFrom or resize
+         * when direct state access is used.
          *
          * @return the texture id
          */
@@ -0,0 +1,199 @@
+#pragma once
+
+#include <GL/glew.h>
+// gl.h after glew.h, clang-format don't sort
+#include <GL/gl.h>
+
+#include <memory>
+#include <stdexcept>
+
+#include "Buffer.hpp"
+
+namespace glpp {
+    using std::shared_ptr;
+
+    class TransformFeedbackException : public std::runtime_error {
+    public:
+        using std::runtime_error::runtime_error;
+    };
+
+    /**
+     * Manages an OpenGL transform feedback object and the query counting the
+     * primitives it writes.
+     *
+     * Output buffers are bound to the indexed GL_TRANSFORM_FEEDBACK_BUFFER
+     * binding points of this object. Varyings are selected when the Shader
+     * is linked, see Shader::fromVertexSource.
+     *
+     * @code
+     * feedback.bindBuffer(0, particles);
+     * glEnable(GL_RASTERIZER_DISCARD);
+     * feedback.begin(Buffer::Points);
+     * source.drawArrays(Buffer::Points, 0, count);
+     * feedback.end();
+     * glDisable(GL_RASTERIZER_DISCARD);
+     * @endcode
+     *
+     * Transform feedback objects, pause, resume and draw require OpenGL 4.0
+     * or ARB_transform_feedback2. drawInstanced also requires OpenGL 4.2 or
+     * ARB_transform_feedback_instanced.
+     */
+    class TransformFeedback {
+    public:
+        using Ptr = shared_ptr<TransformFeedback>;
+        using ConstPtr = const shared_ptr<TransformFeedback>;
+
+    private:
+        GLuint feedback;
+        GLuint query;
+        bool active;
+        bool paused;
+
+    public:
+        /**
+         * Create a new transform feedback object with no buffers bound.
+         *
+         * @throws TransformFeedbackException if isSupported is false
+         */
+        TransformFeedback();
+
+        TransformFeedback(TransformFeedback && other);
+
+        TransformFeedback & operator=(TransformFeedback && other);
+
+        TransformFeedback(const TransformFeedback &) = delete;
+        TransformFeedback & operator=(const TransformFeedback &) = delete;
+
+        /// Free OpenGL resources
+        ~TransformFeedback();
+
+        /**
+         * Get the OpenGL transform feedback id.
+         *
+         * @return the transform feedback id
+         */
+        GLuint getFeedbackId() const;
+
+        /**
+         * Bind the transform feedback object.
+         */
+        void bind() const;
+
+        /**
+         * Unbind the transform feedback object, effectively binding the
+         * default object.
+         */
+        void unbind() const;
+
+        /**
+         * Bind all of buffer to an output index.
+         *
+         * @param index the index of the output, 0 for interleaved varyings
+         * @param buffer the buffer to write to
+         */
+        void bindBuffer(GLuint index, const Buffer & buffer) const;
+
+        /**
+         * Bind part of buffer to an output index.
+         *
+         * @param index the index of the output, 0 for interleaved varyings
+         * @param buffer the buffer to write to
+         * @param offset the offset in bytes, must be a multiple of 4
+         * @param size the size in bytes, must be a multiple of 4
+         */
+        void bindBuffer(GLuint index,
+                        const Buffer & buffer,
+                        GLintptr offset,
+                        GLsizeiptr size) const;
+
+        /**
+         * Bind this object and start capturing primitives. The query for
+         * primitives written is started with the capture.
+         *
+         * @param mode Points, Lines or Triangles, must match the primitives
+         *             output by the shader
+         */
+        void begin(Buffer::Mode mode);
+
+        /**
+         * Stop capturing primitives and end the primitives written query.
+         */
+        void end();
+
+        /**
+         * Pause capturing so other draw calls can be made while this object
+         * is bound.
+         */
+        void pause();
+
+        /**
+         * Resume capturing after pause.
+         */
+        void resume();
+
+        /**
+         * Check if a capture was started and not ended.
+         *
+         * @return true if between begin and end
+         */
+        bool isActive() const;
+
+        /**
+         * Check if the capture is paused.
+         *
+         * @return true if between pause and resume
+         */
+        bool isPaused() const;
+
+        /**
+         * Check if the primitives written by the last capture can be read
+         * without waiting for the GPU.
+         *
+         * @return true if getPrimitivesWritten will not block
+         */
+        bool isResultAvailable() const;
+
+        /**
+         * Get the number of primitives written by the last capture. This
+         * waits for the GPU to finish the capture.
+         *
+         * @return the number of primitives written
+         */
+        GLuint getPrimitivesWritten() const;
+
+        /**
+         * Draw the vertices written by the last capture to stream 0 using
+         * the currently bound vertex array, without reading the count back
+         * to the CPU.
+         *
+         * @param mode the primitive mode to draw
+         */
+        void draw(Buffer::Mode mode) const;
+
+        /**
+         * Draw instances of the vertices written by the last capture using
+         * the currently bound vertex array.
+         *
+         * @param mode the primitive mode to draw
+         * @param primcount the number of instances to draw
+         *
+         * @throws TransformFeedbackException if isInstancedSupported is false
+         */
+        void drawInstanced(Buffer::Mode mode, GLsizei primcount) const;
+
+        /**
+         * Check if transform feedback objects are available.
+         *
+         * @return true if OpenGL 4.0 or ARB_transform_feedback2 is present
+         */
+        static bool isSupported();
+
+        /**
+         * Check if drawInstanced is available.
+         *
+         * @return true if OpenGL 4.2 or ARB_transform_feedback_instanced is
+         *         present
+         */
+        static bool isInstancedSupported();
+    };
+}
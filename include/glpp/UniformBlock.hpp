@@ -0,0 +1,402 @@
+#pragma once
+
+#include <GL/glew.h>
+// gl.h after glew.h, clang-format don't sort
+#include <GL/gl.h>
+
+#include <cstddef>
+#include <glm/glm.hpp>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+#include "Buffer.hpp"
+
+namespace glpp {
+    using std::vector;
+    using std::shared_ptr;
+
+    /**
+     * A value with a larger alignment than its C++ type, used to match the
+     * base alignment of GLSL block layouts. The size is rounded up to the
+     * alignment.
+     *
+     * @tparam T the value type
+     * @tparam Align the alignment in bytes
+     */
+    template<typename T, std::size_t Align>
+    struct alignas(Align) Aligned {
+        T value;
+
+        Aligned() = default;
+
+        Aligned(const T & value) : value(value) {}
+
+        Aligned & operator=(const T & value) {
+            this->value = value;
+            return *this;
+        }
+
+        operator T &() {
+            return value;
+        }
+
+        operator const T &() const {
+            return value;
+        }
+    };
+
+    /**
+     * A matrix stored as an array of column vectors with a fixed column
+     * stride.
+     *
+     * @tparam C the number of columns
+     * @tparam R the number of rows
+     * @tparam Stride the alignment and stride of each column
+     */
+    template<glm::length_t C, glm::length_t R, std::size_t Stride>
+    struct BlockMatrix {
+        Aligned<glm::vec<R, float>, Stride> columns[C];
+
+        BlockMatrix() = default;
+
+        BlockMatrix(const glm::mat<C, R, float> & value) {
+            *this = value;
+        }
+
+        BlockMatrix & operator=(const glm::mat<C, R, float> & value) {
+            for (glm::length_t i = 0; i < C; i++) {
+                columns[i] = value[i];
+            }
+            return *this;
+        }
+
+        operator glm::mat<C, R, float>() const {
+            glm::mat<C, R, float> value;
+            for (glm::length_t i = 0; i < C; i++) {
+                value[i] = columns[i];
+            }
+            return value;
+        }
+    };
+
+    /**
+     * A fixed size array with a fixed element stride.
+     *
+     * @tparam T the element type
+     * @tparam N the number of elements
+     * @tparam Stride the alignment and stride of each element
+     */
+    template<typename T, std::size_t N, std::size_t Stride>
+    struct BlockArray {
+        static_assert(!std::is_same_v<T, glm::vec3> && !std::is_same_v<T, glm::mat3>,
+                      "Use the std140 or std430 vec3 and mat3 types in blocks");
+
+        Aligned<T, Stride> elements[N];
+
+        T & operator[](std::size_t i) {
+            return elements[i].value;
+        }
+
+        const T & operator[](std::size_t i) const {
+            return elements[i].value;
+        }
+
+        static constexpr std::size_t size() {
+            return N;
+        }
+    };
+
+    /**
+     * Types matching the std140 layout used by uniform blocks.
+     *
+     * Scalars use float, GLint, GLuint and boolean. Each type has the size
+     * and alignment given by the std140 rules, so a struct declared with
+     * these types gets the same member offsets in C++ and GLSL.
+     *
+     * vec3 occupies 16 bytes, a scalar that GLSL would pack after a vec3
+     * must be declared as the w component of a vec4 instead. Structs used
+     * as members or array elements must be declared alignas(16).
+     */
+    namespace std140 {
+        /// GLSL bool is 4 bytes
+        using boolean = GLuint;
+
+        using vec2 = Aligned<glm::vec2, 8>;
+        using vec3 = Aligned<glm::vec3, 16>;
+        using vec4 = Aligned<glm::vec4, 16>;
+        using ivec2 = Aligned<glm::ivec2, 8>;
+        using ivec3 = Aligned<glm::ivec3, 16>;
+        using ivec4 = Aligned<glm::ivec4, 16>;
+        using uvec2 = Aligned<glm::uvec2, 8>;
+        using uvec3 = Aligned<glm::uvec3, 16>;
+        using uvec4 = Aligned<glm::uvec4, 16>;
+
+        /// Matrix columns are padded to vec4
+        using mat2 = BlockMatrix<2, 2, 16>;
+        using mat3 = BlockMatrix<3, 3, 16>;
+        using mat4 = BlockMatrix<4, 4, 16>;
+
+        /// Array elements are padded to a multiple of vec4
+        template<typename T, std::size_t N>
+        using array = BlockArray<T, N, (alignof(T) > 16 ? alignof(T) : 16)>;
+
+        static_assert(sizeof(vec3) == 16 && alignof(vec3) == 16);
+        static_assert(sizeof(mat2) == 32 && alignof(mat2) == 16);
+        static_assert(sizeof(mat3) == 48 && alignof(mat3) == 16);
+        static_assert(sizeof(mat4) == 64 && alignof(mat4) == 16);
+        static_assert(sizeof(array<float, 4>) == 64);
+    }
+
+    /**
+     * Types matching the std430 layout used by shader storage blocks.
+     *
+     * Same as std140 except that arrays of scalars and vec2 and mat2 columns
+     * are not padded to vec4, and structs only need the alignment of their
+     * largest member.
+     */
+    namespace std430 {
+        using std140::boolean;
+
+        using std140::ivec2;
+        using std140::ivec3;
+        using std140::ivec4;
+        using std140::uvec2;
+        using std140::uvec3;
+        using std140::uvec4;
+        using std140::vec2;
+        using std140::vec3;
+        using std140::vec4;
+
+        using mat2 = BlockMatrix<2, 2, 8>;
+        using mat3 = BlockMatrix<3, 3, 16>;
+        using mat4 = BlockMatrix<4, 4, 16>;
+
+        /// Array elements have the stride of their own alignment
+        template<typename T, std::size_t N>
+        using array = BlockArray<T, N, alignof(T)>;
+
+        static_assert(sizeof(mat2) == 16 && alignof(mat2) == 8);
+        static_assert(sizeof(array<float, 4>) == 16);
+        static_assert(sizeof(array<vec3, 4>) == 64);
+    }
+
+    /**
+     * Per frame values shared by the built-in shaders, filled by
+     * extra::Camera::bindFrame. Shaders declare it as
+     *
+     * @code
+     * layout (std140) uniform Frame {
+     *     mat4 view;
+     *     mat4 projection;
+     *     mat4 viewProj;
+     *     vec3 cameraPos;
+     *     vec2 screenSize;
+     * };
+     * @endcode
+     *
+     * and connect it with Shader::bindUniformBlock("Frame", binding). The
+     * built-in shaders are connected when they are created.
+     */
+    struct FrameUniforms {
+        /// Uniform buffer binding index of the Frame block
+        static constexpr GLuint binding = 0;
+
+        std140::mat4 view;
+        std140::mat4 projection;
+        std140::mat4 viewProj;
+        std140::vec3 cameraPos;
+        std140::vec2 screenSize;
+    };
+
+    /**
+     * Get the offset in bytes of a member from the start of T.
+     *
+     * @param member the member pointer
+     *
+     * @return the member offset
+     */
+    template<typename T, typename M>
+    std::size_t blockOffset(M T::*member) {
+        // Same trick as offsetof, which does not accept member pointers
+        alignas(T) static const unsigned char storage[sizeof(T)] {};
+        auto * object = reinterpret_cast<const T *>(storage);
+        return reinterpret_cast<const unsigned char *>(&(object->*member))
+               - storage;
+    }
+
+    /**
+     * A Buffer with the Uniform target that holds one T, declared with the
+     * std140 types to match a GLSL uniform block.
+     *
+     * The whole struct is uploaded with one call, replacing a glUniform call
+     * for each member. Bind it with Buffer::bindBase and connect the block
+     * of a Shader to the same index with Shader::bindUniformBlock.
+     *
+     * @code
+     * struct Material {
+     *     std140::vec4 color;
+     *     float roughness;
+     * };
+     * UniformBlock<Material> material;
+     * material.set({glm::vec4(1), 0.5f});
+     * material.bindBase(1);
+     * shader.bindUniformBlock("Material", 1);
+     * @endcode
+     *
+     * @tparam T the block struct
+     */
+    template<typename T>
+    class UniformBlock : public Buffer {
+        static_assert(std::is_trivially_copyable_v<T>,
+                      "Uniform block struct must be trivially copyable");
+        static_assert(std::is_standard_layout_v<T>,
+                      "Uniform block struct must be standard layout");
+        static_assert(alignof(T) <= 16,
+                      "Uniform block members can not be aligned past vec4");
+
+    public:
+        using Ptr = shared_ptr<UniformBlock>;
+        using ConstPtr = const shared_ptr<UniformBlock>;
+
+        /**
+         * Create a block with uninitialized storage for one T.
+         *
+         * @param usage the usage hint
+         */
+        UniformBlock(Usage usage = Dynamic) : Buffer(Uniform) {
+            reserve(sizeof(T), usage);
+        }
+
+        /**
+         * Create a block holding value.
+         *
+         * @param value the initial value
+         * @param usage the usage hint
+         */
+        UniformBlock(const T & value, Usage usage = Dynamic) : Buffer(Uniform) {
+            bufferData(sizeof(T), &value, usage);
+        }
+
+        /**
+         * Upload the whole block.
+         *
+         * @param value the new value
+         */
+        void set(const T & value) {
+            bufferData(sizeof(T), &value, getUsage());
+        }
+
+        /**
+         * Upload a single member of the block.
+         *
+         * @param member the member pointer
+         * @param value the new member value, converted to the member type
+         */
+        template<typename M>
+        void set(M T::*member, const std::common_type_t<M> & value) {
+            // value is not deduced so glm values convert to the std140 types
+            bufferSubData(blockOffset(member), sizeof(M), &value);
+        }
+    };
+
+    /**
+     * A Buffer with the ShaderStorage target that holds an array of T,
+     * declared with the std430 types to match the elements of a GLSL shader
+     * storage block array.
+     *
+     * @code
+     * struct Light {
+     *     std430::vec3 position;
+     *     std430::vec4 color;
+     * };
+     * StorageBlock<Light> lights(lightList);
+     * lights.bindBase(0);
+     * shader.bindStorageBlock("Lights", 0);
+     * @endcode
+     *
+     * Shader storage blocks require OpenGL 4.3 or
+     * ARB_shader_storage_buffer_object. Without it the buffer can still be
+     * created but Shader::bindStorageBlock returns false.
+     *
+     * @tparam T the element struct
+     */
+    template<typename T>
+    class StorageBlock : public Buffer {
+        static_assert(std::is_trivially_copyable_v<T>,
+                      "Storage block struct must be trivially copyable");
+        static_assert(std::is_standard_layout_v<T>,
+                      "Storage block struct must be standard layout");
+
+    public:
+        using Ptr = shared_ptr<StorageBlock>;
+        using ConstPtr = const shared_ptr<StorageBlock>;
+
+    private:
+        std::size_t count;
+
+    public:
+        /**
+         * Create a block with uninitialized storage for count elements.
+         *
+         * @param count the number of elements
+         * @param usage the usage hint
+         */
+        StorageBlock(std::size_t count = 0, Usage usage = Dynamic)
+            : Buffer(ShaderStorage), count(count) {
+            reserve(count * sizeof(T), usage);
+        }
+
+        /**
+         * Create a block holding values.
+         *
+         * @param values the initial elements
+         * @param usage the usage hint
+         */
+        StorageBlock(const vector<T> & values, Usage usage = Dynamic)
+            : Buffer(ShaderStorage), count(values.size()) {
+            bufferData(values.size() * sizeof(T), values.data(), usage);
+        }
+
+        /**
+         * Get the number of elements.
+         *
+         * @return the element count
+         */
+        std::size_t getCount() const {
+            return count;
+        }
+
+        /**
+         * Upload all elements, replacing the element count.
+         *
+         * @param values the new elements
+         */
+        void set(const vector<T> & values) {
+            count = values.size();
+            bufferData(values.size() * sizeof(T), values.data(), getUsage());
+        }
+
+        /**
+         * Upload a single element.
+         *
+         * @param index the element index, must be less than getCount()
+         * @param value the new element value
+         */
+        void set(std::size_t index, const T & value) {
+            bufferSubData(index * sizeof(T), sizeof(T), &value);
+        }
+
+        /**
+         * Bind a range of elements to a binding index. The offset must be a
+         * multiple of GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT.
+         *
+         * @param index the binding index
+         * @param first the first element
+         * @param count the number of elements
+         */
+        void bindElements(GLuint index, std::size_t first, std::size_t count) const {
+            bindRange(index, first * sizeof(T), count * sizeof(T));
+        }
+    };
+}
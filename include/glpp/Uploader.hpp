@@ -0,0 +1,230 @@
+#pragma once
+
+#include <GL/glew.h>
+// gl.h after glew.h, clang-format don't sort
+#include <GL/gl.h>
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Buffer.hpp"
+#include "Texture.hpp"
+
+namespace glpp {
+    using std::string;
+    using std::vector;
+    using std::shared_ptr;
+
+    /**
+     * Runs upload jobs on a worker thread with its own OpenGL context that
+     * shares objects with the rendering context.
+     *
+     * glpp does not create contexts, the caller provides a function that
+     * makes the shared context current on the calling thread. With GLFW this
+     * is a hidden window created with the render window as its share:
+     *
+     * @code
+     * glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+     * GLFWwindow * shared = glfwCreateWindow(1, 1, "", nullptr, window);
+     * Uploader uploader([=] { glfwMakeContextCurrent(shared); },
+     *                   [] { glfwMakeContextCurrent(nullptr); });
+     * @endcode
+     *
+     * Each job is followed by glFenceSync. The returned Ticket reports when
+     * the job has run and the GPU has finished the upload, only then may the
+     * render thread use the resource. Vertex arrays and frame buffers are not
+     * shared between contexts, create and attach them on the render thread.
+     * An object must not be used by the render thread while a job for it is
+     * pending.
+     *
+     * With direct state access loadTexture replaces the texture id on the
+     * worker. Check the ticket with isReady or wait on the render thread so
+     * its StateCache forgets the old and new ids before the texture is bound.
+     */
+    class Uploader {
+    public:
+        using Ptr = shared_ptr<Uploader>;
+        using ConstPtr = const shared_ptr<Uploader>;
+
+        /// Work run on the worker thread with the shared context current
+        using Job = std::function<void()>;
+
+        /**
+         * Completion handle for a submitted job.
+         */
+        class Ticket {
+            struct State {
+                std::mutex mutex;
+                std::condition_variable cv;
+                bool done = false;
+                GLsync fence = nullptr;
+                std::exception_ptr error;
+                /// Texture ids replaced by the job, see forgetTextures
+                vector<GLuint> textures;
+
+                ~State();
+
+                /**
+                 * Drop the replaced textures from the StateCache of the
+                 * calling thread. Direct state access replaces the texture
+                 * on the worker, which only updates the worker's cache.
+                 *
+                 * @pre mutex must be locked
+                 */
+                void forgetTextures();
+            };
+
+            shared_ptr<State> state;
+
+            /// Create a ticket for a job that has not run yet
+            explicit Ticket(shared_ptr<State> state);
+
+            friend class Uploader;
+
+        public:
+            /**
+             * Create a ticket that is already done, for a resource that
+             * needs no upload. Waiting on it returns right away.
+             */
+            Ticket();
+
+            /**
+             * Check if the job has run and the GPU has finished its commands.
+             * Does not block.
+             *
+             * @return true if the resource can be used
+             */
+            bool isReady() const;
+
+            /**
+             * Block until the job has run, then make the calling context wait
+             * on the GPU for the upload with glWaitSync. The CPU does not wait
+             * for the GPU.
+             *
+             * @throws the exception thrown by the job, if any
+             */
+            void wait() const;
+        };
+
+    private:
+        struct Task {
+            Job job;
+            shared_ptr<Ticket::State> state;
+        };
+
+        std::function<void()> makeCurrent;
+        std::function<void()> release;
+        mutable std::mutex mutex;
+        std::condition_variable wake;
+        std::condition_variable idle;
+        std::deque<Task> tasks;
+        bool busy;
+        bool stopping;
+        std::thread thread;
+
+        void run();
+
+        void enqueue(Task task);
+
+        /**
+         * Run load on the worker and record the id of texture before and
+         * after it in state, see Ticket::State::forgetTextures.
+         */
+        static void loadInto(Ticket::State * state,
+                             const Texture::Ptr & texture,
+                             const std::function<void()> & load);
+
+    public:
+        /**
+         * Start the worker thread.
+         *
+         * @param makeCurrent called on the worker thread to make a context
+         *                    that shares objects with the render context
+         *                    current
+         * @param release called on the worker thread before it exits, may be
+         *                empty
+         */
+        Uploader(std::function<void()> makeCurrent,
+                 std::function<void()> release = nullptr);
+
+        Uploader(const Uploader &) = delete;
+        Uploader & operator=(const Uploader &) = delete;
+
+        /// Run all pending jobs and stop the worker thread
+        ~Uploader();
+
+        /**
+         * Queue a job to run on the worker thread.
+         *
+         * @param job the work to run with the shared context current
+         *
+         * @return the ticket for the job
+         */
+        Ticket submit(Job job);
+
+        /**
+         * Queue an upload of data into buffer with Buffer::bufferData.
+         *
+         * @param buffer the destination buffer
+         * @param data the data, moved into the job
+         * @param usage the usage hint
+         *
+         * @return the ticket for the upload
+         */
+        template<typename T>
+        Ticket bufferData(Buffer::Ptr buffer,
+                          vector<T> data,
+                          Buffer::Usage usage = Buffer::Static) {
+            return submit([buffer, data = std::move(data), usage] {
+                buffer->bufferData(data.size() * sizeof(T), data.data(), usage);
+            });
+        }
+
+        /**
+         * Queue an upload of pixel data into texture with Texture::loadFrom.
+         *
+         * @param texture the destination texture
+         * @param data the pixel data, moved into the job
+         * @param size the image size in pixels
+         * @param nrComponents the number of components for each pixel
+         *
+         * @return the ticket for the upload
+         */
+        Ticket loadTexture(Texture::Ptr texture,
+                           vector<unsigned char> data,
+                           const glm::uvec2 & size,
+                           std::size_t nrComponents);
+
+        /**
+         * Queue decoding an image file and uploading it into texture. The
+         * file is read on the worker thread.
+         *
+         * @param texture the destination texture
+         * @param path the path to the image file
+         *
+         * @return the ticket for the upload, wait throws TextureLoadException
+         *         if the image can not be loaded
+         */
+        Ticket loadTexture(Texture::Ptr texture, const string & path);
+
+        /**
+         * Get the number of jobs that have not finished running.
+         *
+         * @return the pending job count
+         */
+        std::size_t getPending() const;
+
+        /**
+         * Block until all submitted jobs have run.
+         */
+        void finish();
+    };
+}
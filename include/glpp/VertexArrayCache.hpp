@@ -0,0 +1,168 @@
+#pragma once
+
+#include <GL/glew.h>
+// gl.h after glew.h, clang-format don't sort
+#include <GL/gl.h>
+
+#include <cstddef>
+#include <unordered_map>
+#include <vector>
+
+#include "Buffer.hpp"
+
+namespace glpp {
+    using std::vector;
+
+    /**
+     * Shares vertex arrays between objects with the same attribute layout.
+     *
+     * Objects like extra::Line and extra::Grid source their vertices from a
+     * range of a shared buffer using the same attributes. Instead of each
+     * owning a BufferArray, they get a cached array for their attributes and
+     * buffer range before drawing.
+     *
+     * With OpenGL 4.3 or ARB_vertex_attrib_binding, arrays are keyed by the
+     * attributes only. The attribute format is set once with
+     * glVertexAttribFormat and get swaps the vertex buffer with
+     * glBindVertexBuffer, so one array serves every buffer with the layout.
+     * Otherwise, or when the attributes do not share one stride and divisor,
+     * arrays are keyed by the attributes, buffer and offset and are set up
+     * with glVertexAttribPointer.
+     *
+     * There is one cache per thread, like StateCache. Vertex arrays are not
+     * shared between contexts, call clear before destroying the context.
+     */
+    class VertexArrayCache {
+    public:
+        /**
+         * Number of get calls that found a cached array and number of arrays
+         * created.
+         */
+        struct Counters {
+            std::size_t hits = 0;
+            std::size_t misses = 0;
+        };
+
+    private:
+        struct Entry {
+            vector<Buffer::Attribute> attributes;
+            /// Buffer and offset of the key, 0 for shared layouts
+            GLuint buffer;
+            GLintptr offset;
+            BufferArray::Ptr array;
+            /// Vertex buffer currently bound to a shared layout
+            GLuint boundBuffer;
+            GLintptr boundOffset;
+        };
+
+        std::unordered_multimap<std::size_t, Entry> arrays;
+        Counters counters;
+        bool attribBinding;
+
+        bool isShared(const vector<Buffer::Attribute> & attributes) const;
+
+        Entry create(const Buffer & buffer,
+                     const vector<Buffer::Attribute> & attributes,
+                     GLintptr offset,
+                     bool shared) const;
+
+    public:
+        /**
+         * Create an empty cache. Vertex attrib binding is used if the current
+         * context supports it.
+         */
+        VertexArrayCache();
+
+        VertexArrayCache(const VertexArrayCache &) = delete;
+        VertexArrayCache & operator=(const VertexArrayCache &) = delete;
+
+        /**
+         * Get a vertex array sourcing attributes from buffer. The pointer of
+         * each attribute is the offset from the start of a vertex, offset is
+         * where the first vertex starts in buffer.
+         *
+         * The array is only valid until the next call to get, clear or
+         * setVertexAttribBinding, draw with it right away. It has no element
+         * buffer.
+         *
+         * @param buffer the buffer to source vertex data from
+         * @param attributes the attributes to enable
+         * @param offset offset in bytes of the first vertex in buffer
+         *
+         * @return the vertex array, ready to draw
+         */
+        const BufferArray & get(const Buffer & buffer,
+                                const vector<Buffer::Attribute> & attributes,
+                                GLintptr offset = 0);
+
+        /**
+         * Check if arrays are shared between buffers with vertex attrib
+         * binding.
+         *
+         * @return true if OpenGL 4.3 or ARB_vertex_attrib_binding is used
+         */
+        bool hasVertexAttribBinding() const;
+
+        /**
+         * Enable or disable vertex attrib binding. It can only be enabled if
+         * the current context supports it. This clears the cache.
+         *
+         * @param enabled true to use vertex attrib binding when available
+         */
+        void setVertexAttribBinding(bool enabled);
+
+        /**
+         * Get the number of cached vertex arrays.
+         *
+         * @return the number of arrays
+         */
+        std::size_t size() const;
+
+        /**
+         * Get the hit and miss counts of get.
+         *
+         * @return the counters
+         */
+        const Counters & getCounters() const;
+
+        /**
+         * Set all counters to 0.
+         */
+        void resetCounters();
+
+        /**
+         * Delete all cached vertex arrays.
+         */
+        void clear();
+
+        /// Notify the cache that buffer was deleted
+        void deleteBuffer(GLuint buffer);
+
+        /**
+         * Notify the cache that a range of buffer is no longer used, like a
+         * BufferArena::Block that was released or moved. Arrays keyed to an
+         * offset in the range are deleted, shared layouts are kept.
+         *
+         * @param buffer the buffer id
+         * @param offset the start of the range in bytes
+         * @param size the size of the range in bytes
+         */
+        void releaseRange(GLuint buffer, GLintptr offset, GLsizeiptr size);
+
+        /**
+         * Get the cache for the context current on the calling thread.
+         *
+         * @return the thread's cache
+         */
+        static VertexArrayCache & current();
+
+        /**
+         * Get the cache of the calling thread without creating it. Objects
+         * deleted after the thread's cache was destroyed, such as statics
+         * destroyed at exit, use this to skip notifying it.
+         *
+         * @return the thread's cache, or nullptr if it does not exist
+         */
+        static VertexArrayCache * existing();
+    };
+}
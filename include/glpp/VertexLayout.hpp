@@ -0,0 +1,184 @@
+#pragma once
+
+#include <GL/glew.h>
+// gl.h after glew.h, clang-format don't sort
+#include <GL/gl.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <type_traits>
+#include <vector>
+
+#include "Buffer.hpp"
+
+namespace glpp {
+    using std::vector;
+
+    /**
+     * Maps a C++ type to the component count and OpenGL type of a vertex
+     * attribute. Specialize this for custom attribute types.
+     */
+    template<typename T>
+    struct AttributeTraits;
+
+    template<>
+    struct AttributeTraits<float> {
+        static constexpr GLint size = 1;
+        static constexpr GLenum type = GL_FLOAT;
+        static constexpr bool normalized = false;
+    };
+
+    template<>
+    struct AttributeTraits<std::int32_t> {
+        static constexpr GLint size = 1;
+        static constexpr GLenum type = GL_INT;
+        static constexpr bool normalized = false;
+    };
+
+    template<>
+    struct AttributeTraits<std::uint32_t> {
+        static constexpr GLint size = 1;
+        static constexpr GLenum type = GL_UNSIGNED_INT;
+        static constexpr bool normalized = false;
+    };
+
+    template<>
+    struct AttributeTraits<std::int16_t> {
+        static constexpr GLint size = 1;
+        static constexpr GLenum type = GL_SHORT;
+        static constexpr bool normalized = false;
+    };
+
+    template<>
+    struct AttributeTraits<std::uint16_t> {
+        static constexpr GLint size = 1;
+        static constexpr GLenum type = GL_UNSIGNED_SHORT;
+        static constexpr bool normalized = false;
+    };
+
+    template<>
+    struct AttributeTraits<std::int8_t> {
+        static constexpr GLint size = 1;
+        static constexpr GLenum type = GL_BYTE;
+        static constexpr bool normalized = false;
+    };
+
+    template<>
+    struct AttributeTraits<std::uint8_t> {
+        static constexpr GLint size = 1;
+        static constexpr GLenum type = GL_UNSIGNED_BYTE;
+        static constexpr bool normalized = false;
+    };
+
+    template<glm::length_t L, typename T, glm::qualifier Q>
+    struct AttributeTraits<glm::vec<L, T, Q>> {
+        static constexpr GLint size = L;
+        static constexpr GLenum type = AttributeTraits<T>::type;
+        static constexpr bool normalized = AttributeTraits<T>::normalized;
+    };
+
+    /**
+     * Split a pointer to member into its class and member types.
+     */
+    template<typename M>
+    struct MemberPointerTraits;
+
+    template<typename C, typename M>
+    struct MemberPointerTraits<M C::*> {
+        using Class = C;
+        using Member = M;
+    };
+
+    /**
+     * Interleaved vertex attribute layout generated from the members of a
+     * vertex struct.
+     *
+     * The component count, OpenGL type and stride of each attribute are
+     * derived at compile time from the member types using AttributeTraits.
+     * Integer members that are not normalized are read as int, ivec or uvec
+     * inputs with glVertexAttribIPointer.
+     * Member offsets are taken from the member pointers. Attribute indices are
+     * assigned in the order of the members.
+     *
+     * @code
+     * using Layout = VertexLayout<Vertex, &Vertex::pos, &Vertex::norm, &Vertex::uv>;
+     * BufferArray array({Layout::attributes()});
+     * @endcode
+     *
+     * @tparam T the vertex struct
+     * @tparam Members pointers to the members of T used as attributes
+     */
+    template<typename T, auto... Members>
+    struct VertexLayout {
+        static_assert(sizeof...(Members) > 0,
+                      "VertexLayout needs at least one member");
+        static_assert(std::is_standard_layout_v<T>,
+                      "VertexLayout requires a standard layout struct");
+        static_assert(
+            (std::is_same_v<typename MemberPointerTraits<decltype(Members)>::Class, T> && ...),
+            "VertexLayout members must belong to the vertex struct");
+
+        /// Number of attributes in the layout
+        static constexpr std::size_t count = sizeof...(Members);
+
+        /// Distance in bytes between two vertices
+        static constexpr GLsizei stride = sizeof(T);
+
+        /// Component count of each attribute
+        static constexpr GLint sizes[] = {
+            AttributeTraits<typename MemberPointerTraits<decltype(Members)>::Member>::size...};
+
+        /// OpenGL type of each attribute
+        static constexpr GLenum types[] = {
+            AttributeTraits<typename MemberPointerTraits<decltype(Members)>::Member>::type...};
+
+        /// If each attribute is read as an integer input
+        static constexpr bool integers[] = {
+            (Buffer::Attribute::isIntegerType(
+                 AttributeTraits<typename MemberPointerTraits<decltype(Members)>::Member>::type)
+             && !AttributeTraits<typename MemberPointerTraits<decltype(Members)>::Member>::normalized)...};
+
+        /**
+         * Get the offset in bytes of member from the start of T.
+         *
+         * @tparam Member the member pointer
+         *
+         * @return the member offset
+         */
+        template<auto Member>
+        static std::size_t offsetOf() {
+            // Same trick as offsetof, which does not accept member pointers
+            alignas(T) static const unsigned char storage[sizeof(T)] {};
+            auto * object = reinterpret_cast<const T *>(storage);
+            return reinterpret_cast<const unsigned char *>(&(object->*Member))
+                   - storage;
+        }
+
+        /**
+         * Create the attributes for a single interleaved buffer.
+         *
+         * @param firstIndex the index of the first attribute, each following
+         *                   attribute uses the next index
+         * @param divisor the divisor for all attributes, 0 for per vertex data
+         *
+         * @return the attribute list
+         */
+        static vector<Buffer::Attribute> attributes(GLuint firstIndex = 0,
+                                                    GLuint divisor = 0) {
+            vector<Buffer::Attribute> attrs;
+            attrs.reserve(count);
+            (attrs.emplace_back(
+                 GLuint(firstIndex + attrs.size()),
+                 AttributeTraits<typename MemberPointerTraits<decltype(Members)>::Member>::size,
+                 AttributeTraits<typename MemberPointerTraits<decltype(Members)>::Member>::type,
+                 AttributeTraits<typename MemberPointerTraits<decltype(Members)>::Member>::normalized,
+                 stride,
+                 reinterpret_cast<const void *>(offsetOf<Members>()),
+                 divisor,
+                 integers[attrs.size()]),
+             ...);
+            return attrs;
+        }
+    };
+}
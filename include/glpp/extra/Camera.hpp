@@ -7,6 +7,8 @@
 #include <glm/glm.hpp>
 #include <memory>
 
+#include "glpp/UniformBlock.hpp"
+
 namespace glpp::extra {
     using std::shared_ptr;
 
@@ -175,5 +177,27 @@ namespace glpp::extra {
          * @return the projection matrix
          */
         glm::mat4 projMatrix() const;
+
+        /**
+         * Get the Frame uniform block values for this camera.
+         *
+         * @return the view, projection, camera position and screen size
+         */
+        FrameUniforms frameUniforms() const;
+
+        /**
+         * Upload frameUniforms to frameBlock and bind it to
+         * FrameUniforms::binding. Call once per frame, or after the camera
+         * changes, before drawing with the built-in shaders.
+         */
+        void bindFrame() const;
+
+        /**
+         * Get the uniform buffer shared by all cameras for the Frame block.
+         * This buffer will always outlive the OpenGL context.
+         *
+         * @return the Frame uniform block
+         */
+        static UniformBlock<FrameUniforms> & frameBlock();
     };
 }
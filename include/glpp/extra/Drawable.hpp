@@ -13,7 +13,8 @@ namespace glpp::extra {
         virtual void draw() const = 0;
 
         /**
-         * Bind the shader and apply transform to the mvp uniform.
+         * Bind the shader and apply transform to the model uniform. The view
+         * and projection are read from the Frame uniform block.
          *
          * @param transform
          */
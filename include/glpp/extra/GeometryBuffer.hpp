@@ -5,6 +5,7 @@
 
 #include "glpp/FrameBuffer.hpp"
 #include "glpp/Shader.hpp"
+#include "glpp/ShaderBuilder.hpp"
 #include "glpp/Texture.hpp"
 #include "glpp/extra/Vertex.hpp"
 
@@ -38,5 +39,15 @@ namespace glpp::extra {
         void bindTextures() const;
 
         static Shader & getShader();
+
+        /**
+         * Submit the geometry shader to builder so it compiles along with
+         * other shaders. The next call to getShader() takes it from the
+         * builder instead of compiling. Does nothing if the shader was
+         * already created or submitted.
+         *
+         * @param builder the builder to compile with
+         */
+        static void warmShader(ShaderBuilder & builder);
     };
 }
@@ -4,7 +4,9 @@
 
 #include "Vertex.hpp"
 #include "glpp/Buffer.hpp"
+#include "glpp/BufferArena.hpp"
 #include "glpp/Shader.hpp"
+#include "glpp/ShaderBuilder.hpp"
 
 namespace glpp::extra {
     using std::shared_ptr;
@@ -20,7 +22,7 @@ namespace glpp::extra {
         using ConstPtr = const shared_ptr<Grid>;
 
     private:
-        BufferArray::Ptr array;
+        BufferArena::Allocation block;
         int n;
         int size;
         glm::vec4 color;
@@ -90,20 +92,33 @@ namespace glpp::extra {
         void draw() const;
 
         /**
-         * Draw the grid with the given transform.
+         * Draw the grid with the given model transform. The view and
+         * projection are read from the Frame uniform block, see
+         * Camera::bindFrame.
          *
-         * @param transform the transform for this grid
+         * @param transform the model transform for this grid
          */
         void draw(const glm::mat4 & transform) const;
 
         /**
          * Get the grid shader.
          *
-         * This shader has a mat4 uniform called mvp. This can be set manually
-         * or by passing a transform into draw.
+         * This shader has a mat4 uniform called model and reads the view and
+         * projection from the Frame uniform block. The model can be set
+         * manually or by passing a transform into draw.
          *
          * @return the Shader for a grid
          */
         static Shader & shader();
+
+        /**
+         * Submit the grid shader to builder so it compiles along with other
+         * shaders. The next call to shader() takes it from the builder
+         * instead of compiling. Does nothing if the shader was already
+         * created or submitted.
+         *
+         * @param builder the builder to compile with
+         */
+        static void warmShader(ShaderBuilder & builder);
     };
 }
@@ -5,7 +5,9 @@
 
 #include "Vertex.hpp"
 #include "glpp/Buffer.hpp"
+#include "glpp/BufferArena.hpp"
 #include "glpp/Shader.hpp"
+#include "glpp/ShaderBuilder.hpp"
 
 namespace glpp::extra {
     using std::shared_ptr;
@@ -32,7 +34,7 @@ namespace glpp::extra {
         };
 
     private:
-        BufferArray::Ptr array;
+        BufferArena::Allocation block;
         int n;
         Mode mode;
         glm::vec4 color;
@@ -185,20 +187,33 @@ namespace glpp::extra {
         void draw() const;
 
         /**
-         * Draw the line with the given transform.
+         * Draw the line with the given model transform. The view and
+         * projection are read from the Frame uniform block, see
+         * Camera::bindFrame.
          *
-         * @param transform the transform for this line
+         * @param transform the model transform for this line
          */
         void draw(const glm::mat4 & transform) const;
 
         /**
          * Get the line shader.
          *
-         * This shader has a mat4 uniform called mvp. This can be set manually
-         * or by passing a transform into draw.
+         * This shader has a mat4 uniform called model and reads the view and
+         * projection from the Frame uniform block. The model can be set
+         * manually or by passing a transform into draw.
          *
          * @return the Shader for lines
          */
         static Shader & shader();
+
+        /**
+         * Submit the line shader to builder so it compiles along with other
+         * shaders. The next call to shader() takes it from the builder
+         * instead of compiling. Does nothing if the shader was already
+         * created or submitted.
+         *
+         * @param builder the builder to compile with
+         */
+        static void warmShader(ShaderBuilder & builder);
     };
 }
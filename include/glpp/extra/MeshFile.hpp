@@ -0,0 +1,257 @@
+#pragma once
+
+#include <GL/glew.h>
+// gl.h after glew.h, clang-format don't sort
+#include <GL/gl.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "glpp/Buffer.hpp"
+#include "Vertex.hpp"
+
+namespace glpp::extra {
+    using std::string;
+    using std::vector;
+    using std::shared_ptr;
+
+    class MeshFileException : public std::runtime_error {
+    public:
+        using std::runtime_error::runtime_error;
+    };
+
+    /**
+     * Axis aligned bounding box of a mesh.
+     */
+    struct MeshBounds {
+        glm::vec3 min;
+        glm::vec3 max;
+    };
+
+    /**
+     * Fixed 64 byte header at the start of a mesh file.
+     *
+     * The file is followed by one MeshFileAttribute for each attribute, the
+     * interleaved vertex data and the index data. Each section starts at a
+     * multiple of MeshFile::alignment bytes. All values are stored in the
+     * byte order of the machine that wrote the file.
+     */
+    struct MeshFileHeader {
+        char magic[4];
+        std::uint32_t version;
+        std::uint32_t attributeCount;
+        /// GL_UNSIGNED_BYTE, GL_UNSIGNED_SHORT, GL_UNSIGNED_INT or 0
+        std::uint32_t indexType;
+        std::uint64_t vertexCount;
+        std::uint64_t indexCount;
+        std::uint32_t vertexStride;
+        float boundsMin[3];
+        float boundsMax[3];
+        std::uint32_t reserved;
+    };
+
+    /**
+     * A Buffer::Attribute as stored in a mesh file, with the pointer stored
+     * as an offset into the vertex.
+     */
+    struct MeshFileAttribute {
+        std::uint32_t index;
+        std::int32_t size;
+        std::uint32_t type;
+        std::uint32_t normalized;
+        std::uint32_t offset;
+        std::uint32_t divisor;
+        /// Non-zero for Buffer::Attribute::integer, 0 in older files
+        std::uint32_t integer;
+        std::uint32_t reserved;
+    };
+
+    static_assert(sizeof(MeshFileHeader) == 64, "MeshFileHeader must be 64 bytes");
+    static_assert(sizeof(MeshFileAttribute) == 32,
+                  "MeshFileAttribute must be 32 bytes");
+
+    /**
+     * A read only memory mapped mesh file.
+     *
+     * Loading only validates the header, attributes and section sizes, vertex
+     * and index data are uploaded to OpenGL straight from the mapping without
+     * parsing or copying into intermediate vectors. The mapping is released
+     * when the MeshFile is destroyed, keep it only as long as the data is
+     * needed.
+     *
+     * @code
+     * MeshFile::write("cube.mesh", IndexedMesh::weld(vertices));
+     * MeshFile file("cube.mesh");
+     * auto array = file.createArray();
+     * array->drawElements(Buffer::Triangles);
+     * @endcode
+     */
+    class MeshFile {
+    public:
+        using Ptr = shared_ptr<MeshFile>;
+        using ConstPtr = const shared_ptr<MeshFile>;
+
+        /// Section alignment in bytes
+        static constexpr std::size_t alignment = 64;
+
+        /// Current format version
+        static constexpr std::uint32_t version = 1;
+
+    private:
+        const unsigned char * mapping;
+        std::size_t mappingSize;
+        void * handle;
+
+        const MeshFileHeader & header() const;
+
+        void unmap();
+
+    public:
+        /**
+         * Map the mesh file at path.
+         *
+         * @param path the path to the mesh file
+         *
+         * @throws MeshFileException if the file can not be mapped or is not a
+         *         valid mesh file
+         */
+        MeshFile(const string & path);
+
+        MeshFile(MeshFile && other);
+
+        MeshFile & operator=(MeshFile && other);
+
+        MeshFile(const MeshFile &) = delete;
+        MeshFile & operator=(const MeshFile &) = delete;
+
+        /// Unmap the file
+        ~MeshFile();
+
+        /**
+         * Get the vertex attributes with pointers as offsets into a vertex.
+         *
+         * @return the attributes for an interleaved buffer
+         */
+        vector<Buffer::Attribute> getAttributes() const;
+
+        /**
+         * Get the distance in bytes between two vertices.
+         *
+         * @return the vertex stride
+         */
+        GLsizei getStride() const;
+
+        std::size_t getVertexCount() const;
+
+        std::size_t getIndexCount() const;
+
+        /**
+         * Get the index type.
+         *
+         * @return GL_UNSIGNED_BYTE, GL_UNSIGNED_SHORT, GL_UNSIGNED_INT or 0
+         *         if the mesh has no indices
+         */
+        GLenum getIndexType() const;
+
+        MeshBounds getBounds() const;
+
+        /**
+         * Get a pointer to the vertex data in the mapping.
+         *
+         * @return the vertex data, valid while this MeshFile exists
+         */
+        const void * getVertexData() const;
+
+        /**
+         * Get the size in bytes of the vertex data.
+         *
+         * @return the vertex data size
+         */
+        std::size_t getVertexDataSize() const;
+
+        /**
+         * Get a pointer to the index data in the mapping.
+         *
+         * @return the index data, valid while this MeshFile exists
+         */
+        const void * getIndexData() const;
+
+        /**
+         * Get the size in bytes of the index data.
+         *
+         * @return the index data size
+         */
+        std::size_t getIndexDataSize() const;
+
+        /**
+         * Upload the vertex data into the first buffer of array and the index
+         * data into its element buffer. The attributes of the first buffer
+         * must match getAttributes().
+         *
+         * @param array the array to upload into
+         * @param usage the buffer usage hint
+         */
+        void upload(BufferArray & array, Buffer::Usage usage = Buffer::Static) const;
+
+        /**
+         * Create a BufferArray with one buffer using getAttributes() and
+         * upload the mesh into it.
+         *
+         * @param usage the buffer usage hint
+         *
+         * @return the new array
+         */
+        BufferArray::Ptr createArray(Buffer::Usage usage = Buffer::Static) const;
+
+        /**
+         * Write a mesh file.
+         *
+         * @param path the path to the new file
+         * @param attributes the attributes of the interleaved vertex data,
+         *                   pointers are offsets into a vertex
+         * @param stride the distance in bytes between two vertices
+         * @param vertexCount the number of vertices
+         * @param vertices the vertex data
+         * @param indexCount the number of indices, may be 0
+         * @param indexType the index type, ignored if indexCount is 0
+         * @param indices the index data
+         * @param bounds the mesh bounds
+         *
+         * @throws MeshFileException if the file can not be written
+         */
+        static void write(const string & path,
+                          const vector<Buffer::Attribute> & attributes,
+                          GLsizei stride,
+                          std::size_t vertexCount,
+                          const void * vertices,
+                          std::size_t indexCount,
+                          GLenum indexType,
+                          const void * indices,
+                          const MeshBounds & bounds);
+
+        /**
+         * Write an indexed mesh with the Vertex attributes. Indices are
+         * stored with IndexedMesh::getIndexType.
+         *
+         * @param path the path to the new file
+         * @param mesh the mesh to write
+         *
+         * @throws MeshFileException if the file can not be written
+         */
+        static void write(const string & path, const IndexedMesh & mesh);
+
+        /**
+         * Get the bounds of vertex positions.
+         *
+         * @param vertices the vertices
+         *
+         * @return the bounds, or zero size bounds at the origin if empty
+         */
+        static MeshBounds boundsOf(const vector<Vertex> & vertices);
+    };
+}
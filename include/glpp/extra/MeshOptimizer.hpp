@@ -0,0 +1,116 @@
+#pragma once
+
+#include <GL/glew.h>
+// gl.h after glew.h, clang-format don't sort
+#include <GL/gl.h>
+
+#include <cstddef>
+#include <glm/glm.hpp>
+#include <vector>
+
+namespace glpp::extra {
+    using std::vector;
+
+    /**
+     * Reorder triangles to reduce post-transform vertex cache misses, using
+     * Tom Forsyth's linear-speed vertex cache optimization.
+     *
+     * @param indices the triangle list indices
+     * @param vertexCount the number of vertices referenced by indices
+     *
+     * @return the reordered indices
+     */
+    vector<GLuint> optimizeVertexCache(const vector<GLuint> & indices,
+                                       std::size_t vertexCount);
+
+    /**
+     * Reorder clusters of triangles so outward facing clusters are drawn
+     * first, reducing overdraw. Run optimizeVertexCache first, clusters are
+     * split where the cache order starts a new run of triangles so the cache
+     * efficiency is mostly kept.
+     *
+     * @param indices the triangle list indices
+     * @param positions the vertex positions
+     *
+     * @return the reordered indices
+     */
+    vector<GLuint> optimizeOverdraw(const vector<GLuint> & indices,
+                                    const vector<glm::vec3> & positions);
+
+    /**
+     * Get the vertex remap that orders vertices by first use in indices.
+     * Vertices that are not used are mapped to ~0u.
+     *
+     * @param indices the triangle list indices
+     * @param vertexCount the number of vertices
+     * @param usedCount set to the number of used vertices
+     *
+     * @return the new index of each vertex
+     */
+    vector<GLuint> vertexFetchRemap(const vector<GLuint> & indices,
+                                    std::size_t vertexCount,
+                                    std::size_t & usedCount);
+
+    /**
+     * Get the average number of vertex shader invocations per triangle for a
+     * FIFO post-transform cache. Lower is better, the minimum is around 0.5
+     * for large regular meshes and the maximum is 3.
+     *
+     * @param indices the triangle list indices
+     * @param vertexCount the number of vertices
+     * @param cacheSize the number of cache entries to simulate
+     *
+     * @return the average cache miss ratio
+     */
+    float averageCacheMissRatio(const vector<GLuint> & indices,
+                                std::size_t vertexCount,
+                                std::size_t cacheSize = 16);
+
+    /**
+     * Reorder vertices by first use in indices for vertex fetch locality and
+     * update indices to match. Unused vertices are removed.
+     *
+     * @param vertices the vertices to reorder, any vertex type
+     * @param indices the triangle list indices
+     */
+    template<typename T>
+    void optimizeVertexFetch(vector<T> & vertices, vector<GLuint> & indices) {
+        std::size_t usedCount;
+        auto remap = vertexFetchRemap(indices, vertices.size(), usedCount);
+
+        vector<T> reordered(usedCount);
+        for (std::size_t i = 0; i < vertices.size(); i++) {
+            if (remap[i] != ~0u)
+                reordered[remap[i]] = vertices[i];
+        }
+        vertices = std::move(reordered);
+
+        for (auto & index : indices) {
+            index = remap[index];
+        }
+    }
+
+    /**
+     * Run optimizeVertexCache, optionally optimizeOverdraw, and
+     * optimizeVertexFetch before uploading a mesh.
+     *
+     * @param vertices the vertices with a pos member, like Vertex
+     * @param indices the triangle list indices
+     * @param overdraw should triangles also be ordered for overdraw
+     */
+    template<typename T>
+    void optimizeMesh(vector<T> & vertices, vector<GLuint> & indices, bool overdraw = false) {
+        indices = optimizeVertexCache(indices, vertices.size());
+
+        if (overdraw) {
+            vector<glm::vec3> positions;
+            positions.reserve(vertices.size());
+            for (auto & v : vertices) {
+                positions.push_back(v.pos);
+            }
+            indices = optimizeOverdraw(indices, positions);
+        }
+
+        optimizeVertexFetch(vertices, indices);
+    }
+}
@@ -4,6 +4,7 @@
 
 #include "Vertex.hpp"
 #include "glpp/Buffer.hpp"
+#include "glpp/BufferArena.hpp"
 
 namespace glpp::extra {
     using std::shared_ptr;
@@ -18,6 +19,8 @@ namespace glpp::extra {
 
     private:
         BufferArray::Ptr array;
+        BufferArena::Allocation block;
+        mutable unsigned int blockVersion;
         float vertices[8];
         glm::vec2 pos;
         glm::vec2 size;
@@ -36,6 +39,8 @@ namespace glpp::extra {
 
         void updateBuffer();
 
+        void attachBlock() const;
+
     public:
         /**
          * Create a new quad with optional position and size.
@@ -1,9 +1,11 @@
 #pragma once
 
+#include <cstdint>
 #include <memory>
 #include <vector>
 
 #include "glpp/Buffer.hpp"
+#include "glpp/VertexLayout.hpp"
 
 namespace glpp::extra {
     using std::vector;
@@ -101,6 +103,146 @@ namespace glpp::extra {
         Vertex & operator-=(const Vertex & other);
     };
 
+    /**
+     * Deduplicated vertices with a triangle list index buffer.
+     */
+    struct IndexedMesh {
+        /// The unique vertices
+        vector<Vertex> vertices;
+        /// Indices into vertices, three for each triangle
+        vector<GLuint> indices;
+
+        /**
+         * Get the smallest index type that can address all vertices.
+         *
+         * @return GL_UNSIGNED_BYTE, GL_UNSIGNED_SHORT or GL_UNSIGNED_INT
+         */
+        GLenum getIndexType() const;
+
+        /**
+         * Merge vertices of a triangle soup that are equal within epsilon.
+         *
+         * Vertices are hashed into a grid of epsilon sized cells by position.
+         * A vertex is merged with the first earlier vertex in the same or a
+         * neighbouring cell whose position, normal and UV components all
+         * differ by at most epsilon. Triangle order is kept.
+         *
+         * @param soup the vertices, three for each triangle
+         * @param epsilon the largest difference for each component
+         *
+         * @return the welded mesh
+         */
+        static IndexedMesh weld(const vector<Vertex> & soup,
+                                float epsilon = 1e-5f);
+    };
+
+    /**
+     * A position with a color, used by Line and Grid.
+     */
+    struct ColorVertex {
+        /// The position
+        glm::vec3 pos;
+        /// The color
+        glm::vec4 color;
+    };
+
+    /**
+     * A normal packed into signed normalized 10 bit x, y and z components in
+     * the GL_INT_2_10_10_10_REV format. The 2 bit w component is 0.
+     */
+    struct PackedNormal {
+        std::uint32_t bits;
+
+        /**
+         * Create a packed zero normal.
+         */
+        PackedNormal();
+
+        /**
+         * Pack a normal, clamping each component to [-1, 1].
+         *
+         * @param norm the normal
+         */
+        explicit PackedNormal(const glm::vec3 & norm);
+
+        /**
+         * Get the normal with the precision lost by packing.
+         *
+         * @return the unpacked normal
+         */
+        glm::vec3 unpack() const;
+    };
+
+    /**
+     * Two 16 bit half floats in the GL_HALF_FLOAT format.
+     */
+    struct HalfVec2 {
+        std::uint16_t x;
+        std::uint16_t y;
+
+        /**
+         * Create a half vector with both components 0.
+         */
+        HalfVec2();
+
+        /**
+         * Convert a vector to half floats, rounding to nearest.
+         *
+         * @param v the vector
+         */
+        explicit HalfVec2(const glm::vec2 & v);
+
+        /**
+         * Get the vector with the precision lost by conversion.
+         *
+         * @return the unpacked vector
+         */
+        glm::vec2 unpack() const;
+    };
+
+    /**
+     * A 20 byte version of Vertex for large meshes. The normal is packed to
+     * 10 bits per component and the UV is stored as half floats. Attribute
+     * indices match Vertex so the same shaders can be used.
+     */
+    struct CompactVertex {
+        /// The position
+        glm::vec3 pos;
+        /// The packed normal
+        PackedNormal norm;
+        /// The half float UV texture coordinate
+        HalfVec2 uv;
+
+        /**
+         * Create a new vertex with all fields set to 0.
+         */
+        CompactVertex();
+
+        /**
+         * Create a new CompactVertex by packing the fields of vertex.
+         *
+         * @param vertex the full precision vertex
+         */
+        explicit CompactVertex(const Vertex & vertex);
+
+        /**
+         * Unpack to a full precision Vertex.
+         *
+         * @return the unpacked vertex
+         */
+        Vertex unpack() const;
+
+        /**
+         * Convert a list of Vertex. Uses SSE2 and F16C when the compiler
+         * targets them, otherwise each vertex is converted separately.
+         *
+         * @param vertices the full precision vertices
+         *
+         * @return the compact vertices
+         */
+        static vector<CompactVertex> fromVertices(const vector<Vertex> & vertices);
+    };
+
     /**
      * Derived from BufferArray for use with the Vertex type.
      */
@@ -162,5 +304,110 @@ namespace glpp::extra {
          * @param data the buffer data
          */
         void bufferSubData(GLintptr offset, GLsizeiptr size, const Vertex * data);
+
+        /**
+         * Send the vertices and indices of mesh to the buffer. Draw them with
+         * drawElements(Mode).
+         *
+         * @param mesh the indexed mesh
+         * @param usage the buffer usage hint
+         *
+         * @see ElementBuffer::bufferElements
+         */
+        void bufferData(const IndexedMesh & mesh, Usage usage = Usage::Static);
+    };
+
+    /**
+     * Derived from BufferArray for use with the CompactVertex type.
+     */
+    class CompactVertexBufferArray : public BufferArray {
+    public:
+        using Ptr = shared_ptr<CompactVertexBufferArray>;
+        using ConstPtr = const shared_ptr<CompactVertexBufferArray>;
+
+    private:
+        using BufferArray::bufferData;
+        using BufferArray::bufferSubData;
+
+    public:
+        /**
+         * Create an empty CompactVertexBufferArray.
+         */
+        CompactVertexBufferArray();
+
+        CompactVertexBufferArray(CompactVertexBufferArray && other);
+
+        CompactVertexBufferArray & operator=(CompactVertexBufferArray && other);
+
+        CompactVertexBufferArray(const CompactVertexBufferArray &) = delete;
+        CompactVertexBufferArray & operator=(const CompactVertexBufferArray &) = delete;
+
+        ~CompactVertexBufferArray();
+
+        /**
+         * Send a vector of CompactVertex to the buffer.
+         *
+         * @param data the buffer data
+         * @param usage the buffer usage hint
+         *
+         * @see BufferArray::bufferData
+         */
+        inline void bufferData(const vector<CompactVertex> & data,
+                               Usage usage = Usage::Static) {
+            bufferData(data.size(), data.data(), usage);
+        }
+
+        /**
+         * Convert a vector of Vertex and send it to the buffer.
+         *
+         * @param data the full precision buffer data
+         * @param usage the buffer usage hint
+         *
+         * @see CompactVertex::fromVertices
+         */
+        inline void bufferData(const vector<Vertex> & data,
+                               Usage usage = Usage::Static) {
+            bufferData(CompactVertex::fromVertices(data), usage);
+        }
+
+        /**
+         * Send CompactVertex to the buffer from pointer and size.
+         *
+         * @param size the number of elements in data
+         * @param data the buffer data
+         * @param usage the buffer usage hint
+         *
+         * @see BufferArray::bufferData
+         */
+        void bufferData(GLsizeiptr size,
+                        const CompactVertex * data,
+                        Usage usage = Usage::Static);
+
+        /**
+         * Replace a subset of the buffer with new data.
+         *
+         * @param offset the start index
+         * @param size the number of elements to replace
+         * @param data the buffer data
+         */
+        void bufferSubData(GLintptr offset,
+                           GLsizeiptr size,
+                           const CompactVertex * data);
+    };
+}
+
+namespace glpp {
+    template<>
+    struct AttributeTraits<extra::PackedNormal> {
+        static constexpr GLint size = 4;
+        static constexpr GLenum type = GL_INT_2_10_10_10_REV;
+        static constexpr bool normalized = true;
+    };
+
+    template<>
+    struct AttributeTraits<extra::HalfVec2> {
+        static constexpr GLint size = 2;
+        static constexpr GLenum type = GL_HALF_FLOAT;
+        static constexpr bool normalized = false;
     };
 }
@@ -1,5 +1,12 @@
 #include "glpp/Buffer.hpp"
 
+#include <algorithm>
+
+#include "glpp/IndirectCommandBuffer.hpp"
+#include "glpp/ResourceTracker.hpp"
+#include "glpp/StateCache.hpp"
+#include "glpp/VertexArrayCache.hpp"
+
 namespace glpp {
     Buffer::Attribute::Attribute(GLuint index,
                                  GLint size,
@@ -7,17 +14,22 @@ namespace glpp {
                                  bool normalized,
                                  GLsizei stride,
                                  const void * pointer,
-                                 GLuint divisor)
+                                 GLuint divisor,
+                                 bool integer)
         : index(index),
           size(size),
           type(type),
           normalized(normalized),
           stride(stride),
           pointer(pointer),
-          divisor(divisor) {}
+          divisor(divisor),
+          integer(integer) {}
 
     void Buffer::Attribute::enable() const {
-        glVertexAttribPointer(index, size, type, normalized, stride, pointer);
+        if (integer)
+            glVertexAttribIPointer(index, size, type, stride, pointer);
+        else
+            glVertexAttribPointer(index, size, type, normalized, stride, pointer);
         // Switch starting with OpenGL 4.3
         // https://stackoverflow.com/a/50651756
         if (glVertexBindingDivisor != nullptr)
@@ -40,32 +52,72 @@ namespace glpp {
     Buffer::Buffer(Target target) : Buffer({}, target) {}
 
     Buffer::Buffer(const vector<Attribute> & attrib, Target target)
-        : attrib(attrib), target(target) {
-        glGenBuffers(1, &buffer);
+        : attrib(attrib),
+          target(target),
+          size(0),
+          capacity(0),
+          usage(Static),
+          reallocations(0),
+          immutable(false) {
+        if (StateCache::current().hasDirectStateAccess())
+            glCreateBuffers(1, &buffer);
+        else
+            glGenBuffers(1, &buffer);
     }
 
     Buffer::Buffer(Buffer && other)
-        : target(other.target), buffer(other.buffer), attrib(other.attrib) {
+        : target(other.target),
+          buffer(other.buffer),
+          attrib(other.attrib),
+          size(other.size),
+          capacity(other.capacity),
+          usage(other.usage),
+          reallocations(other.reallocations),
+          immutable(other.immutable) {
         other.buffer = 0;
     }
 
     Buffer & Buffer::operator=(Buffer && other) {
+        if (this == &other)
+            return *this;
+        release();
         target = other.target;
         buffer = other.buffer;
         attrib = other.attrib;
+        size = other.size;
+        capacity = other.capacity;
+        usage = other.usage;
+        reallocations = other.reallocations;
+        immutable = other.immutable;
         other.buffer = 0;
         return *this;
     }
 
     Buffer::~Buffer() {
-        if (buffer)
+        release();
+    }
+
+    void Buffer::release() {
+        if (buffer) {
+            if (auto cache = StateCache::existing())
+                cache->deleteBuffer(buffer);
+            if (auto cache = VertexArrayCache::existing())
+                cache->deleteBuffer(buffer);
+            ResourceTracker::getDefault().untrack(ResourceTracker::BufferMemory,
+                                                  buffer);
             glDeleteBuffers(1, &buffer);
+            buffer = 0;
+        }
     }
 
     Buffer::Target Buffer::getTarget() const {
         return target;
     }
 
+    const vector<Buffer::Attribute> & Buffer::getAttributes() const {
+        return attrib;
+    }
+
     GLuint Buffer::getBufferId() const {
         return buffer;
     }
@@ -84,24 +136,222 @@ namespace glpp {
         }
     }
     void Buffer::bind() const {
-        glBindBuffer(target, buffer);
+        StateCache::current().bindBuffer(target, buffer);
     }
 
     void Buffer::unbind() const {
-        glBindBuffer(target, 0);
+        StateCache::current().bindBuffer(target, 0);
     }
 
-    void Buffer::bufferData(GLsizeiptr size, const void * data, Usage usage) {
+    // glBindBufferBase and glBindBufferRange also set the generic binding,
+    // bind through the cache first so it stays in sync
+
+    void Buffer::bindBase(GLuint index) const {
+        bind();
+        glBindBufferBase(target, index, buffer);
+    }
+
+    void Buffer::bindRange(GLuint index, GLintptr offset, GLsizeiptr size) const {
         bind();
-        glBufferData(target, size, data, usage);
+        glBindBufferRange(target, index, buffer, offset, size);
+    }
+
+    GLsizeiptr Buffer::getSize() const {
+        return size;
+    }
+
+    GLsizeiptr Buffer::getCapacity() const {
+        return capacity;
+    }
+
+    Buffer::Usage Buffer::getUsage() const {
+        return usage;
+    }
+
+    std::size_t Buffer::getReallocations() const {
+        return reallocations;
+    }
+
+    bool Buffer::isImmutable() const {
+        return immutable;
+    }
+
+    void Buffer::reserve(GLsizeiptr capacity, Usage usage) {
+        if (immutable)
+            throw BufferException("Can not reserve immutable buffer storage");
+
+        if (capacity <= this->capacity && usage == this->usage)
+            return;
+
+        // Nothing to allocate yet, keep the usage for the first bufferData
+        if (capacity == 0 && this->capacity == 0) {
+            this->usage = usage;
+            return;
+        }
+
+        capacity = std::max(capacity, this->capacity);
+        storeData(capacity, nullptr, usage);
+        this->size = 0;
+        this->capacity = capacity;
+        this->usage = usage;
+        reallocations++;
+        trackMemory();
+    }
+
+    void Buffer::trackMemory() const {
+        ResourceTracker::getDefault().track({ResourceTracker::BufferMemory,
+                                             buffer,
+                                             GLenum(target),
+                                             GLenum(usage),
+                                             0,
+                                             0,
+                                             0,
+                                             0,
+                                             0,
+                                             std::size_t(capacity)});
+    }
+
+    void Buffer::setStorage(GLsizeiptr capacity, Usage usage) {
+        this->size = capacity;
+        this->capacity = capacity;
+        this->usage = usage;
+        immutable = true;
+        trackMemory();
+    }
+
+    void Buffer::storeData(GLsizeiptr size, const void * data, Usage usage) {
+        if (StateCache::current().hasDirectStateAccess()) {
+            glNamedBufferData(buffer, size, data, usage);
+        }
+        else {
+            bind();
+            glBufferData(target, size, data, usage);
+        }
+    }
+
+    void Buffer::bufferData(GLsizeiptr size, const void * data, Usage usage) {
+        if (immutable)
+            throw BufferException(
+                "Can not reallocate immutable buffer storage");
+
+        if (size > capacity || usage != this->usage) {
+            // Grow geometrically so a slowly growing buffer is not
+            // reallocated on every update
+            GLsizeiptr newCapacity = size;
+            if (capacity > 0 && size > capacity)
+                newCapacity = std::max(size, 2 * capacity);
+
+            if (newCapacity == size) {
+                storeData(size, data, usage);
+            }
+            else {
+                storeData(newCapacity, nullptr, usage);
+                if (data)
+                    bufferSubData(0, size, data);
+            }
+            capacity = newCapacity;
+            this->usage = usage;
+            reallocations++;
+            trackMemory();
+        }
+        else {
+            // Orphan the old storage instead of waiting for pending draws
+            if (usage != Static)
+                storeData(capacity, nullptr, usage);
+            if (data)
+                bufferSubData(0, size, data);
+        }
+        this->size = size;
     }
 
     void Buffer::bufferSubData(GLintptr offset, GLsizeiptr size, const void * data) {
+        if (immutable)
+            throw BufferException(
+                "Can not write immutable buffer storage, map it instead");
+
+        if (StateCache::current().hasDirectStateAccess()) {
+            glNamedBufferSubData(buffer, offset, size, data);
+            return;
+        }
         bind();
         glBufferSubData(target, offset, size, data);
     }
 }
 
+namespace glpp {
+    ElementBuffer::ElementBuffer()
+        : Buffer(Index), count(0), type(GL_UNSIGNED_INT) {}
+
+    ElementBuffer::ElementBuffer(ElementBuffer && other)
+        : Buffer(std::move(other)), count(other.count), type(other.type) {}
+
+    ElementBuffer & ElementBuffer::operator=(ElementBuffer && other) {
+        Buffer::operator=(std::move(other));
+        count = other.count;
+        type = other.type;
+        return *this;
+    }
+
+    ElementBuffer::~ElementBuffer() {}
+
+    GLsizei ElementBuffer::getCount() const {
+        return count;
+    }
+
+    GLenum ElementBuffer::getType() const {
+        return type;
+    }
+
+    void ElementBuffer::bufferElements(const vector<GLuint> & indices, Usage usage) {
+        GLuint maxIndex = 0;
+        for (GLuint index : indices) {
+            maxIndex = std::max(maxIndex, index);
+        }
+
+        GLenum type = typeFor(maxIndex);
+        GLsizeiptr size = indices.size() * typeSize(type);
+        if (type == GL_UNSIGNED_BYTE) {
+            vector<GLubyte> narrow(indices.begin(), indices.end());
+            bufferElements(size, narrow.data(), type, usage);
+        }
+        else if (type == GL_UNSIGNED_SHORT) {
+            vector<GLushort> narrow(indices.begin(), indices.end());
+            bufferElements(size, narrow.data(), type, usage);
+        }
+        else {
+            bufferElements(size, indices.data(), type, usage);
+        }
+    }
+
+    void ElementBuffer::bufferElements(GLsizeiptr size,
+                                       const void * data,
+                                       GLenum type,
+                                       Usage usage) {
+        bufferData(size, data, usage);
+        this->count = size / typeSize(type);
+        this->type = type;
+    }
+
+    GLenum ElementBuffer::typeFor(GLuint maxIndex) {
+        if (maxIndex <= 0xFF)
+            return GL_UNSIGNED_BYTE;
+        if (maxIndex <= 0xFFFF)
+            return GL_UNSIGNED_SHORT;
+        return GL_UNSIGNED_INT;
+    }
+
+    GLsizeiptr ElementBuffer::typeSize(GLenum type) {
+        switch (type) {
+            case GL_UNSIGNED_BYTE:
+                return 1;
+            case GL_UNSIGNED_SHORT:
+                return 2;
+            default:
+                return 4;
+        }
+    }
+}
+
 namespace glpp {
     using std::make_shared;
 
@@ -125,7 +375,7 @@ namespace glpp {
 
         bind();
         this->buffers = std::move(buffers);
-        for (auto & buff : buffers) {
+        for (auto & buff : this->buffers) {
             buff->bind();
             buff->attach();
         }
@@ -148,8 +398,11 @@ namespace glpp {
     }
 
     BufferArray::~BufferArray() {
-        if (array)
+        if (array) {
+            if (auto cache = StateCache::existing())
+                cache->deleteVertexArray(array);
             glDeleteVertexArrays(1, &array);
+        }
     }
 
     GLuint BufferArray::getArrayId() const {
@@ -177,17 +430,47 @@ namespace glpp {
     }
 
     void BufferArray::bind() const {
-        glBindVertexArray(array);
+        StateCache::current().bindVertexArray(array);
     }
 
     void BufferArray::unbind() {
-        glBindVertexArray(0);
+        StateCache::current().bindVertexArray(0);
     }
 
-    void BufferArray::bufferElements(GLsizeiptr size, const void * data, Usage usage) {
+    void BufferArray::attach(const Buffer & buffer,
+                             const vector<Buffer::Attribute> & attributes,
+                             GLintptr offset) {
+        bind();
+        buffer.bind();
+        for (auto attr : attributes) {
+            attr.pointer = static_cast<const char *>(attr.pointer) + offset;
+            attr.enable();
+        }
+    }
+
+    void BufferArray::bufferElements(GLsizeiptr size,
+                                     const void * data,
+                                     Usage usage,
+                                     GLenum type) {
         if (!elementBuffer)
-            elementBuffer = std::make_unique<Buffer>(Buffer::Index);
-        elementBuffer->bufferData(size, data, usage);
+            elementBuffer = make_shared<ElementBuffer>();
+        // The element buffer binding is vertex array state, bind it here
+        // because bufferData does not bind with direct state access
+        bind();
+        elementBuffer->bind();
+        elementBuffer->bufferElements(size, data, type, usage);
+    }
+
+    void BufferArray::bufferElements(const vector<GLuint> & indices, Usage usage) {
+        if (!elementBuffer)
+            elementBuffer = make_shared<ElementBuffer>();
+        bind();
+        elementBuffer->bind();
+        elementBuffer->bufferElements(indices, usage);
+    }
+
+    const ElementBuffer::Ptr & BufferArray::getElementBuffer() const {
+        return elementBuffer;
     }
 
     void BufferArray::drawArrays(Mode mode, GLint first, GLsizei count) const {
@@ -211,6 +494,12 @@ namespace glpp {
         glDrawElements(mode, count, type, indices);
     }
 
+    void BufferArray::drawElements(Mode mode) const {
+        if (elementBuffer)
+            drawElements(mode, elementBuffer->getCount(),
+                         elementBuffer->getType(), nullptr);
+    }
+
     void BufferArray::drawElementsInstanced(Mode mode,
                                             GLsizei count,
                                             GLenum type,
@@ -219,4 +508,68 @@ namespace glpp {
         bind();
         glDrawElementsInstanced(mode, count, type, indices, primcount);
     }
+
+    void BufferArray::drawElementsInstanced(Mode mode, GLsizei primcount) const {
+        if (elementBuffer)
+            drawElementsInstanced(mode, elementBuffer->getCount(),
+                                  elementBuffer->getType(), nullptr, primcount);
+    }
+
+    void BufferArray::multiDrawArraysIndirect(Mode mode,
+                                              IndirectCommandBuffer & commands) const {
+        auto & cmds = commands.getArrayCommands();
+        if (cmds.empty())
+            return;
+
+        bind();
+        if (IndirectCommandBuffer::isSupported()) {
+            commands.upload();
+            commands.bind();
+            glMultiDrawArraysIndirect(mode, nullptr, cmds.size(), 0);
+            return;
+        }
+
+        for (auto & cmd : cmds) {
+            if (cmd.baseInstance > 0 && GLEW_VERSION_4_2)
+                glDrawArraysInstancedBaseInstance(mode, cmd.first, cmd.count,
+                                                  cmd.instanceCount,
+                                                  cmd.baseInstance);
+            else
+                glDrawArraysInstanced(mode, cmd.first, cmd.count,
+                                      cmd.instanceCount);
+        }
+    }
+
+    void BufferArray::multiDrawElementsIndirect(Mode mode,
+                                                GLenum type,
+                                                IndirectCommandBuffer & commands) const {
+        auto & cmds = commands.getElementCommands();
+        if (cmds.empty())
+            return;
+
+        bind();
+        if (IndirectCommandBuffer::isSupported()) {
+            commands.upload();
+            commands.bind();
+            glMultiDrawElementsIndirect(mode, type,
+                                        (void *)commands.getElementOffset(),
+                                        cmds.size(), 0);
+            return;
+        }
+
+        std::size_t indexSize = type == GL_UNSIGNED_BYTE    ? 1
+                                : type == GL_UNSIGNED_SHORT ? 2
+                                                            : 4;
+        for (auto & cmd : cmds) {
+            void * indices = (void *)(cmd.firstIndex * indexSize);
+            if (cmd.baseInstance > 0 && GLEW_VERSION_4_2)
+                glDrawElementsInstancedBaseVertexBaseInstance(
+                    mode, cmd.count, type, indices, cmd.instanceCount,
+                    cmd.baseVertex, cmd.baseInstance);
+            else
+                glDrawElementsInstancedBaseVertex(mode, cmd.count, type, indices,
+                                                  cmd.instanceCount,
+                                                  cmd.baseVertex);
+        }
+    }
 }
@@ -0,0 +1,238 @@
+#include "glpp/BufferArena.hpp"
+
+#include <algorithm>
+
+#include "glpp/StateCache.hpp"
+#include "glpp/VertexArrayCache.hpp"
+
+namespace glpp {
+    /**
+     * Round offset up to the next multiple of alignment.
+     *
+     * @param offset the offset to align
+     * @param alignment the alignment in bytes
+     *
+     * @return the aligned offset
+     */
+    static GLintptr alignUp(GLintptr offset, GLsizeiptr alignment) {
+        if (alignment <= 1 || offset % alignment == 0)
+            return offset;
+        return offset + alignment - offset % alignment;
+    }
+
+    void BufferArena::Block::bufferSubData(GLintptr offset,
+                                           GLsizeiptr size,
+                                           const void * data) const {
+        buffer->bufferSubData(this->offset + offset, size, data);
+    }
+}
+
+namespace glpp {
+    using std::make_shared;
+
+    BufferArena::BufferArena(GLsizeiptr pageSize, Buffer::Usage usage)
+        : pages(make_shared<vector<Page>>()),
+          pageSize(pageSize),
+          usage(usage) {}
+
+    BufferArena::~BufferArena() {}
+
+    GLsizeiptr BufferArena::getPageSize() const {
+        return pageSize;
+    }
+
+    std::size_t BufferArena::getPageCount() const {
+        return pages->size();
+    }
+
+    GLsizeiptr BufferArena::getCapacity() const {
+        GLsizeiptr total = 0;
+        for (auto & page : *pages) {
+            total += page.size;
+        }
+        return total;
+    }
+
+    GLsizeiptr BufferArena::getAllocated() const {
+        GLsizeiptr total = 0;
+        for (auto & page : *pages) {
+            for (auto * block : page.blocks) {
+                total += block->size;
+            }
+        }
+        return total;
+    }
+
+    std::size_t BufferArena::getBlockCount() const {
+        std::size_t count = 0;
+        for (auto & page : *pages) {
+            count += page.blocks.size();
+        }
+        return count;
+    }
+
+    std::size_t BufferArena::addPage(GLsizeiptr size) {
+        Page page;
+        page.buffer = make_shared<Buffer>(Buffer::Array);
+        page.buffer->bufferData(size, nullptr, usage);
+        page.size = size;
+        page.freeList[0] = size;
+        pages->push_back(std::move(page));
+        return pages->size() - 1;
+    }
+
+    void BufferArena::release(vector<Page> & pages, Block * block) {
+        Page & page = pages[block->page];
+
+        // Vertex arrays keyed to the block offset would never be used again
+        if (auto cache = VertexArrayCache::existing())
+            cache->releaseRange(page.buffer->getBufferId(), block->offset,
+                                block->size);
+
+        auto blockIt = std::find(page.blocks.begin(), page.blocks.end(), block);
+        if (blockIt != page.blocks.end())
+            page.blocks.erase(blockIt);
+
+        auto it = page.freeList.emplace(block->offset, block->size).first;
+
+        // Merge with the following free range
+        auto next = std::next(it);
+        if (next != page.freeList.end() && it->first + it->second == next->first) {
+            it->second += next->second;
+            page.freeList.erase(next);
+        }
+
+        // Merge with the preceding free range
+        if (it != page.freeList.begin()) {
+            auto prev = std::prev(it);
+            if (prev->first + prev->second == it->first) {
+                prev->second += it->second;
+                page.freeList.erase(it);
+            }
+        }
+    }
+
+    BufferArena::Allocation BufferArena::allocate(GLsizeiptr size,
+                                                  GLsizeiptr alignment) {
+        if (size < 1)
+            size = 1;
+
+        std::size_t pageIndex = pages->size();
+        GLintptr start = 0;
+        for (std::size_t i = 0; i < pages->size() && pageIndex == pages->size(); i++) {
+            for (auto & range : (*pages)[i].freeList) {
+                start = alignUp(range.first, alignment);
+                if (start + size <= range.first + range.second) {
+                    pageIndex = i;
+                    break;
+                }
+            }
+        }
+
+        if (pageIndex == pages->size()) {
+            pageIndex = addPage(std::max(pageSize, alignUp(size, alignment)));
+            start = 0;
+        }
+
+        Page & page = (*pages)[pageIndex];
+
+        // Split the free range around the new block
+        auto it = std::prev(page.freeList.upper_bound(start));
+        GLintptr rangeStart = it->first;
+        GLintptr rangeEnd = it->first + it->second;
+        page.freeList.erase(it);
+        if (start > rangeStart)
+            page.freeList[rangeStart] = start - rangeStart;
+        if (start + size < rangeEnd)
+            page.freeList[start + size] = rangeEnd - (start + size);
+
+        Block * block =
+            new Block {page.buffer, start, size, alignment, 0, pageIndex};
+        page.blocks.push_back(block);
+
+        std::weak_ptr<vector<Page>> weakPages = pages;
+        return Allocation(block, [weakPages](Block * block) {
+            if (auto pages = weakPages.lock())
+                release(*pages, block);
+            delete block;
+        });
+    }
+
+    void BufferArena::defragment() {
+        for (auto & page : *pages) {
+            std::sort(page.blocks.begin(), page.blocks.end(),
+                      [](const Block * a, const Block * b) {
+                          return a->offset < b->offset;
+                      });
+
+            vector<GLintptr> offsets;
+            GLintptr cursor = 0;
+            bool moved = false;
+            for (auto * block : page.blocks) {
+                GLintptr offset = alignUp(cursor, block->alignment);
+                offsets.push_back(offset);
+                moved |= offset != block->offset;
+                cursor = offset + block->size;
+            }
+
+            if (!moved)
+                continue;
+
+            // Source and destination ranges in the same buffer may not
+            // overlap, so pack the blocks into a temporary buffer first.
+            Buffer temp(Buffer::CopyWrite);
+            temp.bufferData(cursor, nullptr, Buffer::Stream);
+
+            auto & cache = StateCache::current();
+            if (cache.hasDirectStateAccess()) {
+                GLuint pageId = page.buffer->getBufferId();
+                for (std::size_t i = 0; i < page.blocks.size(); i++) {
+                    Block * block = page.blocks[i];
+                    glCopyNamedBufferSubData(pageId, temp.getBufferId(),
+                                             block->offset, offsets[i],
+                                             block->size);
+                }
+                glCopyNamedBufferSubData(temp.getBufferId(), pageId, 0, 0, cursor);
+            }
+            else {
+                temp.bind();
+                cache.bindBuffer(GL_COPY_READ_BUFFER, page.buffer->getBufferId());
+                for (std::size_t i = 0; i < page.blocks.size(); i++) {
+                    Block * block = page.blocks[i];
+                    glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER,
+                                        block->offset, offsets[i], block->size);
+                }
+
+                cache.bindBuffer(GL_COPY_READ_BUFFER, temp.getBufferId());
+                cache.bindBuffer(GL_COPY_WRITE_BUFFER, page.buffer->getBufferId());
+                glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER,
+                                    0, 0, cursor);
+            }
+
+            auto * arrays = VertexArrayCache::existing();
+            for (std::size_t i = 0; i < page.blocks.size(); i++) {
+                Block * block = page.blocks[i];
+                if (block->offset != offsets[i]) {
+                    if (arrays)
+                        arrays->releaseRange(page.buffer->getBufferId(),
+                                             block->offset, block->size);
+                    block->offset = offsets[i];
+                    block->version++;
+                }
+            }
+
+            page.freeList.clear();
+            if (cursor < page.size)
+                page.freeList[cursor] = page.size - cursor;
+        }
+    }
+
+    void BufferArena::clear() {
+        pages = make_shared<vector<Page>>();
+    }
+
+    BufferArena & BufferArena::current() {
+        thread_local BufferArena arena;
+        return arena;
+    }
+}
@@ -2,10 +2,16 @@
 
 #include <stdexcept>
 
+#include "glpp/ResourceTracker.hpp"
+#include "glpp/StateCache.hpp"
+
 namespace glpp {
     RenderBuffer::RenderBuffer(const glm::uvec2 & size, GLenum internal, GLsizei samples)
         : internal(internal), size(size), samples(samples) {
-        glGenRenderbuffers(1, &buffer);
+        if (StateCache::current().hasDirectStateAccess())
+            glCreateRenderbuffers(1, &buffer);
+        else
+            glGenRenderbuffers(1, &buffer);
         resize(size);
     }
 
@@ -23,8 +29,13 @@ namespace glpp {
     }
 
     RenderBuffer::~RenderBuffer() {
-        if (buffer)
+        if (buffer) {
+            if (auto cache = StateCache::existing())
+                cache->deleteRenderBuffer(buffer);
+            ResourceTracker::getDefault().untrack(
+                ResourceTracker::RenderBufferMemory, buffer);
             glDeleteRenderbuffers(1, &buffer);
+        }
     }
 
     GLuint RenderBuffer::getBufferId() const {
@@ -41,6 +52,20 @@ namespace glpp {
 
     void RenderBuffer::resize(const glm::uvec2 & size) {
         this->size = size;
+        ResourceTracker::getDefault().track(
+            {ResourceTracker::RenderBufferMemory, buffer, GL_RENDERBUFFER, 0,
+             internal, GLsizei(size.x), GLsizei(size.y), samples, 1,
+             ResourceTracker::imageSize(internal, size.x, size.y, 1, samples)});
+
+        if (StateCache::current().hasDirectStateAccess()) {
+            if (samples > 0)
+                glNamedRenderbufferStorageMultisample(buffer, samples, internal,
+                                                      size.x, size.y);
+            else
+                glNamedRenderbufferStorage(buffer, internal, size.x, size.y);
+            return;
+        }
+
         bind();
         if (samples > 0)
             glRenderbufferStorageMultisample(GL_RENDERBUFFER,
@@ -53,11 +78,171 @@ namespace glpp {
     }
 
     void RenderBuffer::bind() const {
-        glBindRenderbuffer(GL_RENDERBUFFER, buffer);
+        StateCache::current().bindRenderBuffer(buffer);
     }
 
     void RenderBuffer::unbind() const {
-        glBindRenderbuffer(GL_RENDERBUFFER, 0);
+        StateCache::current().bindRenderBuffer(0);
+    }
+}
+
+namespace glpp {
+    /**
+     * Get the size in bytes of one pixel.
+     *
+     * @param format the pixel format
+     * @param type the pixel data type
+     *
+     * @return the pixel size
+     */
+    static GLsizeiptr pixelSize(GLenum format, GLenum type) {
+        switch (type) {
+            case GL_UNSIGNED_INT_24_8:
+            case GL_UNSIGNED_INT_8_8_8_8:
+            case GL_UNSIGNED_INT_8_8_8_8_REV:
+            case GL_UNSIGNED_INT_2_10_10_10_REV:
+            case GL_UNSIGNED_INT_10F_11F_11F_REV:
+                return 4;
+            case GL_UNSIGNED_SHORT_5_6_5:
+            case GL_UNSIGNED_SHORT_4_4_4_4:
+            case GL_UNSIGNED_SHORT_5_5_5_1:
+                return 2;
+        }
+
+        GLsizeiptr components = 1;
+        switch (format) {
+            case GL_RG:
+            case GL_RG_INTEGER:
+            case GL_DEPTH_STENCIL:
+                components = 2;
+                break;
+            case GL_RGB:
+            case GL_BGR:
+            case GL_RGB_INTEGER:
+                components = 3;
+                break;
+            case GL_RGBA:
+            case GL_BGRA:
+            case GL_RGBA_INTEGER:
+                components = 4;
+                break;
+        }
+
+        switch (type) {
+            case GL_UNSIGNED_SHORT:
+            case GL_SHORT:
+            case GL_HALF_FLOAT:
+                return components * 2;
+            case GL_UNSIGNED_INT:
+            case GL_INT:
+            case GL_FLOAT:
+                return components * 4;
+            default:
+                return components;
+        }
+    }
+
+    PixelReadback::PixelReadback(const Buffer::Ptr & buffer,
+                                 GLsync fence,
+                                 const glm::uvec4 & rect,
+                                 GLsizeiptr rowSize)
+        : buffer(buffer),
+          fence(fence),
+          rect(rect),
+          rowSize(rowSize),
+          mapped(nullptr) {}
+
+    PixelReadback::PixelReadback(PixelReadback && other)
+        : buffer(std::move(other.buffer)),
+          fence(other.fence),
+          rect(other.rect),
+          rowSize(other.rowSize),
+          mapped(other.mapped) {
+        other.fence = 0;
+        other.mapped = nullptr;
+    }
+
+    PixelReadback & PixelReadback::operator=(PixelReadback && other) {
+        unmap();
+        if (fence)
+            glDeleteSync(fence);
+        buffer = std::move(other.buffer);
+        fence = other.fence;
+        rect = other.rect;
+        rowSize = other.rowSize;
+        mapped = other.mapped;
+        other.fence = 0;
+        other.mapped = nullptr;
+        return *this;
+    }
+
+    PixelReadback::~PixelReadback() {
+        unmap();
+        if (fence)
+            glDeleteSync(fence);
+    }
+
+    const glm::uvec4 & PixelReadback::getRect() const {
+        return rect;
+    }
+
+    GLsizeiptr PixelReadback::getRowSize() const {
+        return rowSize;
+    }
+
+    GLsizeiptr PixelReadback::getSize() const {
+        return rowSize * rect.w;
+    }
+
+    bool PixelReadback::isReady() {
+        return wait(0);
+    }
+
+    bool PixelReadback::wait(GLuint64 timeout) {
+        if (!fence)
+            return true;
+
+        GLenum status =
+            glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, timeout);
+        if (status == GL_TIMEOUT_EXPIRED || status == GL_WAIT_FAILED)
+            return false;
+
+        glDeleteSync(fence);
+        fence = 0;
+        return true;
+    }
+
+    const void * PixelReadback::map() {
+        if (mapped)
+            return mapped;
+
+        wait();
+        if (StateCache::current().hasDirectStateAccess()) {
+            mapped = glMapNamedBufferRange(buffer->getBufferId(), 0, getSize(),
+                                           GL_MAP_READ_BIT);
+        }
+        else {
+            buffer->bind();
+            mapped = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, getSize(),
+                                      GL_MAP_READ_BIT);
+            buffer->unbind();
+        }
+        return mapped;
+    }
+
+    void PixelReadback::unmap() {
+        if (!mapped)
+            return;
+
+        if (StateCache::current().hasDirectStateAccess()) {
+            glUnmapNamedBuffer(buffer->getBufferId());
+        }
+        else {
+            buffer->bind();
+            glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+            buffer->unbind();
+        }
+        mapped = nullptr;
     }
 }
 
@@ -78,15 +263,23 @@ namespace glpp {
 }
 
 namespace glpp {
-    FrameBuffer::FrameBuffer(const glm::uvec2 & size) : size(size) {
-        glGenFramebuffers(1, &buffer);
-        bind();
+    FrameBuffer::FrameBuffer(const glm::uvec2 & size)
+        : size(size), nextReadBuffer(0) {
+        if (StateCache::current().hasDirectStateAccess()) {
+            glCreateFramebuffers(1, &buffer);
+        }
+        else {
+            glGenFramebuffers(1, &buffer);
+            bind();
+        }
     }
 
     FrameBuffer::FrameBuffer(FrameBuffer && other)
         : buffer(other.buffer),
           attachments(std::move(other.attachments)),
-          size(other.size) {
+          size(other.size),
+          readBuffers(std::move(other.readBuffers)),
+          nextReadBuffer(other.nextReadBuffer) {
         other.buffer = 0;
     }
 
@@ -95,15 +288,23 @@ namespace glpp {
         other.buffer = 0;
         attachments = std::move(other.attachments);
         size = other.size;
+        readBuffers = std::move(other.readBuffers);
+        nextReadBuffer = other.nextReadBuffer;
         return *this;
     }
 
     FrameBuffer::~FrameBuffer() {
-        if (buffer)
+        if (buffer) {
+            if (auto cache = StateCache::existing())
+                cache->deleteFrameBuffer(buffer);
             glDeleteFramebuffers(1, &buffer);
+        }
     }
 
     bool FrameBuffer::isComplete() const {
+        if (StateCache::current().hasDirectStateAccess())
+            return glCheckNamedFramebufferStatus(buffer, GL_FRAMEBUFFER)
+                   == GL_FRAMEBUFFER_COMPLETE;
         bind();
         return glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
     }
@@ -117,10 +318,20 @@ namespace glpp {
             texture->resize(size);
 
         attachments.emplace_back(texture, attachment);
+        attachTexture(attachments.back());
+    }
+
+    void FrameBuffer::attachTexture(const Attachment & att) const {
+        if (StateCache::current().hasDirectStateAccess()) {
+            glNamedFramebufferTexture(buffer, att.attachment,
+                                      att.texture->getTextureId(), 0);
+            return;
+        }
+        bind();
         glFramebufferTexture2D(GL_FRAMEBUFFER,
-                               attachment,
-                               texture->getTarget(),
-                               texture->getTextureId(),
+                               att.attachment,
+                               att.texture->getTarget(),
+                               att.texture->getTextureId(),
                                0);
     }
 
@@ -129,10 +340,6 @@ namespace glpp {
             buffer->resize(size);
 
         attachments.emplace_back(buffer, attachment);
-        glFramebufferRenderbuffer(GL_FRAMEBUFFER,
-                                  attachment,
-                                  GL_RENDERBUFFER,
-                                  buffer->getBufferId());
 
         vector<GLenum> attrs;
         for (auto & att : attachments) {
@@ -140,6 +347,21 @@ namespace glpp {
                 continue;
             attrs.push_back(att.attachment);
         }
+
+        if (StateCache::current().hasDirectStateAccess()) {
+            glNamedFramebufferRenderbuffer(this->buffer, attachment,
+                                           GL_RENDERBUFFER,
+                                           buffer->getBufferId());
+            glNamedFramebufferDrawBuffers(this->buffer, attrs.size(),
+                                          attrs.data());
+            return;
+        }
+
+        bind();
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER,
+                                  attachment,
+                                  GL_RENDERBUFFER,
+                                  buffer->getBufferId());
         glDrawBuffers(attrs.size(), attrs.data());
     }
 
@@ -151,10 +373,28 @@ namespace glpp {
         return size;
     }
 
+    std::size_t FrameBuffer::getMemoryUsage() const {
+        auto & tracker = ResourceTracker::getDefault();
+        std::size_t bytes = 0;
+        for (auto & att : attachments) {
+            if (att.type == Attachment::TEXTURE)
+                bytes += tracker.getBytes(ResourceTracker::TextureMemory,
+                                          att.texture->getTextureId());
+            else
+                bytes += tracker.getBytes(ResourceTracker::RenderBufferMemory,
+                                          att.buffer->getBufferId());
+        }
+        return bytes;
+    }
+
     void FrameBuffer::resize(const glm::uvec2 & size) {
         this->size = size;
         for (auto & att : attachments) {
             att.resize(size);
+            // Textures with immutable storage are replaced when resized
+            if (att.type == Attachment::TEXTURE
+                && StateCache::current().hasDirectStateAccess())
+                attachTexture(att);
         }
     }
 
@@ -185,8 +425,37 @@ namespace glpp {
                           mask, filter);
     }
 
+    PixelReadback FrameBuffer::readPixelsAsync(const glm::uvec4 & rect,
+                                               GLenum format,
+                                               GLenum type,
+                                               GLenum attachment) {
+        GLsizeiptr rowSize = rect.z * pixelSize(format, type);
+        rowSize = (rowSize + 3) / 4 * 4;
+
+        if (readBuffers.size() < readBufferCount)
+            readBuffers.resize(readBufferCount);
+        Buffer::Ptr & readBuffer = readBuffers[nextReadBuffer];
+        nextReadBuffer = (nextReadBuffer + 1) % readBufferCount;
+
+        // Keep the pixels of a handle that was not released yet
+        if (!readBuffer || readBuffer.use_count() > 1)
+            readBuffer = std::make_shared<Buffer>(Buffer::PixelPack);
+        readBuffer->bufferData(rowSize * rect.w, nullptr, Buffer::StreamRead);
+
+        bind(GL_READ_FRAMEBUFFER);
+        if (buffer)
+            glReadBuffer(attachment);
+        readBuffer->bind();
+        glReadPixels(rect.x, rect.y, rect.z, rect.w, format, type, nullptr);
+        // Reads into client memory fail while a PixelPack buffer is bound
+        readBuffer->unbind();
+
+        GLsync fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        return PixelReadback(readBuffer, fence, rect, rowSize);
+    }
+
     void FrameBuffer::bind(GLenum target) const {
-        glBindFramebuffer(target, buffer);
+        StateCache::current().bindFrameBuffer(target, buffer);
     }
 
     void FrameBuffer::setViewport() const {
@@ -194,7 +463,7 @@ namespace glpp {
     }
 
     void FrameBuffer::unbind() {
-        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        StateCache::current().bindFrameBuffer(GL_FRAMEBUFFER, 0);
     }
 
     void FrameBuffer::clear(GLbitfield mask) {
@@ -0,0 +1,80 @@
+#include "glpp/IndirectCommandBuffer.hpp"
+
+namespace glpp {
+    IndirectCommandBuffer::IndirectCommandBuffer(Usage usage)
+        : Buffer(DrawIndirect), dirty(false) {
+        reserve(0, usage);
+    }
+
+    IndirectCommandBuffer::IndirectCommandBuffer(IndirectCommandBuffer && other)
+        : Buffer(std::move(other)),
+          arrays(std::move(other.arrays)),
+          elements(std::move(other.elements)),
+          dirty(other.dirty) {}
+
+    IndirectCommandBuffer & IndirectCommandBuffer::operator=(
+        IndirectCommandBuffer && other) {
+        Buffer::operator=(std::move(other));
+        arrays = std::move(other.arrays);
+        elements = std::move(other.elements);
+        dirty = other.dirty;
+        return *this;
+    }
+
+    IndirectCommandBuffer::~IndirectCommandBuffer() {}
+
+    void IndirectCommandBuffer::addArrays(GLuint count,
+                                          GLuint first,
+                                          GLuint instanceCount,
+                                          GLuint baseInstance) {
+        arrays.push_back({count, instanceCount, first, baseInstance});
+        dirty = true;
+    }
+
+    void IndirectCommandBuffer::addElements(GLuint count,
+                                            GLuint firstIndex,
+                                            GLint baseVertex,
+                                            GLuint instanceCount,
+                                            GLuint baseInstance) {
+        elements.push_back(
+            {count, instanceCount, firstIndex, baseVertex, baseInstance});
+        dirty = true;
+    }
+
+    void IndirectCommandBuffer::clear() {
+        arrays.clear();
+        elements.clear();
+        dirty = true;
+    }
+
+    const vector<DrawArraysIndirectCommand> & IndirectCommandBuffer::getArrayCommands() const {
+        return arrays;
+    }
+
+    const vector<DrawElementsIndirectCommand> & IndirectCommandBuffer::getElementCommands() const {
+        return elements;
+    }
+
+    GLintptr IndirectCommandBuffer::getElementOffset() const {
+        return arrays.size() * sizeof(DrawArraysIndirectCommand);
+    }
+
+    void IndirectCommandBuffer::upload() {
+        if (!dirty)
+            return;
+
+        // The command buffer is only read by OpenGL 4.3 multi draw
+        if (isSupported()) {
+            GLsizeiptr elementsSize =
+                elements.size() * sizeof(DrawElementsIndirectCommand);
+            bufferData(getElementOffset() + elementsSize, nullptr, getUsage());
+            bufferSubData(0, getElementOffset(), arrays.data());
+            bufferSubData(getElementOffset(), elementsSize, elements.data());
+        }
+        dirty = false;
+    }
+
+    bool IndirectCommandBuffer::isSupported() {
+        return GLEW_VERSION_4_3 || GLEW_ARB_multi_draw_indirect;
+    }
+}
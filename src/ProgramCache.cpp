@@ -0,0 +1,234 @@
+#include "glpp/ProgramCache.hpp"
+
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <sstream>
+#include <system_error>
+#include <thread>
+
+namespace glpp {
+    /**
+     * Header at the start of each cache file, followed by the binary.
+     */
+    struct BinaryHeader {
+        char magic[4];
+        std::uint32_t version;
+        std::uint64_t key;
+        std::uint32_t format;
+        std::uint32_t length;
+    };
+
+    static constexpr char binaryMagic[4] = {'G', 'L', 'P', 'B'};
+    static constexpr std::uint32_t binaryVersion = 1;
+
+    /**
+     * Hash the bytes of value.
+     *
+     * @param value the value to hash
+     * @param seed the hash of previous data
+     *
+     * @return the hash
+     */
+    template<typename T>
+    static std::uint64_t hashValue(const T & value, std::uint64_t seed) {
+        return ProgramCache::hash(
+            string_view(reinterpret_cast<const char *>(&value), sizeof(T)),
+            seed);
+    }
+
+    /**
+     * Hash the length of data followed by data, so the end of one string
+     * can not be confused with the start of the next.
+     *
+     * @param data the string to hash
+     * @param seed the hash of previous data
+     *
+     * @return the hash
+     */
+    static std::uint64_t hashString(string_view data, std::uint64_t seed) {
+        seed = hashValue(std::uint64_t(data.size()), seed);
+        return ProgramCache::hash(data, seed);
+    }
+
+    ProgramCache::ProgramCache(const std::filesystem::path & directory)
+        : directory(directory) {
+        std::filesystem::create_directories(directory);
+    }
+
+    const std::filesystem::path & ProgramCache::getDirectory() const {
+        return directory;
+    }
+
+    std::uint64_t ProgramCache::key(const vector<string_view> & sources,
+                                    const vector<string> & varyings,
+                                    GLenum bufferMode) const {
+        std::uint64_t seed = hashBasis;
+        for (GLenum name : {GL_VENDOR, GL_RENDERER, GL_VERSION}) {
+            auto * value = reinterpret_cast<const char *>(glGetString(name));
+            seed = hashString(value ? value : "", seed);
+        }
+
+        seed = hashValue(std::uint64_t(sources.size()), seed);
+        for (auto & source : sources) {
+            seed = hashString(source, seed);
+        }
+
+        seed = hashValue(std::uint64_t(varyings.size()), seed);
+        for (auto & name : varyings) {
+            seed = hashString(name, seed);
+        }
+        if (!varyings.empty())
+            seed = hashValue(bufferMode, seed);
+        return seed;
+    }
+
+    std::filesystem::path ProgramCache::pathOf(std::uint64_t key) const {
+        std::ostringstream name;
+        name << std::hex << std::setw(16) << std::setfill('0') << key << ".bin";
+        return directory / name.str();
+    }
+
+    GLuint ProgramCache::load(std::uint64_t key) {
+        auto path = pathOf(key);
+        std::ifstream is(path, std::ios::binary);
+        if (!is) {
+            std::lock_guard<std::mutex> lock(mutex);
+            counters.misses++;
+            return 0;
+        }
+
+        BinaryHeader header;
+        vector<char> binary;
+        is.read(reinterpret_cast<char *>(&header), sizeof(header));
+        bool valid = is && std::memcmp(header.magic, binaryMagic, 4) == 0
+                     && header.version == binaryVersion && header.key == key
+                     && header.length > 0;
+        if (valid) {
+            // Check the length before allocating it, the file may be corrupt
+            std::error_code error;
+            auto fileSize = std::filesystem::file_size(path, error);
+            valid = !error && fileSize >= sizeof(header)
+                    && fileSize - sizeof(header) == header.length;
+        }
+        if (valid) {
+            binary.resize(header.length);
+            is.read(binary.data(), header.length);
+            valid = bool(is);
+        }
+        is.close();
+
+        GLuint program = 0;
+        if (valid) {
+            program = glCreateProgram();
+            glProgramBinary(program, header.format, binary.data(), header.length);
+
+            // The driver may reject binaries from a different build
+            GLint success = 0;
+            glGetProgramiv(program, GL_LINK_STATUS, &success);
+            if (success == GL_FALSE) {
+                glDeleteProgram(program);
+                program = 0;
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(mutex);
+        if (program) {
+            counters.hits++;
+        }
+        else {
+            counters.misses++;
+            counters.rejected++;
+            std::error_code error;
+            std::filesystem::remove(path, error);
+        }
+        return program;
+    }
+
+    bool ProgramCache::store(std::uint64_t key, GLuint program) {
+        GLint length = 0;
+        glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+        if (length <= 0)
+            return false;
+
+        BinaryHeader header;
+        std::memcpy(header.magic, binaryMagic, 4);
+        header.version = binaryVersion;
+        header.key = key;
+
+        vector<char> binary(length);
+        GLenum format = 0;
+        glGetProgramBinary(program, length, &length, &format, binary.data());
+        if (length <= 0)
+            return false;
+        header.format = format;
+        header.length = length;
+
+        // Write to a temporary file and rename it so a crash or another
+        // thread never leaves a partial binary under the final name
+        auto path = pathOf(key);
+        auto tmpPath = path;
+        tmpPath += "." + std::to_string(std::hash<std::thread::id>()(
+                             std::this_thread::get_id()))
+                   + ".tmp";
+        {
+            std::ofstream os(tmpPath, std::ios::binary | std::ios::trunc);
+            os.write(reinterpret_cast<const char *>(&header), sizeof(header));
+            os.write(binary.data(), length);
+            if (!os) {
+                os.close();
+                std::error_code error;
+                std::filesystem::remove(tmpPath, error);
+                return false;
+            }
+        }
+
+        std::error_code error;
+        std::filesystem::rename(tmpPath, path, error);
+        if (error) {
+            std::filesystem::remove(tmpPath, error);
+            return false;
+        }
+        return true;
+    }
+
+    void ProgramCache::clear() {
+        std::error_code error;
+        for (auto & entry : std::filesystem::directory_iterator(directory, error)) {
+            if (entry.path().extension() == ".bin")
+                std::filesystem::remove(entry.path(), error);
+        }
+    }
+
+    ProgramCache::Counters ProgramCache::getCounters() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return counters;
+    }
+
+    void ProgramCache::resetCounters() {
+        std::lock_guard<std::mutex> lock(mutex);
+        counters = Counters();
+    }
+
+    bool ProgramCache::isSupported() {
+        if (!(GLEW_VERSION_4_1 || GLEW_ARB_get_program_binary))
+            return false;
+        GLint formats = 0;
+        glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+        return formats > 0;
+    }
+
+    static std::mutex defaultMutex;
+    static ProgramCache::Ptr defaultCache;
+
+    ProgramCache::Ptr ProgramCache::getDefault() {
+        std::lock_guard<std::mutex> lock(defaultMutex);
+        return defaultCache;
+    }
+
+    void ProgramCache::setDefault(const Ptr & cache) {
+        std::lock_guard<std::mutex> lock(defaultMutex);
+        defaultCache = cache;
+    }
+}
@@ -0,0 +1,206 @@
+#include "glpp/ResourceTracker.hpp"
+
+#include <algorithm>
+#include <ios>
+
+namespace glpp {
+    void ResourceTracker::add(Kind kind, std::size_t bytes) {
+        kindTotals[kind].current += bytes;
+        kindTotals[kind].peak =
+            std::max(kindTotals[kind].peak, kindTotals[kind].current);
+        totals.current += bytes;
+        totals.peak = std::max(totals.peak, totals.current);
+    }
+
+    void ResourceTracker::remove(Kind kind, std::size_t bytes) {
+        kindTotals[kind].current -= bytes;
+        totals.current -= bytes;
+    }
+
+    void ResourceTracker::track(const Record & record) {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto key = std::make_pair(record.kind, record.id);
+        auto it = records.find(key);
+        if (it != records.end()) {
+            remove(it->second.kind, it->second.bytes);
+            it->second = record;
+        }
+        else {
+            records.emplace(key, record);
+        }
+        add(record.kind, record.bytes);
+    }
+
+    void ResourceTracker::untrack(Kind kind, GLuint id) {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = records.find(std::make_pair(kind, id));
+        if (it == records.end())
+            return;
+        remove(kind, it->second.bytes);
+        records.erase(it);
+    }
+
+    ResourceTracker::Totals ResourceTracker::getTotals() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return totals;
+    }
+
+    ResourceTracker::Totals ResourceTracker::getTotals(Kind kind) const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return kindTotals[kind];
+    }
+
+    std::size_t ResourceTracker::getBytes(Kind kind, GLuint id) const {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = records.find(std::make_pair(kind, id));
+        return it != records.end() ? it->second.bytes : 0;
+    }
+
+    std::map<GLenum, std::size_t> ResourceTracker::getBytesByTarget() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        std::map<GLenum, std::size_t> bytes;
+        for (auto & entry : records) {
+            if (entry.second.kind == BufferMemory)
+                bytes[entry.second.target] += entry.second.bytes;
+        }
+        return bytes;
+    }
+
+    std::map<GLenum, std::size_t> ResourceTracker::getBytesByUsage() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        std::map<GLenum, std::size_t> bytes;
+        for (auto & entry : records) {
+            if (entry.second.kind == BufferMemory)
+                bytes[entry.second.usage] += entry.second.bytes;
+        }
+        return bytes;
+    }
+
+    std::map<GLenum, std::size_t> ResourceTracker::getBytesByFormat() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        std::map<GLenum, std::size_t> bytes;
+        for (auto & entry : records) {
+            if (entry.second.kind != BufferMemory)
+                bytes[entry.second.format] += entry.second.bytes;
+        }
+        return bytes;
+    }
+
+    vector<ResourceTracker::Record> ResourceTracker::getRecords() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        vector<Record> list;
+        list.reserve(records.size());
+        for (auto & entry : records) {
+            list.push_back(entry.second);
+        }
+        return list;
+    }
+
+    void ResourceTracker::dump(std::ostream & os) const {
+        static const char * kindNames[] = {"Buffer", "Texture", "RenderBuffer"};
+
+        auto list = getRecords();
+        auto flags = os.flags();
+        for (auto & r : list) {
+            os << kindNames[r.kind] << " " << std::dec << r.id << std::hex
+               << " target 0x" << r.target;
+            if (r.kind == BufferMemory)
+                os << " usage 0x" << r.usage;
+            else
+                os << " format 0x" << r.format << std::dec << " " << r.width
+                   << "x" << r.height << " samples " << r.samples
+                   << " levels " << r.levels;
+            os << std::dec << " " << r.bytes << " bytes\n";
+        }
+
+        Totals all = getTotals();
+        os << "Total " << all.current << " bytes, peak " << all.peak
+           << " bytes\n";
+        os.flags(flags);
+    }
+
+    void ResourceTracker::resetPeak() {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (auto & t : kindTotals) {
+            t.peak = t.current;
+        }
+        totals.peak = totals.current;
+    }
+
+    std::size_t ResourceTracker::pixelSize(GLenum format) {
+        switch (format) {
+            case GL_R8:
+            case GL_R8I:
+            case GL_R8UI:
+            case GL_RED:
+            case GL_STENCIL_INDEX8:
+                return 1;
+            case GL_R16:
+            case GL_R16F:
+            case GL_R16I:
+            case GL_R16UI:
+            case GL_RG8:
+            case GL_RG8I:
+            case GL_RG8UI:
+            case GL_RG:
+            case GL_DEPTH_COMPONENT16:
+                return 2;
+            case GL_RGB8:
+            case GL_SRGB8:
+            case GL_RGB:
+            case GL_DEPTH_COMPONENT24:
+                return 3;
+            case GL_R32F:
+            case GL_R32I:
+            case GL_R32UI:
+            case GL_RG16:
+            case GL_RG16F:
+            case GL_RGBA8:
+            case GL_SRGB8_ALPHA8:
+            case GL_RGB10_A2:
+            case GL_R11F_G11F_B10F:
+            case GL_RGBA:
+            case GL_DEPTH_COMPONENT:
+            case GL_DEPTH_COMPONENT32:
+            case GL_DEPTH_COMPONENT32F:
+            case GL_DEPTH24_STENCIL8:
+            case GL_DEPTH_STENCIL:
+                return 4;
+            case GL_RGB16:
+            case GL_RGB16F:
+                return 6;
+            case GL_RG32F:
+            case GL_RGBA16:
+            case GL_RGBA16F:
+            case GL_DEPTH32F_STENCIL8:
+                return 8;
+            case GL_RGB32F:
+                return 12;
+            case GL_RGBA32F:
+                return 16;
+            default:
+                return 4;
+        }
+    }
+
+    std::size_t ResourceTracker::imageSize(GLenum format,
+                                           GLsizei width,
+                                           GLsizei height,
+                                           GLsizei levels,
+                                           GLsizei samples) {
+        std::size_t bytes = 0;
+        for (GLsizei level = 0; level < levels; level++) {
+            bytes += std::size_t(width) * height;
+            width = std::max(width / 2, 1);
+            height = std::max(height / 2, 1);
+        }
+        return bytes * pixelSize(format) * std::max(samples, 1);
+    }
+
+    ResourceTracker & ResourceTracker::getDefault() {
+        // Never destroyed, static objects created before the tracker still
+        // untrack their resources when they are destroyed at exit
+        static ResourceTracker * tracker = new ResourceTracker();
+        return *tracker;
+    }
+}
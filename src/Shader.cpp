@@ -1,9 +1,17 @@
 #include "glpp/Shader.hpp"
 
+#include <algorithm>
+#include <cstring>
 #include <fstream>
+#include <map>
+#include <sstream>
 #include <string>
 #include <vector>
 
+#include "glpp/ProgramCache.hpp"
+#include "glpp/StateCache.hpp"
+#include "glpp/UniformBlock.hpp"
+
 namespace glpp {
     using std::vector;
 
@@ -99,6 +107,92 @@ namespace glpp {
         }
         return shader;
     }
+
+    /**
+     * Link shaders into a new program. The shaders are deleted.
+     *
+     * @param shaders the compiled shaders
+     * @param varyings the transform feedback varyings, may be empty
+     * @param bufferMode the transform feedback buffer mode
+     * @param retrievable should the binary be retrievable for ProgramCache
+     *
+     * @return the program id
+     */
+    static GLuint linkProgram(const vector<GLuint> & shaders,
+                              const vector<string> & varyings,
+                              GLenum bufferMode,
+                              bool retrievable) {
+        GLuint program = glCreateProgram();
+        if (retrievable)
+            glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT,
+                                GL_TRUE);
+
+        for (GLuint shader : shaders) {
+            glAttachShader(program, shader);
+        }
+
+        if (!varyings.empty()) {
+            vector<const GLchar *> names;
+            names.reserve(varyings.size());
+            for (auto & name : varyings) {
+                names.push_back(name.c_str());
+            }
+            glTransformFeedbackVaryings(program, names.size(), names.data(),
+                                        bufferMode);
+        }
+
+        glLinkProgram(program);
+
+        for (GLuint shader : shaders) {
+            glDetachShader(program, shader);
+            glDeleteShader(shader);
+        }
+
+        if (!linkSuccess(program)) {
+            ShaderLinkException error(program);
+            glDeleteProgram(program);
+            throw error;
+        }
+        return program;
+    }
+
+    /**
+     * Load a program from the default ProgramCache, or compile and link it
+     * and store the binary in the cache.
+     *
+     * @param sources the vertex and optional fragment shader source
+     * @param varyings the transform feedback varyings, may be empty
+     * @param bufferMode the transform feedback buffer mode
+     *
+     * @return the program id
+     *
+     * @pre sources must be null terminated
+     */
+    static GLuint buildProgram(const vector<string_view> & sources,
+                               const vector<string> & varyings,
+                               GLenum bufferMode) {
+        auto cache = ProgramCache::getDefault();
+        if (cache && !ProgramCache::isSupported())
+            cache = nullptr;
+
+        std::uint64_t key = 0;
+        if (cache) {
+            key = cache->key(sources, varyings, bufferMode);
+            if (GLuint program = cache->load(key))
+                return program;
+        }
+
+        static const GLenum stages[] = {GL_VERTEX_SHADER, GL_FRAGMENT_SHADER};
+        vector<GLuint> shaders;
+        for (std::size_t i = 0; i < sources.size(); i++) {
+            shaders.push_back(compileShader(stages[i], sources[i]));
+        }
+        GLuint program = linkProgram(shaders, varyings, bufferMode, cache != nullptr);
+
+        if (cache)
+            cache->store(key, program);
+        return program;
+    }
 }
 
 namespace glpp {
@@ -112,7 +206,26 @@ namespace glpp {
 }
 
 namespace glpp {
-    Uniform::Uniform(GLuint location) : location(location) {}
+    Uniform::Uniform(GLuint location) : Uniform(location, nullptr, nullptr) {}
+
+    Uniform::Uniform(GLuint location, shared_ptr<Value> value, Counters * counters)
+        : location(location), value(std::move(value)), counters(counters) {}
+
+    template<typename T>
+    bool Uniform::update(const T & newValue) const {
+        static_assert(sizeof(T) <= sizeof(Value::data),
+                      "Uniform value does not fit the shadow copy");
+        if (!value)
+            return true;
+        if (value->valid && std::memcmp(value->data, &newValue, sizeof(T)) == 0) {
+            counters->skipped++;
+            return false;
+        }
+        std::memcpy(value->data, &newValue, sizeof(T));
+        value->valid = true;
+        counters->issued++;
+        return true;
+    }
 
     GLuint Uniform::getLocation() const {
         return location;
@@ -123,82 +236,140 @@ namespace glpp {
     }
 
     void Uniform::setBool(bool value) const {
-        glUniform1i(location, static_cast<int>(value));
+        setInt(static_cast<int>(value));
     }
 
     void Uniform::setInt(int value) const {
-        glUniform1i(location, value);
+        if (update(value))
+            glUniform1i(location, value);
     }
 
     void Uniform::setUInt(unsigned int value) const {
-        glUniform1ui(location, value);
+        if (update(value))
+            glUniform1ui(location, value);
     }
 
     void Uniform::setFloat(float value) const {
-        glUniform1f(location, value);
+        if (update(value))
+            glUniform1f(location, value);
     }
 
     void Uniform::setVec2(const glm::vec2 & value) const {
-        glUniform2fv(location, 1, &value.x);
+        if (update(value))
+            glUniform2fv(location, 1, &value.x);
     }
 
     void Uniform::setVec3(const glm::vec3 & value) const {
-        glUniform3fv(location, 1, &value.x);
+        if (update(value))
+            glUniform3fv(location, 1, &value.x);
     }
 
     void Uniform::setVec4(const glm::vec4 & value) const {
-        glUniform4fv(location, 1, &value.x);
+        if (update(value))
+            glUniform4fv(location, 1, &value.x);
     }
 
     void Uniform::setMat2(const glm::mat2 & value) const {
-        glUniformMatrix2fv(location, 1, GL_FALSE, &value[0][0]);
+        if (update(value))
+            glUniformMatrix2fv(location, 1, GL_FALSE, &value[0][0]);
     }
 
     void Uniform::setMat3(const glm::mat3 & value) const {
-        glUniformMatrix3fv(location, 1, GL_FALSE, &value[0][0]);
+        if (update(value))
+            glUniformMatrix3fv(location, 1, GL_FALSE, &value[0][0]);
     }
 
     void Uniform::setMat4(const glm::mat4 & value) const {
-        glUniformMatrix4fv(location, 1, GL_FALSE, &value[0][0]);
+        if (update(value))
+            glUniformMatrix4fv(location, 1, GL_FALSE, &value[0][0]);
     }
 }
 
 namespace glpp {
     Shader::Shader(const string_view & vertexSource,
-                   const string_view & fragmentSource) {
-        GLuint vShader = compileShader(GL_VERTEX_SHADER, vertexSource);
-        GLuint fShader = compileShader(GL_FRAGMENT_SHADER, fragmentSource);
+                   const string_view & fragmentSource)
+        : Shader(vertexSource, fragmentSource, {}) {}
 
-        program = glCreateProgram();
-
-        glAttachShader(program, vShader);
-        glAttachShader(program, fShader);
-
-        glLinkProgram(program);
-
-        glDetachShader(program, vShader);
-        glDetachShader(program, fShader);
-        glDeleteShader(vShader);
-        glDeleteShader(fShader);
+    Shader::Shader(const string_view & vertexSource,
+                   const string_view & fragmentSource,
+                   const vector<string> & varyings,
+                   GLenum bufferMode)
+        : program(buildProgram({vertexSource, fragmentSource}, varyings, bufferMode)) {
+        loadUniforms();
+    }
 
-        if (!linkSuccess(program)) {
-            throw ShaderLinkException(program);
-        }
+    Shader::Shader(GLuint program) : program(program) {
+        loadUniforms();
     }
 
-    Shader::Shader(Shader && other) : program(other.program) {
+    Shader::Shader(Shader && other)
+        : program(other.program),
+          uniforms(std::move(other.uniforms)),
+          shadow(std::move(other.shadow)) {
         other.program = 0;
     }
 
     Shader & Shader::operator=(Shader && other) {
         program = other.program;
         other.program = 0;
+        uniforms = std::move(other.uniforms);
+        shadow = std::move(other.shadow);
         return *this;
     }
 
+    void Shader::loadUniforms() {
+        shadow = std::make_shared<UniformShadow>();
+        vector<UniformSlot> found;
+        for (auto & uniform : getUniforms()) {
+            // Members of uniform blocks have no location
+            if (uniform.location < 0)
+                continue;
+
+            string_view fullName = uniform.name;
+            std::size_t value = shadow->values.size();
+            shadow->values.emplace_back();
+            found.push_back({uniformHash(fullName), uniform.location, value});
+
+            // Arrays are listed once as name[0], add the array name and
+            // each element
+            if (fullName.size() > 3
+                && fullName.substr(fullName.size() - 3) == "[0]") {
+                string base(fullName.substr(0, fullName.size() - 3));
+                found.push_back({uniformHash(base), uniform.location, value});
+                for (GLint e = 1; e < uniform.size; e++) {
+                    string element = base + "[" + std::to_string(e) + "]";
+                    GLint elementLocation =
+                        glGetUniformLocation(program, element.c_str());
+                    if (elementLocation >= 0) {
+                        found.push_back({uniformHash(element), elementLocation,
+                                         shadow->values.size()});
+                        shadow->values.emplace_back();
+                    }
+                }
+            }
+        }
+
+        // Power of two size at most half full, empty slots have location -1
+        std::size_t tableSize = 1;
+        while (tableSize < found.size() * 2)
+            tableSize *= 2;
+        uniforms.assign(tableSize, {0, -1, 0});
+
+        std::size_t mask = tableSize - 1;
+        for (auto & slot : found) {
+            std::size_t i = slot.hash & mask;
+            while (uniforms[i].location >= 0 && uniforms[i].hash != slot.hash)
+                i = (i + 1) & mask;
+            uniforms[i] = slot;
+        }
+    }
+
     Shader::~Shader() {
-        if (program)
+        if (program) {
+            if (auto cache = StateCache::existing())
+                cache->deleteProgram(program);
             glDeleteProgram(program);
+        }
     }
 
     GLuint Shader::getProgram() const {
@@ -206,16 +377,331 @@ namespace glpp {
     }
 
     void Shader::bind() const {
-        glUseProgram(program);
+        StateCache::current().useProgram(program);
     }
 
     void Shader::unbind() const {
-        glUseProgram(0);
+        StateCache::current().useProgram(0);
     }
 
     Uniform Shader::uniform(const char * name) const {
-        GLuint location = glGetUniformLocation(program, name);
-        return Uniform(location);
+        return uniform(uniformHash(name));
+    }
+
+    Uniform Shader::uniform(UniformHash hash) const {
+        if (uniforms.empty())
+            return Uniform(-1);
+
+        std::size_t mask = uniforms.size() - 1;
+        std::size_t i = hash & mask;
+        while (uniforms[i].location >= 0) {
+            if (uniforms[i].hash == hash)
+                return Uniform(uniforms[i].location,
+                               shared_ptr<Uniform::Value>(
+                                   shadow, &shadow->values[uniforms[i].value]),
+                               &shadow->counters);
+            i = (i + 1) & mask;
+        }
+        return Uniform(-1);
+    }
+
+    vector<ShaderVariable> Shader::getAttributes() const {
+        GLint count = 0;
+        GLint maxLength = 0;
+        glGetProgramiv(program, GL_ACTIVE_ATTRIBUTES, &count);
+        glGetProgramiv(program, GL_ACTIVE_ATTRIBUTE_MAX_LENGTH, &maxLength);
+
+        vector<ShaderVariable> attributes;
+        vector<GLchar> name(maxLength + 1);
+        for (GLint i = 0; i < count; i++) {
+            GLsizei length = 0;
+            GLint size = 0;
+            GLenum type = 0;
+            glGetActiveAttrib(program, i, maxLength + 1, &length, &size, &type,
+                              name.data());
+            GLint location = glGetAttribLocation(program, name.data());
+            attributes.push_back({string(name.data(), length), type, size, location});
+        }
+
+        std::sort(attributes.begin(), attributes.end(),
+                  [](const ShaderVariable & a, const ShaderVariable & b) {
+                      return a.location < b.location;
+                  });
+        return attributes;
+    }
+
+    vector<ShaderVariable> Shader::getUniforms() const {
+        GLint count = 0;
+        GLint maxLength = 0;
+        glGetProgramiv(program, GL_ACTIVE_UNIFORMS, &count);
+        glGetProgramiv(program, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
+
+        vector<ShaderVariable> uniforms;
+        vector<GLchar> name(maxLength + 1);
+        for (GLint i = 0; i < count; i++) {
+            GLsizei length = 0;
+            GLint size = 0;
+            GLenum type = 0;
+            glGetActiveUniform(program, i, maxLength + 1, &length, &size,
+                               &type, name.data());
+            GLint location = glGetUniformLocation(program, name.data());
+            uniforms.push_back({string(name.data(), length), type, size, location});
+        }
+        return uniforms;
+    }
+
+    vector<ShaderBlock> Shader::getUniformBlocks() const {
+        GLint count = 0;
+        glGetProgramiv(program, GL_ACTIVE_UNIFORM_BLOCKS, &count);
+
+        vector<ShaderBlock> blocks;
+        for (GLint i = 0; i < count; i++) {
+            GLint length = 0;
+            GLint binding = 0;
+            GLint size = 0;
+            glGetActiveUniformBlockiv(program, i, GL_UNIFORM_BLOCK_NAME_LENGTH,
+                                      &length);
+            glGetActiveUniformBlockiv(program, i, GL_UNIFORM_BLOCK_BINDING,
+                                      &binding);
+            glGetActiveUniformBlockiv(program, i, GL_UNIFORM_BLOCK_DATA_SIZE,
+                                      &size);
+
+            vector<GLchar> name(length + 1);
+            GLsizei written = 0;
+            glGetActiveUniformBlockName(program, i, length + 1, &written,
+                                        name.data());
+            blocks.push_back({string(name.data(), written), GLuint(i), binding, size});
+        }
+        return blocks;
+    }
+
+    vector<ShaderBlock> Shader::getStorageBlocks() const {
+        if (!(GLEW_VERSION_4_3 || GLEW_ARB_program_interface_query))
+            return {};
+
+        GLint count = 0;
+        glGetProgramInterfaceiv(program, GL_SHADER_STORAGE_BLOCK,
+                                GL_ACTIVE_RESOURCES, &count);
+
+        static const GLenum props[] = {GL_NAME_LENGTH, GL_BUFFER_BINDING,
+                                       GL_BUFFER_DATA_SIZE};
+        vector<ShaderBlock> blocks;
+        for (GLint i = 0; i < count; i++) {
+            GLint values[3] = {0, 0, 0};
+            glGetProgramResourceiv(program, GL_SHADER_STORAGE_BLOCK, i, 3,
+                                   props, 3, nullptr, values);
+
+            vector<GLchar> name(values[0] + 1);
+            GLsizei written = 0;
+            glGetProgramResourceName(program, GL_SHADER_STORAGE_BLOCK, i,
+                                     values[0] + 1, &written, name.data());
+            blocks.push_back(
+                {string(name.data(), written), GLuint(i), values[1], values[2]});
+        }
+        return blocks;
+    }
+
+    /**
+     * The locations and components used by one element of a vertex input.
+     */
+    struct InputShape {
+        /// Number of locations, the column count for matrices
+        GLint locations;
+        /// Number of components read from each location
+        GLint components;
+        /// int and unsigned int types
+        bool integer;
+        /// double types
+        bool isDouble;
+    };
+
+    /**
+     * Get the shape of an input type.
+     *
+     * @param type the input type
+     *
+     * @return the locations, components and kind of the type
+     */
+    static InputShape inputShape(GLenum type) {
+        switch (type) {
+            case GL_INT:
+            case GL_UNSIGNED_INT:
+                return {1, 1, true, false};
+            case GL_INT_VEC2:
+            case GL_UNSIGNED_INT_VEC2:
+                return {1, 2, true, false};
+            case GL_INT_VEC3:
+            case GL_UNSIGNED_INT_VEC3:
+                return {1, 3, true, false};
+            case GL_INT_VEC4:
+            case GL_UNSIGNED_INT_VEC4:
+                return {1, 4, true, false};
+            case GL_DOUBLE:
+                return {1, 1, false, true};
+            case GL_DOUBLE_VEC2:
+                return {1, 2, false, true};
+            case GL_DOUBLE_VEC3:
+                return {1, 3, false, true};
+            case GL_DOUBLE_VEC4:
+                return {1, 4, false, true};
+            case GL_FLOAT_VEC2:
+                return {1, 2, false, false};
+            case GL_FLOAT_VEC3:
+                return {1, 3, false, false};
+            case GL_FLOAT_VEC4:
+                return {1, 4, false, false};
+            // Matrices use one location per column, GL_FLOAT_MATCxR
+            case GL_FLOAT_MAT2:
+                return {2, 2, false, false};
+            case GL_FLOAT_MAT2x3:
+                return {2, 3, false, false};
+            case GL_FLOAT_MAT2x4:
+                return {2, 4, false, false};
+            case GL_FLOAT_MAT3:
+                return {3, 3, false, false};
+            case GL_FLOAT_MAT3x2:
+                return {3, 2, false, false};
+            case GL_FLOAT_MAT3x4:
+                return {3, 4, false, false};
+            case GL_FLOAT_MAT4:
+                return {4, 4, false, false};
+            case GL_FLOAT_MAT4x2:
+                return {4, 2, false, false};
+            case GL_FLOAT_MAT4x3:
+                return {4, 3, false, false};
+            default:
+                return {1, 1, false, false};
+        }
+    }
+
+    vector<string> Shader::checkLayout(const vector<Buffer::Attribute> & attributes,
+                                       vector<string> * warnings) const {
+        vector<string> problems;
+
+        std::map<GLuint, const Buffer::Attribute *> byIndex;
+        for (auto & attr : attributes) {
+            if (!byIndex.emplace(attr.index, &attr).second)
+                problems.push_back("Attribute " + std::to_string(attr.index)
+                                   + " is listed more than once");
+        }
+
+        for (auto & input : getAttributes()) {
+            // Built-in inputs like gl_VertexID have no location
+            if (input.location < 0)
+                continue;
+
+            InputShape shape = inputShape(input.type);
+            GLint locations = shape.locations * input.size;
+            for (GLint i = 0; i < locations; i++) {
+                GLuint location = input.location + i;
+                std::ostringstream problem;
+                problem << "Input " << input.name << " at location " << location;
+
+                auto it = byIndex.find(location);
+                if (it == byIndex.end()) {
+                    problem << " has no attribute";
+                    problems.push_back(problem.str());
+                    continue;
+                }
+
+                const Buffer::Attribute & attr = *it->second;
+                if (shape.isDouble) {
+                    problem << " of type 0x" << std::hex << input.type
+                            << " can not be read from attributes set with "
+                               "glVertexAttribPointer";
+                }
+                else if (shape.integer && !attr.integer) {
+                    problem << " of type 0x" << std::hex << input.type
+                            << " needs an integer attribute";
+                }
+                else if (!shape.integer && attr.integer) {
+                    problem << " of type 0x" << std::hex << input.type
+                            << " can not read an integer attribute";
+                }
+                else {
+                    // Valid for OpenGL, only worth a warning
+                    if (!warnings)
+                        continue;
+                    if (attr.size != shape.components) {
+                        problem << " reads " << shape.components
+                                << " components but the attribute has "
+                                << attr.size;
+                    }
+                    else if (!shape.integer && !attr.normalized
+                             && Buffer::Attribute::isIntegerType(attr.type)) {
+                        problem << " of type 0x" << std::hex << input.type
+                                << " reads unnormalized integers of type 0x"
+                                << attr.type << " as float";
+                    }
+                    else {
+                        continue;
+                    }
+                    warnings->push_back(problem.str());
+                    continue;
+                }
+                problems.push_back(problem.str());
+            }
+        }
+        return problems;
+    }
+
+    void Shader::validateLayout(const vector<Buffer::Attribute> & attributes) const {
+        auto problems = checkLayout(attributes);
+        if (problems.empty())
+            return;
+
+        string message = "Vertex layout does not match shader";
+        for (auto & problem : problems) {
+            message += "\n" + problem;
+        }
+        throw ShaderLayoutException(message);
+    }
+
+    void Shader::validateLayout(const BufferArray & array) const {
+        vector<Buffer::Attribute> attributes;
+        for (auto & buffer : array.getBuffers()) {
+            auto & attrib = buffer->getAttributes();
+            attributes.insert(attributes.end(), attrib.begin(), attrib.end());
+        }
+        validateLayout(attributes);
+    }
+
+    const Uniform::Counters & Shader::getUniformCounters() const {
+        static const Uniform::Counters none;
+        return shadow ? shadow->counters : none;
+    }
+
+    void Shader::resetUniformCounters() {
+        if (shadow)
+            shadow->counters = Uniform::Counters();
+    }
+
+    void Shader::invalidateUniforms() {
+        if (!shadow)
+            return;
+        for (auto & value : shadow->values) {
+            value.valid = false;
+        }
+    }
+
+    bool Shader::bindUniformBlock(const char * name, GLuint binding) const {
+        GLuint index = glGetUniformBlockIndex(program, name);
+        if (index == GL_INVALID_INDEX)
+            return false;
+        glUniformBlockBinding(program, index, binding);
+        return true;
+    }
+
+    bool Shader::bindStorageBlock(const char * name, GLuint binding) const {
+        if (!(GLEW_VERSION_4_3 || GLEW_ARB_shader_storage_buffer_object))
+            return false;
+
+        GLuint index =
+            glGetProgramResourceIndex(program, GL_SHADER_STORAGE_BLOCK, name);
+        if (index == GL_INVALID_INDEX)
+            return false;
+        glShaderStorageBlockBinding(program, index, binding);
+        return true;
     }
 }
 
@@ -228,11 +714,16 @@ layout (location = 2) in vec2 aTex;
 out vec3 FragPos;
 out vec3 FragNorm;
 out vec2 FragTex;
-uniform mat4 vp;
+layout (std140) uniform Frame {
+    mat4 view;
+    mat4 projection;
+    mat4 viewProj;
+    vec3 cameraPos;
+    vec2 screenSize;
+};
 uniform mat4 model;
 void main() {
-    mat4 mvp = vp * model;
-    gl_Position = mvp * vec4(aPos, 1.0);
+    gl_Position = viewProj * model * vec4(aPos, 1.0);
     FragPos = vec3(model * vec4(aPos, 1.0));
     FragNorm = aNorm;
     FragTex = aTex;
@@ -251,13 +742,20 @@ void main() {
 
     [[deprecated("A default shader will be provided in a different form, if at all, in future releases")]]
     Shader & Shader::defaultShader() {
-        static Shader shader(defaultVertexShaderSource,
-                             defaultFragmentShaderSource);
+        static Shader shader = fromFragmentSource(defaultFragmentShaderSource);
         return shader;
     }
 
     Shader Shader::fromFragmentSource(const string_view & fragmentSource) {
-        return Shader(defaultVertexShaderSource, fragmentSource);
+        Shader shader(defaultVertexShaderSource, fragmentSource);
+        shader.bindUniformBlock("Frame", FrameUniforms::binding);
+        return shader;
+    }
+
+    Shader Shader::fromVertexSource(const string_view & source,
+                                    const vector<string> & varyings,
+                                    GLenum bufferMode) {
+        return Shader(buildProgram({source}, varyings, bufferMode));
     }
 
     Shader Shader::fromPaths(const string & vertexPath,
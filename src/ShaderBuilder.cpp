@@ -0,0 +1,233 @@
+#include "glpp/ShaderBuilder.hpp"
+
+#include <cstdint>
+#include <exception>
+
+#include "glpp/ProgramCache.hpp"
+
+namespace glpp {
+    /**
+     * A submitted program, shared by all copies of a Handle.
+     */
+    struct ShaderBuilder::Handle::State {
+        vector<GLuint> shaders;
+        GLuint program = 0;
+        bool parallel = false;
+        /// Cache to store the binary in once linked, nullptr if loaded from it
+        ProgramCache::Ptr cache;
+        std::uint64_t key = 0;
+        std::unique_ptr<Shader> shader;
+        std::exception_ptr error;
+
+        State() = default;
+
+        State(const State &) = delete;
+        State & operator=(const State &) = delete;
+
+        ~State() {
+            release();
+        }
+
+        /// Delete the shaders and the program if it is not owned by shader
+        void release() {
+            for (GLuint id : shaders) {
+                if (program)
+                    glDetachShader(program, id);
+                glDeleteShader(id);
+            }
+            shaders.clear();
+            if (program)
+                glDeleteProgram(program);
+            program = 0;
+        }
+    };
+
+    ShaderBuilder::Handle::operator bool() const {
+        return state != nullptr;
+    }
+
+    bool ShaderBuilder::Handle::ready() const {
+        if (!state)
+            return false;
+        if (state->shader || state->error || !state->parallel)
+            return true;
+
+        GLint complete = GL_FALSE;
+        glGetProgramiv(state->program, GL_COMPLETION_STATUS_KHR, &complete);
+        return complete != GL_FALSE;
+    }
+
+    Shader & ShaderBuilder::Handle::get() {
+        if (state->shader)
+            return *state->shader;
+        if (state->error)
+            std::rethrow_exception(state->error);
+
+        // These queries block until the driver is done
+        try {
+            for (GLuint id : state->shaders) {
+                GLint success = GL_FALSE;
+                glGetShaderiv(id, GL_COMPILE_STATUS, &success);
+                if (success == GL_FALSE)
+                    throw ShaderCompileException(id);
+            }
+
+            GLint success = GL_FALSE;
+            glGetProgramiv(state->program, GL_LINK_STATUS, &success);
+            if (success == GL_FALSE)
+                throw ShaderLinkException(state->program);
+        }
+        catch (...) {
+            state->error = std::current_exception();
+            state->release();
+            throw;
+        }
+
+        for (GLuint id : state->shaders) {
+            glDetachShader(state->program, id);
+            glDeleteShader(id);
+        }
+        state->shaders.clear();
+
+        if (state->cache)
+            state->cache->store(state->key, state->program);
+
+        state->shader.reset(createShader(state->program));
+        state->program = 0;
+        return *state->shader;
+    }
+}
+
+namespace glpp {
+    ShaderBuilder::ShaderBuilder() {
+        // Let the driver pick the number of compiler threads
+        if (GLEW_KHR_parallel_shader_compile)
+            glMaxShaderCompilerThreadsKHR(0xFFFFFFFF);
+        else if (GLEW_ARB_parallel_shader_compile)
+            glMaxShaderCompilerThreadsARB(0xFFFFFFFF);
+    }
+
+    Shader * ShaderBuilder::createShader(GLuint program) {
+        return new Shader(program);
+    }
+
+    ShaderBuilder::Handle ShaderBuilder::submit(const vector<string_view> & sources,
+                                                const vector<string> & varyings,
+                                                GLenum bufferMode) {
+        Handle handle;
+        handle.state = std::make_shared<Handle::State>();
+        auto & state = *handle.state;
+        state.parallel = hasParallelCompile();
+        handles.push_back(handle);
+
+        auto cache = ProgramCache::getDefault();
+        if (cache && ProgramCache::isSupported()) {
+            state.key = cache->key(sources, varyings, bufferMode);
+            state.program = cache->load(state.key);
+            if (state.program)
+                return handle;
+            state.cache = cache;
+        }
+
+        static const GLenum stages[] = {GL_VERTEX_SHADER, GL_FRAGMENT_SHADER};
+        state.program = glCreateProgram();
+        if (state.cache)
+            glProgramParameteri(state.program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT,
+                                GL_TRUE);
+
+        for (std::size_t i = 0; i < sources.size(); i++) {
+            GLuint id = glCreateShader(stages[i]);
+            const char * source = sources[i].data();
+            glShaderSource(id, 1, &source, NULL);
+            glCompileShader(id);
+            glAttachShader(state.program, id);
+            state.shaders.push_back(id);
+        }
+
+        if (!varyings.empty()) {
+            vector<const GLchar *> names;
+            names.reserve(varyings.size());
+            for (auto & name : varyings) {
+                names.push_back(name.c_str());
+            }
+            glTransformFeedbackVaryings(state.program, names.size(),
+                                        names.data(), bufferMode);
+        }
+
+        // Link without checking compile status, a failed stage fails the
+        // link and is reported by get
+        glLinkProgram(state.program);
+        return handle;
+    }
+
+    ShaderBuilder::Handle ShaderBuilder::add(const string_view & vertexSource,
+                                             const string_view & fragmentSource,
+                                             const vector<string> & varyings,
+                                             GLenum bufferMode) {
+        return submit({vertexSource, fragmentSource}, varyings, bufferMode);
+    }
+
+    ShaderBuilder::Handle ShaderBuilder::addVertex(const string_view & source,
+                                                   const vector<string> & varyings,
+                                                   GLenum bufferMode) {
+        return submit({source}, varyings, bufferMode);
+    }
+
+    std::size_t ShaderBuilder::getPending() const {
+        std::size_t pending = 0;
+        for (auto & handle : handles) {
+            if (!handle.ready())
+                pending++;
+        }
+        return pending;
+    }
+
+    void ShaderBuilder::finish() {
+        std::exception_ptr error;
+        for (auto & handle : handles) {
+            try {
+                handle.get();
+            }
+            catch (...) {
+                if (!error)
+                    error = std::current_exception();
+            }
+        }
+        handles.clear();
+        if (error)
+            std::rethrow_exception(error);
+    }
+
+    bool ShaderBuilder::hasParallelCompile() {
+        return GLEW_KHR_parallel_shader_compile
+               || GLEW_ARB_parallel_shader_compile;
+    }
+}
+
+namespace glpp {
+    WarmShader::WarmShader(const string_view & vertexSource,
+                           const string_view & fragmentSource,
+                           std::function<void(Shader &)> setup)
+        : vertexSource(vertexSource),
+          fragmentSource(fragmentSource),
+          setup(std::move(setup)) {}
+
+    void WarmShader::warm(ShaderBuilder & builder) {
+        if (!shader && !pending)
+            pending = builder.add(vertexSource, fragmentSource);
+    }
+
+    Shader & WarmShader::get() {
+        if (shader)
+            return *shader;
+
+        if (pending)
+            shader = std::make_unique<Shader>(std::move(pending.get()));
+        else
+            shader = std::make_unique<Shader>(vertexSource, fragmentSource);
+        pending = ShaderBuilder::Handle();
+        if (setup)
+            setup(*shader);
+        return *shader;
+    }
+}
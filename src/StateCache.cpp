@@ -0,0 +1,207 @@
+#include "glpp/StateCache.hpp"
+
+namespace glpp {
+    // Binding value that never matches a real object
+    static constexpr GLuint unknown = ~GLuint(0);
+
+    StateCache::StateCache() {
+        invalidate();
+    }
+
+    bool StateCache::update(Kind kind, GLuint & cached, GLuint value) {
+        if (cached == value) {
+            counters[kind].skipped++;
+            return false;
+        }
+        cached = value;
+        counters[kind].issued++;
+        return true;
+    }
+
+    void StateCache::invalidate() {
+        buffers.clear();
+        vertexArray = unknown;
+        program = unknown;
+        activeUnit = unknown;
+        textures.clear();
+        drawFrameBuffer = unknown;
+        readFrameBuffer = unknown;
+        renderBuffer = unknown;
+        transformFeedback = unknown;
+        directStateAccess = GLEW_VERSION_4_5 || GLEW_ARB_direct_state_access;
+    }
+
+    bool StateCache::hasDirectStateAccess() const {
+        return directStateAccess;
+    }
+
+    void StateCache::setDirectStateAccess(bool enabled) {
+        directStateAccess =
+            enabled && (GLEW_VERSION_4_5 || GLEW_ARB_direct_state_access);
+    }
+
+    void StateCache::bindBuffer(GLenum target, GLuint buffer) {
+        auto it = buffers.try_emplace(target, unknown).first;
+        if (update(BufferBind, it->second, buffer))
+            glBindBuffer(target, buffer);
+    }
+
+    void StateCache::bindVertexArray(GLuint array) {
+        if (update(VertexArrayBind, vertexArray, array)) {
+            glBindVertexArray(array);
+            buffers.erase(GL_ELEMENT_ARRAY_BUFFER);
+        }
+    }
+
+    void StateCache::useProgram(GLuint program) {
+        if (update(ProgramBind, this->program, program))
+            glUseProgram(program);
+    }
+
+    void StateCache::activeTexture(GLuint unit) {
+        if (update(ActiveTextureBind, activeUnit, unit))
+            glActiveTexture(GL_TEXTURE0 + unit);
+    }
+
+    void StateCache::bindTexture(GLuint unit, GLenum target, GLuint texture) {
+        activeTexture(unit);
+
+        if (textures.size() <= unit)
+            textures.resize(unit + 1);
+
+        auto it = textures[unit].try_emplace(target, unknown).first;
+        if (update(TextureBind, it->second, texture))
+            glBindTexture(target, texture);
+    }
+
+    void StateCache::bindTexture(GLenum target, GLuint texture) {
+        if (activeUnit == unknown) {
+            // Unit is not known, send the bind without caching it
+            counters[TextureBind].issued++;
+            glBindTexture(target, texture);
+            return;
+        }
+        bindTexture(activeUnit, target, texture);
+    }
+
+    void StateCache::bindFrameBuffer(GLenum target, GLuint buffer) {
+        if (target == GL_FRAMEBUFFER) {
+            if (drawFrameBuffer == buffer && readFrameBuffer == buffer) {
+                counters[FrameBufferBind].skipped++;
+                return;
+            }
+            drawFrameBuffer = readFrameBuffer = buffer;
+            counters[FrameBufferBind].issued++;
+            glBindFramebuffer(target, buffer);
+        }
+        else {
+            GLuint & cached =
+                target == GL_READ_FRAMEBUFFER ? readFrameBuffer : drawFrameBuffer;
+            if (update(FrameBufferBind, cached, buffer))
+                glBindFramebuffer(target, buffer);
+        }
+    }
+
+    void StateCache::bindRenderBuffer(GLuint buffer) {
+        if (update(RenderBufferBind, renderBuffer, buffer))
+            glBindRenderbuffer(GL_RENDERBUFFER, buffer);
+    }
+
+    void StateCache::bindTransformFeedback(GLuint feedback) {
+        if (update(TransformFeedbackBind, transformFeedback, feedback)) {
+            glBindTransformFeedback(GL_TRANSFORM_FEEDBACK, feedback);
+            buffers.erase(GL_TRANSFORM_FEEDBACK_BUFFER);
+        }
+    }
+
+    // Deleting a bound object reverts the binding to 0
+
+    void StateCache::deleteBuffer(GLuint buffer) {
+        for (auto & binding : buffers) {
+            if (binding.second == buffer)
+                binding.second = 0;
+        }
+    }
+
+    void StateCache::deleteVertexArray(GLuint array) {
+        if (vertexArray == array) {
+            vertexArray = 0;
+            buffers.erase(GL_ELEMENT_ARRAY_BUFFER);
+        }
+    }
+
+    void StateCache::deleteProgram(GLuint program) {
+        // The current program stays in use until another program is bound
+        if (this->program == program)
+            this->program = unknown;
+    }
+
+    void StateCache::deleteTexture(GLuint texture) {
+        for (auto & unit : textures) {
+            for (auto & binding : unit) {
+                if (binding.second == texture)
+                    binding.second = 0;
+            }
+        }
+    }
+
+    void StateCache::deleteFrameBuffer(GLuint buffer) {
+        if (drawFrameBuffer == buffer)
+            drawFrameBuffer = 0;
+        if (readFrameBuffer == buffer)
+            readFrameBuffer = 0;
+    }
+
+    void StateCache::deleteRenderBuffer(GLuint buffer) {
+        if (renderBuffer == buffer)
+            renderBuffer = 0;
+    }
+
+    void StateCache::deleteTransformFeedback(GLuint feedback) {
+        if (transformFeedback == feedback) {
+            transformFeedback = 0;
+            buffers.erase(GL_TRANSFORM_FEEDBACK_BUFFER);
+        }
+    }
+
+    GLuint StateCache::getActiveTexture() const {
+        return activeUnit;
+    }
+
+    const StateCache::Counters & StateCache::getCounters(Kind kind) const {
+        return counters[kind];
+    }
+
+    std::size_t StateCache::getSkipped() const {
+        std::size_t total = 0;
+        for (auto & c : counters) {
+            total += c.skipped;
+        }
+        return total;
+    }
+
+    void StateCache::resetCounters() {
+        counters.fill(Counters());
+    }
+
+    // Points at the cache of the thread while it exists, thread_local
+    // pointers are never destroyed so this is safe to read at exit
+    static thread_local StateCache * threadCache = nullptr;
+
+    StateCache & StateCache::current() {
+        thread_local struct Holder {
+            StateCache cache;
+            Holder() {
+                threadCache = &cache;
+            }
+            ~Holder() {
+                threadCache = nullptr;
+            }
+        } holder;
+        return holder.cache;
+    }
+
+    StateCache * StateCache::existing() {
+        return threadCache;
+    }
+}
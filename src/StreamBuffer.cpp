@@ -0,0 +1,171 @@
+#include "glpp/StreamBuffer.hpp"
+
+namespace glpp {
+    static constexpr GLbitfield storageFlags =
+        GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+    // Wait in 1 second steps and give up after 10 so a lost context does not
+    // hang forever
+    static constexpr GLuint64 waitTimeout = 1000000000;
+    static constexpr int maxWaits = 10;
+
+    StreamBuffer::StreamBuffer(GLsizeiptr regionSize,
+                               std::size_t regionCount,
+                               Target target)
+        : StreamBuffer({}, regionSize, regionCount, target) {}
+
+    StreamBuffer::StreamBuffer(const vector<Attribute> & attrib,
+                               GLsizeiptr regionSize,
+                               std::size_t regionCount,
+                               Target target)
+        : Buffer(attrib, target),
+          regionSize(regionSize),
+          regionCount(regionCount),
+          region(0),
+          head(0),
+          mapping(nullptr),
+          fences(regionCount, nullptr) {
+
+        if (regionCount == 0 || regionSize <= 0)
+            throw StreamBufferException("Stream buffer needs at least one region");
+
+        if (!GLEW_VERSION_4_4 && !GLEW_ARB_buffer_storage)
+            throw StreamBufferException("Buffer storage is not supported");
+
+        GLsizeiptr total = regionSize * regionCount;
+
+        bind();
+        glBufferStorage(target, total, nullptr, storageFlags);
+        mapping = static_cast<unsigned char *>(
+            glMapBufferRange(target, 0, total, storageFlags));
+
+        if (!mapping)
+            throw StreamBufferException("Failed to map stream buffer");
+
+        setStorage(total, Stream);
+    }
+
+    StreamBuffer::StreamBuffer(StreamBuffer && other)
+        : Buffer(std::move(other)),
+          regionSize(other.regionSize),
+          regionCount(other.regionCount),
+          region(other.region),
+          head(other.head),
+          mapping(other.mapping),
+          fences(std::move(other.fences)) {
+        other.reset();
+    }
+
+    StreamBuffer & StreamBuffer::operator=(StreamBuffer && other) {
+        if (this == &other)
+            return *this;
+        deleteFences();
+        // The storage is deleted by Buffer::operator=, unmap it first
+        if (mapping) {
+            bind();
+            glUnmapBuffer(getTarget());
+        }
+        Buffer::operator=(std::move(other));
+        regionSize = other.regionSize;
+        regionCount = other.regionCount;
+        region = other.region;
+        head = other.head;
+        mapping = other.mapping;
+        fences = std::move(other.fences);
+        other.reset();
+        return *this;
+    }
+
+    void StreamBuffer::deleteFences() {
+        for (auto & fence : fences) {
+            if (fence)
+                glDeleteSync(fence);
+        }
+        fences.clear();
+    }
+
+    void StreamBuffer::reset() {
+        regionCount = 0;
+        region = 0;
+        head = 0;
+        mapping = nullptr;
+        fences.clear();
+    }
+
+    StreamBuffer::~StreamBuffer() {
+        deleteFences();
+    }
+
+    GLsizeiptr StreamBuffer::getRegionSize() const {
+        return regionSize;
+    }
+
+    std::size_t StreamBuffer::getRegionCount() const {
+        return regionCount;
+    }
+
+    std::size_t StreamBuffer::getRegion() const {
+        return region;
+    }
+
+    GLintptr StreamBuffer::getRegionOffset() const {
+        return region * regionSize;
+    }
+
+    GLsizeiptr StreamBuffer::getRemaining() const {
+        return regionSize - head;
+    }
+
+    void StreamBuffer::waitRegion() {
+        GLsync & fence = fences[region];
+        if (!fence)
+            return;
+
+        GLenum result = GL_TIMEOUT_EXPIRED;
+        for (int i = 0; i < maxWaits && result == GL_TIMEOUT_EXPIRED; i++) {
+            result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT,
+                                      waitTimeout);
+        }
+
+        // Keep the fence so the next allocate waits again
+        if (result == GL_WAIT_FAILED)
+            throw StreamBufferException("Failed to wait for stream buffer region");
+        if (result == GL_TIMEOUT_EXPIRED)
+            throw StreamBufferException("Timed out waiting for stream buffer region");
+
+        glDeleteSync(fence);
+        fence = nullptr;
+    }
+
+    StreamBuffer::Allocation StreamBuffer::allocate(GLsizeiptr size,
+                                                    GLsizeiptr alignment) {
+        if (!mapping)
+            throw StreamBufferException("Stream buffer was moved from");
+
+        if (head == 0)
+            waitRegion();
+
+        // Align the absolute offset so it can be used as a vertex index
+        GLintptr start = getRegionOffset() + head;
+        if (alignment > 1 && start % alignment != 0)
+            start += alignment - start % alignment;
+
+        GLsizeiptr end = start + size - getRegionOffset();
+        if (end > regionSize)
+            throw StreamBufferException("Stream buffer region is full");
+
+        head = end;
+        return Allocation {mapping + start, start, size};
+    }
+
+    void StreamBuffer::nextFrame() {
+        if (regionCount == 0)
+            return;
+
+        if (head > 0)
+            fences[region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+        region = (region + 1) % regionCount;
+        head = 0;
+    }
+}
@@ -1,8 +1,59 @@
 #include "glpp/Texture.hpp"
 
+#include "glpp/ResourceTracker.hpp"
+#include "glpp/StateCache.hpp"
+
 #define STB_IMAGE_IMPLEMENTATION
 #include <stb_image.h>
 
+#include <algorithm>
+
+namespace glpp {
+    /**
+     * Get the sized internal format for an unsized format, which is required
+     * by immutable storage. Sized formats are returned unchanged.
+     *
+     * @param internal the internal format
+     *
+     * @return the sized internal format
+     */
+    static GLenum sizedFormat(GLenum internal) {
+        switch (internal) {
+            case GL_RED:
+                return GL_R8;
+            case GL_RG:
+                return GL_RG8;
+            case GL_RGB:
+                return GL_RGB8;
+            case GL_RGBA:
+                return GL_RGBA8;
+            case GL_DEPTH_COMPONENT:
+                return GL_DEPTH_COMPONENT24;
+            case GL_DEPTH_STENCIL:
+                return GL_DEPTH24_STENCIL8;
+            default:
+                return internal;
+        }
+    }
+
+    /**
+     * Get the number of mipmap levels down to 1x1 for size.
+     *
+     * @param size the size of level 0
+     *
+     * @return the number of levels, 1 for an empty size
+     */
+    static GLsizei mipLevels(const glm::uvec2 & size) {
+        // Count the bits instead of log2, which is undefined for 0
+        GLsizei levels = 1;
+        for (GLuint largest = std::max(size.x, size.y); largest > 1;
+             largest >>= 1) {
+            levels++;
+        }
+        return levels;
+    }
+}
+
 namespace glpp {
     Texture::Texture(const unsigned char * data,
                      const glm::uvec2 & size,
@@ -23,7 +74,8 @@ namespace glpp {
           wrap(wrap),
           mipmaps(mipmaps) {
 
-        glGenTextures(1, &textureId);
+        if (!StateCache::current().hasDirectStateAccess())
+            glGenTextures(1, &textureId);
         loadFrom(data, size, nrComponents);
     }
 
@@ -48,13 +100,19 @@ namespace glpp {
           wrap(wrap),
           mipmaps(mipmaps) {
 
-        glGenTextures(1, &textureId);
+        if (!StateCache::current().hasDirectStateAccess())
+            glGenTextures(1, &textureId);
         resize(size);
     }
 
     Texture::~Texture() {
-        if (textureId)
+        if (textureId) {
+            if (auto cache = StateCache::existing())
+                cache->deleteTexture(textureId);
+            ResourceTracker::getDefault().untrack(ResourceTracker::TextureMemory,
+                                                  textureId);
             glDeleteTextures(1, &textureId);
+        }
     }
 
     Texture::Texture(Texture && other)
@@ -91,8 +149,6 @@ namespace glpp {
     void Texture::loadFrom(const unsigned char * data,
                            const glm::uvec2 & size,
                            size_t nrComponents) {
-        bind();
-
         this->size = size;
         if (nrComponents == 1)
             internal = Gray;
@@ -107,6 +163,19 @@ namespace glpp {
         samples = 0;
         target = GL_TEXTURE_2D;
 
+        if (StateCache::current().hasDirectStateAccess()) {
+            createStorage();
+            glTextureSubImage2D(textureId, 0, 0, 0, size.x, size.y, format,
+                                type, data);
+            if (mipmaps)
+                glGenerateTextureMipmap(textureId);
+            return;
+        }
+
+        if (!textureId)
+            glGenTextures(1, &textureId);
+        bind();
+
         glTexImage2D(target, 0, internal, size.x, size.y, 0, format, type, data);
 
         glTexParameteri(target, GL_TEXTURE_MAG_FILTER, magFilter);
@@ -118,6 +187,54 @@ namespace glpp {
         if (mipmaps)
             glGenerateMipmap(target);
         unbind();
+        trackMemory(internal, mipmaps ? mipLevels(size) : 1);
+    }
+
+    void Texture::trackMemory(GLenum format, GLsizei levels) const {
+        ResourceTracker::getDefault().track({ResourceTracker::TextureMemory,
+                                             textureId,
+                                             target,
+                                             0,
+                                             format,
+                                             GLsizei(size.x),
+                                             GLsizei(size.y),
+                                             samples,
+                                             levels,
+                                             ResourceTracker::imageSize(
+                                                 format, size.x, size.y,
+                                                 levels, samples)});
+    }
+
+    void Texture::createStorage() {
+        // Immutable storage can not be resized so the texture is replaced
+        if (textureId) {
+            if (auto cache = StateCache::existing())
+                cache->deleteTexture(textureId);
+            ResourceTracker::getDefault().untrack(ResourceTracker::TextureMemory,
+                                                  textureId);
+            glDeleteTextures(1, &textureId);
+        }
+        glCreateTextures(target, 1, &textureId);
+
+        if (size.x == 0 || size.y == 0)
+            return;
+
+        GLenum sized = sizedFormat(internal);
+        GLsizei levels = samples == 0 && mipmaps ? mipLevels(size) : 1;
+        trackMemory(sized, levels);
+        if (samples > 0) {
+            glTextureStorage2DMultisample(textureId, samples, sized, size.x,
+                                          size.y, GL_TRUE);
+        }
+        else {
+            glTextureStorage2D(textureId, levels, sized, size.x, size.y);
+
+            glTextureParameteri(textureId, GL_TEXTURE_MAG_FILTER, magFilter);
+            glTextureParameteri(textureId, GL_TEXTURE_MIN_FILTER, minFilter);
+
+            glTextureParameteri(textureId, GL_TEXTURE_WRAP_S, wrap);
+            glTextureParameteri(textureId, GL_TEXTURE_WRAP_T, wrap);
+        }
     }
 
     GLuint Texture::getTextureId() const {
@@ -138,6 +255,13 @@ namespace glpp {
 
     void Texture::resize(const glm::uvec2 & size) {
         this->size = size;
+        if (StateCache::current().hasDirectStateAccess()) {
+            createStorage();
+            return;
+        }
+
+        if (!textureId)
+            glGenTextures(1, &textureId);
         if (size.x > 0 && size.y > 0) {
             bind();
             if (samples > 0) {
@@ -155,16 +279,16 @@ namespace glpp {
                 glTexParameteri(target, GL_TEXTURE_WRAP_T, wrap);
             }
             unbind();
+            trackMemory(internal, 1);
         }
     }
 
     void Texture::bind(int index) const {
-        glActiveTexture(GL_TEXTURE0 + index);
-        glBindTexture(target, textureId);
+        StateCache::current().bindTexture(index, target, textureId);
     }
 
     void Texture::unbind() const {
-        glBindTexture(target, 0);
+        StateCache::current().bindTexture(target, 0);
     }
 
     Texture Texture::fromPath(const string & path) {
@@ -0,0 +1,168 @@
+#include "glpp/TransformFeedback.hpp"
+
+#include "glpp/StateCache.hpp"
+
+namespace glpp {
+    TransformFeedback::TransformFeedback()
+        : feedback(0), query(0), active(false), paused(false) {
+        if (!isSupported())
+            throw TransformFeedbackException(
+                "Transform feedback objects are not supported");
+
+        if (StateCache::current().hasDirectStateAccess()) {
+            glCreateTransformFeedbacks(1, &feedback);
+            glCreateQueries(GL_TRANSFORM_FEEDBACK_PRIMITIVES_WRITTEN, 1, &query);
+        }
+        else {
+            glGenTransformFeedbacks(1, &feedback);
+            glGenQueries(1, &query);
+        }
+    }
+
+    TransformFeedback::TransformFeedback(TransformFeedback && other)
+        : feedback(other.feedback),
+          query(other.query),
+          active(other.active),
+          paused(other.paused) {
+        other.feedback = 0;
+        other.query = 0;
+        other.active = false;
+        other.paused = false;
+    }
+
+    TransformFeedback & TransformFeedback::operator=(TransformFeedback && other) {
+        feedback = other.feedback;
+        query = other.query;
+        active = other.active;
+        paused = other.paused;
+        other.feedback = 0;
+        other.query = 0;
+        other.active = false;
+        other.paused = false;
+        return *this;
+    }
+
+    TransformFeedback::~TransformFeedback() {
+        if (feedback) {
+            if (active)
+                end();
+            if (auto cache = StateCache::existing())
+                cache->deleteTransformFeedback(feedback);
+            glDeleteTransformFeedbacks(1, &feedback);
+        }
+        if (query)
+            glDeleteQueries(1, &query);
+    }
+
+    GLuint TransformFeedback::getFeedbackId() const {
+        return feedback;
+    }
+
+    void TransformFeedback::bind() const {
+        StateCache::current().bindTransformFeedback(feedback);
+    }
+
+    void TransformFeedback::unbind() const {
+        StateCache::current().bindTransformFeedback(0);
+    }
+
+    void TransformFeedback::bindBuffer(GLuint index, const Buffer & buffer) const {
+        if (StateCache::current().hasDirectStateAccess()) {
+            glTransformFeedbackBufferBase(feedback, index, buffer.getBufferId());
+        }
+        else {
+            bind();
+            // glBindBufferBase also sets the generic binding, keep the cache
+            // in sync by binding through it first
+            StateCache::current().bindBuffer(GL_TRANSFORM_FEEDBACK_BUFFER,
+                                             buffer.getBufferId());
+            glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, index,
+                             buffer.getBufferId());
+        }
+    }
+
+    void TransformFeedback::bindBuffer(GLuint index,
+                                       const Buffer & buffer,
+                                       GLintptr offset,
+                                       GLsizeiptr size) const {
+        if (StateCache::current().hasDirectStateAccess()) {
+            glTransformFeedbackBufferRange(feedback, index, buffer.getBufferId(),
+                                           offset, size);
+        }
+        else {
+            bind();
+            StateCache::current().bindBuffer(GL_TRANSFORM_FEEDBACK_BUFFER,
+                                             buffer.getBufferId());
+            glBindBufferRange(GL_TRANSFORM_FEEDBACK_BUFFER, index,
+                              buffer.getBufferId(), offset, size);
+        }
+    }
+
+    void TransformFeedback::begin(Buffer::Mode mode) {
+        bind();
+        glBeginQuery(GL_TRANSFORM_FEEDBACK_PRIMITIVES_WRITTEN, query);
+        glBeginTransformFeedback(mode);
+        active = true;
+        paused = false;
+    }
+
+    void TransformFeedback::end() {
+        bind();
+        glEndTransformFeedback();
+        glEndQuery(GL_TRANSFORM_FEEDBACK_PRIMITIVES_WRITTEN);
+        active = false;
+        paused = false;
+    }
+
+    void TransformFeedback::pause() {
+        bind();
+        glPauseTransformFeedback();
+        paused = true;
+    }
+
+    void TransformFeedback::resume() {
+        bind();
+        glResumeTransformFeedback();
+        paused = false;
+    }
+
+    bool TransformFeedback::isActive() const {
+        return active;
+    }
+
+    bool TransformFeedback::isPaused() const {
+        return paused;
+    }
+
+    bool TransformFeedback::isResultAvailable() const {
+        GLuint available = GL_FALSE;
+        glGetQueryObjectuiv(query, GL_QUERY_RESULT_AVAILABLE, &available);
+        return available != GL_FALSE;
+    }
+
+    GLuint TransformFeedback::getPrimitivesWritten() const {
+        GLuint primitives = 0;
+        glGetQueryObjectuiv(query, GL_QUERY_RESULT, &primitives);
+        return primitives;
+    }
+
+    void TransformFeedback::draw(Buffer::Mode mode) const {
+        glDrawTransformFeedback(mode, feedback);
+    }
+
+    void TransformFeedback::drawInstanced(Buffer::Mode mode,
+                                          GLsizei primcount) const {
+        if (!isInstancedSupported())
+            throw TransformFeedbackException(
+                "Instanced transform feedback draws are not supported");
+        glDrawTransformFeedbackInstanced(mode, feedback, primcount);
+    }
+
+    bool TransformFeedback::isSupported() {
+        return GLEW_VERSION_4_0 || GLEW_ARB_transform_feedback2;
+    }
+
+    bool TransformFeedback::isInstancedSupported() {
+        return GLEW_VERSION_4_2 || GLEW_ARB_transform_feedback_instanced;
+    }
+}
@@ -0,0 +1,200 @@
+#include "glpp/Uploader.hpp"
+
+#include <stb_image.h>
+
+#include "glpp/StateCache.hpp"
+
+namespace glpp {
+    Uploader::Ticket::State::~State() {
+        if (fence)
+            glDeleteSync(fence);
+    }
+
+    void Uploader::Ticket::State::forgetTextures() {
+        for (GLuint id : textures) {
+            if (auto cache = StateCache::existing())
+                cache->deleteTexture(id);
+        }
+        textures.clear();
+    }
+
+    Uploader::Ticket::Ticket(shared_ptr<State> state)
+        : state(std::move(state)) {}
+
+    Uploader::Ticket::Ticket() : state(std::make_shared<State>()) {
+        state->done = true;
+    }
+
+    bool Uploader::Ticket::isReady() const {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        if (!state->done)
+            return false;
+        state->forgetTextures();
+        if (!state->fence)
+            return true;
+
+        GLenum result = glClientWaitSync(state->fence, 0, 0);
+        return result == GL_ALREADY_SIGNALED
+               || result == GL_CONDITION_SATISFIED;
+    }
+
+    void Uploader::Ticket::wait() const {
+        std::unique_lock<std::mutex> lock(state->mutex);
+        state->cv.wait(lock, [this] { return state->done; });
+        state->forgetTextures();
+        if (state->error)
+            std::rethrow_exception(state->error);
+        if (state->fence)
+            glWaitSync(state->fence, 0, GL_TIMEOUT_IGNORED);
+    }
+}
+
+namespace glpp {
+    Uploader::Uploader(std::function<void()> makeCurrent,
+                       std::function<void()> release)
+        : makeCurrent(std::move(makeCurrent)),
+          release(std::move(release)),
+          busy(false),
+          stopping(false) {
+        thread = std::thread(&Uploader::run, this);
+    }
+
+    Uploader::~Uploader() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wake.notify_one();
+        thread.join();
+    }
+
+    void Uploader::run() {
+        makeCurrent();
+
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true) {
+            wake.wait(lock, [this] { return stopping || !tasks.empty(); });
+            if (tasks.empty())
+                break;
+
+            Task task = std::move(tasks.front());
+            tasks.pop_front();
+            busy = true;
+            lock.unlock();
+
+            std::exception_ptr error;
+            try {
+                task.job();
+            }
+            catch (...) {
+                error = std::current_exception();
+            }
+
+            // Flush so the fence is visible to the render context
+            GLsync fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+            glFlush();
+
+            {
+                std::lock_guard<std::mutex> stateLock(task.state->mutex);
+                task.state->fence = fence;
+                task.state->error = error;
+                task.state->done = true;
+            }
+            task.state->cv.notify_all();
+
+            lock.lock();
+            busy = false;
+            if (tasks.empty())
+                idle.notify_all();
+        }
+        lock.unlock();
+
+        if (release)
+            release();
+    }
+
+    void Uploader::enqueue(Task task) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            tasks.push_back(std::move(task));
+        }
+        wake.notify_one();
+    }
+
+    Uploader::Ticket Uploader::submit(Job job) {
+        Ticket ticket(std::make_shared<Ticket::State>());
+        enqueue({std::move(job), ticket.state});
+        return ticket;
+    }
+
+    void Uploader::loadInto(Ticket::State * state,
+                            const Texture::Ptr & texture,
+                            const std::function<void()> & load) {
+        GLuint oldId = texture->getTextureId();
+        std::exception_ptr error;
+        try {
+            load();
+        }
+        catch (...) {
+            error = std::current_exception();
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(state->mutex);
+            state->textures = {oldId, texture->getTextureId()};
+        }
+        if (error)
+            std::rethrow_exception(error);
+    }
+
+    Uploader::Ticket Uploader::loadTexture(Texture::Ptr texture,
+                                           vector<unsigned char> data,
+                                           const glm::uvec2 & size,
+                                           std::size_t nrComponents) {
+        Ticket ticket(std::make_shared<Ticket::State>());
+        // The task keeps the state alive while the job runs
+        auto * state = ticket.state.get();
+        auto job = [state, texture, data = std::move(data), size, nrComponents] {
+            loadInto(state, texture, [&] {
+                texture->loadFrom(data.data(), size, nrComponents);
+            });
+        };
+        enqueue({std::move(job), ticket.state});
+        return ticket;
+    }
+
+    Uploader::Ticket Uploader::loadTexture(Texture::Ptr texture,
+                                           const string & path) {
+        Ticket ticket(std::make_shared<Ticket::State>());
+        auto * state = ticket.state.get();
+        auto job = [state, texture, path] {
+            int x, y, n;
+            auto * data = stbi_load(path.c_str(), &x, &y, &n, 0);
+            if (!data)
+                throw TextureLoadException("Failed to load image from file");
+
+            try {
+                loadInto(state, texture, [&] {
+                    texture->loadFrom(data, glm::uvec2(x, y), n);
+                });
+            }
+            catch (...) {
+                stbi_image_free(data);
+                throw;
+            }
+            stbi_image_free(data);
+        };
+        enqueue({std::move(job), ticket.state});
+        return ticket;
+    }
+
+    std::size_t Uploader::getPending() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return tasks.size() + (busy ? 1 : 0);
+    }
+
+    void Uploader::finish() {
+        std::unique_lock<std::mutex> lock(mutex);
+        idle.wait(lock, [this] { return tasks.empty() && !busy; });
+    }
+}
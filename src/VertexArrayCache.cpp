@@ -0,0 +1,211 @@
+#include "glpp/VertexArrayCache.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+
+namespace glpp {
+    using std::make_shared;
+
+    // Smallest GL_MAX_VERTEX_ATTRIB_RELATIVE_OFFSET allowed by the spec
+    static constexpr std::uintptr_t maxRelativeOffset = 2047;
+
+    static void hashCombine(std::size_t & seed, std::size_t value) {
+        seed ^= value + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+    }
+
+    static std::size_t hashKey(const vector<Buffer::Attribute> & attributes,
+                               GLuint buffer,
+                               GLintptr offset) {
+        std::size_t seed = std::hash<GLuint>()(buffer);
+        hashCombine(seed, std::hash<GLintptr>()(offset));
+        for (auto & attr : attributes) {
+            hashCombine(seed, attr.index);
+            hashCombine(seed, attr.size);
+            hashCombine(seed, attr.type);
+            hashCombine(seed, attr.normalized);
+            hashCombine(seed, attr.stride);
+            hashCombine(seed, reinterpret_cast<std::uintptr_t>(attr.pointer));
+            hashCombine(seed, attr.divisor);
+            hashCombine(seed, attr.integer);
+        }
+        return seed;
+    }
+
+    static bool sameAttributes(const vector<Buffer::Attribute> & a,
+                               const vector<Buffer::Attribute> & b) {
+        return std::equal(
+            a.begin(), a.end(), b.begin(), b.end(),
+            [](const Buffer::Attribute & x, const Buffer::Attribute & y) {
+                return x.index == y.index && x.size == y.size
+                       && x.type == y.type && x.normalized == y.normalized
+                       && x.stride == y.stride && x.pointer == y.pointer
+                       && x.divisor == y.divisor && x.integer == y.integer;
+            });
+    }
+
+    VertexArrayCache::VertexArrayCache()
+        : attribBinding(GLEW_VERSION_4_3 || GLEW_ARB_vertex_attrib_binding) {}
+
+    bool VertexArrayCache::isShared(const vector<Buffer::Attribute> & attributes) const {
+        if (!attribBinding || attributes.empty())
+            return false;
+
+        // One binding point per array, glBindVertexBuffer needs an explicit
+        // stride and all attributes step at the same rate
+        auto & first = attributes.front();
+        return first.stride > 0
+               && std::all_of(attributes.begin(), attributes.end(),
+                              [&first](const Buffer::Attribute & attr) {
+                                  return attr.stride == first.stride
+                                         && attr.divisor == first.divisor
+                                         && reinterpret_cast<std::uintptr_t>(
+                                                attr.pointer)
+                                                <= maxRelativeOffset;
+                              });
+    }
+
+    VertexArrayCache::Entry VertexArrayCache::create(
+        const Buffer & buffer,
+        const vector<Buffer::Attribute> & attributes,
+        GLintptr offset,
+        bool shared) const {
+
+        auto array = make_shared<BufferArray>();
+        if (shared) {
+            array->bind();
+            for (auto & attr : attributes) {
+                GLuint relativeOffset =
+                    GLuint(reinterpret_cast<std::uintptr_t>(attr.pointer));
+                if (attr.integer)
+                    glVertexAttribIFormat(attr.index, attr.size, attr.type,
+                                          relativeOffset);
+                else
+                    glVertexAttribFormat(attr.index, attr.size, attr.type,
+                                         attr.normalized, relativeOffset);
+                glVertexAttribBinding(attr.index, 0);
+                glEnableVertexAttribArray(attr.index);
+            }
+            glVertexBindingDivisor(0, attributes.front().divisor);
+            return {attributes, 0, 0, array, 0, 0};
+        }
+
+        array->attach(buffer, attributes, offset);
+        return {attributes, buffer.getBufferId(), offset, array, 0, 0};
+    }
+
+    const BufferArray & VertexArrayCache::get(const Buffer & buffer,
+                                              const vector<Buffer::Attribute> & attributes,
+                                              GLintptr offset) {
+        bool shared = isShared(attributes);
+        GLuint keyBuffer = shared ? 0 : buffer.getBufferId();
+        GLintptr keyOffset = shared ? 0 : offset;
+        std::size_t hash = hashKey(attributes, keyBuffer, keyOffset);
+
+        auto range = arrays.equal_range(hash);
+        auto it = std::find_if(range.first, range.second, [&](auto & entry) {
+            return entry.second.buffer == keyBuffer
+                   && entry.second.offset == keyOffset
+                   && sameAttributes(entry.second.attributes, attributes);
+        });
+
+        if (it == range.second) {
+            counters.misses++;
+            it = arrays.emplace(hash, create(buffer, attributes, offset, shared));
+        }
+        else {
+            counters.hits++;
+        }
+
+        Entry & entry = it->second;
+        if (shared
+            && (entry.boundBuffer != buffer.getBufferId()
+                || entry.boundOffset != offset)) {
+            entry.array->bind();
+            glBindVertexBuffer(0, buffer.getBufferId(), offset,
+                               attributes.front().stride);
+            entry.boundBuffer = buffer.getBufferId();
+            entry.boundOffset = offset;
+        }
+        return *entry.array;
+    }
+
+    bool VertexArrayCache::hasVertexAttribBinding() const {
+        return attribBinding;
+    }
+
+    void VertexArrayCache::setVertexAttribBinding(bool enabled) {
+        clear();
+        attribBinding =
+            enabled && (GLEW_VERSION_4_3 || GLEW_ARB_vertex_attrib_binding);
+    }
+
+    std::size_t VertexArrayCache::size() const {
+        return arrays.size();
+    }
+
+    const VertexArrayCache::Counters & VertexArrayCache::getCounters() const {
+        return counters;
+    }
+
+    void VertexArrayCache::resetCounters() {
+        counters = Counters();
+    }
+
+    void VertexArrayCache::clear() {
+        arrays.clear();
+    }
+
+    void VertexArrayCache::deleteBuffer(GLuint buffer) {
+        for (auto it = arrays.begin(); it != arrays.end();) {
+            Entry & entry = it->second;
+            if (entry.buffer == buffer) {
+                it = arrays.erase(it);
+                continue;
+            }
+            // Release the buffer from a shared layout, the array would keep
+            // its storage alive until the next get
+            if (entry.boundBuffer == buffer) {
+                entry.array->bind();
+                glBindVertexBuffer(0, 0, 0, entry.attributes.front().stride);
+                entry.boundBuffer = 0;
+                entry.boundOffset = 0;
+            }
+            ++it;
+        }
+    }
+
+    void VertexArrayCache::releaseRange(GLuint buffer,
+                                        GLintptr offset,
+                                        GLsizeiptr size) {
+        for (auto it = arrays.begin(); it != arrays.end();) {
+            Entry & entry = it->second;
+            if (entry.buffer == buffer && entry.offset >= offset
+                && entry.offset < offset + size)
+                it = arrays.erase(it);
+            else
+                ++it;
+        }
+    }
+
+    // Points at the cache of the thread while it exists, thread_local
+    // pointers are never destroyed so this is safe to read at exit
+    static thread_local VertexArrayCache * threadCache = nullptr;
+
+    VertexArrayCache & VertexArrayCache::current() {
+        thread_local struct Holder {
+            VertexArrayCache cache;
+            Holder() {
+                threadCache = &cache;
+            }
+            ~Holder() {
+                threadCache = nullptr;
+            }
+        } holder;
+        return holder.cache;
+    }
+
+    VertexArrayCache * VertexArrayCache::existing() {
+        return threadCache;
+    }
+}
@@ -105,4 +105,28 @@ namespace glpp::extra {
         else
             return glm::ortho<float>(0, screenSize.x, screenSize.y, 0);
     }
+
+    FrameUniforms Camera::frameUniforms() const {
+        glm::mat4 view = viewMatrix();
+        glm::mat4 proj = projMatrix();
+
+        FrameUniforms frame;
+        frame.view = view;
+        frame.projection = proj;
+        frame.viewProj = proj * view;
+        frame.cameraPos = pos;
+        frame.screenSize = glm::vec2(screenSize);
+        return frame;
+    }
+
+    void Camera::bindFrame() const {
+        auto & block = frameBlock();
+        block.set(frameUniforms());
+        block.bindBase(FrameUniforms::binding);
+    }
+
+    UniformBlock<FrameUniforms> & Camera::frameBlock() {
+        static UniformBlock<FrameUniforms> block;
+        return block;
+    }
 }
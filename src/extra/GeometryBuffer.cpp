@@ -2,6 +2,8 @@
 
 #include <string_view>
 
+#include "glpp/UniformBlock.hpp"
+
 namespace glpp::extra {
     using std::make_shared;
 
@@ -73,11 +75,16 @@ layout (location = 2) in vec2 aTex;
 out vec3 FragPos;
 out vec3 FragNorm;
 out vec2 FragTex;
+layout (std140) uniform Frame {
+    mat4 view;
+    mat4 projection;
+    mat4 viewProj;
+    vec3 cameraPos;
+    vec2 screenSize;
+};
 uniform mat4 model;
-uniform mat4 vp;
 void main() {
-    mat4 mvp = vp * model;
-    gl_Position = mvp * vec4(aPos, 1.0);
+    gl_Position = viewProj * model * vec4(aPos, 1.0);
     FragPos = vec3(model * vec4(aPos, 1.0));
     FragNorm = aNorm;
     FragTex = aTex;
@@ -103,9 +110,18 @@ void main() {
     oSpecular = 1.0;
 })";
 
+    // Submitted by warmShader and created by the first call to getShader()
+    static WarmShader geometryShader(geometryVertexShaderSource,
+                                     geometryFragmentShaderSource,
+                                     [](Shader & shader) {
+                                         shader.bindUniformBlock("Frame", FrameUniforms::binding);
+                                     });
+
+    void GeometryBuffer::warmShader(ShaderBuilder & builder) {
+        geometryShader.warm(builder);
+    }
+
     Shader & GeometryBuffer::getShader() {
-        static Shader shader(geometryVertexShaderSource,
-                             geometryFragmentShaderSource);
-        return shader;
+        return geometryShader.get();
     }
 }
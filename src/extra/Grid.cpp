@@ -1,15 +1,27 @@
 #include "glpp/extra/Grid.hpp"
 
+#include <algorithm>
 #include <vector>
 
+#include "glpp/UniformBlock.hpp"
+#include "glpp/VertexArrayCache.hpp"
+#include "glpp/VertexLayout.hpp"
+
 static const char * vertexShaderSource = R"(
 #version 330 core
 layout (location = 0) in vec3 aPos;
 layout (location = 1) in vec4 aCol;
-uniform mat4 mvp;
+layout (std140) uniform Frame {
+    mat4 view;
+    mat4 projection;
+    mat4 viewProj;
+    vec3 cameraPos;
+    vec2 screenSize;
+};
+uniform mat4 model;
 out vec4 color;
 void main() {
-    gl_Position = mvp * vec4(aPos, 1.0);
+    gl_Position = viewProj * model * vec4(aPos, 1.0);
     color = aCol;
 })";
 
@@ -23,7 +35,9 @@ void main() {
 
 namespace glpp::extra {
     using std::vector;
-    using std::make_shared;
+
+    using ColorAttributes =
+        VertexLayout<ColorVertex, &ColorVertex::pos, &ColorVertex::color>;
 
     void Grid::updateBuffer() {
         vector<glm::vec3> vertices;
@@ -102,21 +116,29 @@ namespace glpp::extra {
 
         n = vertices.size();
 
-        array->bind();
-        array->bufferData(0, n * sizeof(glm::vec3), vertices.data());
-        array->bufferData(1, n * sizeof(glm::vec4), colors.data());
-        array->unbind();
+        // Interleave position and color into a block of the shared arena
+        vector<ColorVertex> data;
+        data.reserve(n);
+        for (int i = 0; i < n; i++) {
+            data.push_back({vertices[i], colors[i]});
+        }
+
+        GLsizeiptr dataSize = n * sizeof(ColorVertex);
+        // Grow geometrically so frequent updates reuse the block
+        if (!block)
+            block = BufferArena::current().allocate(dataSize);
+        else if (block->size < dataSize)
+            block = BufferArena::current().allocate(
+                std::max(dataSize, 2 * block->size));
+
+        block->bufferSubData(0, dataSize, data.data());
     }
 
     Grid::Grid(int size, const glm::vec4 & color, bool colorAxis)
         : n(0),
           size(size),
           color(color),
-          colorAxis(colorAxis),
-          array(make_shared<BufferArray>(vector<vector<Buffer::Attribute>> {
-              {Buffer::Attribute {0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), 0}},
-              {Buffer::Attribute {1, 4, GL_FLOAT, GL_FALSE, 4 * sizeof(float), 0}},
-          })) {
+          colorAxis(colorAxis) {
         updateBuffer();
     }
 
@@ -152,18 +174,33 @@ namespace glpp::extra {
     }
 
     void Grid::draw() const {
-        // drawArrays calls bind
-        array->drawArrays(Buffer::Lines, 0, n);
+        static const auto attributes = ColorAttributes::attributes();
+
+        // The block is looked up on each draw, so it may be moved by
+        // BufferArena::defragment. drawArrays calls bind
+        VertexArrayCache::current()
+            .get(*block->buffer, attributes, block->offset)
+            .drawArrays(Buffer::Lines, 0, n);
     }
 
     void Grid::draw(const glm::mat4 & transform) const {
         shader().bind();
-        shader().uniform("mvp").setMat4(transform);
+        shader().uniform<"model"_h>().setMat4(transform);
         draw();
     }
 
+    // Submitted by warmShader and created by the first call to shader()
+    static WarmShader gridShader(vertexShaderSource,
+                                 fragmentShaderSource,
+                                 [](Shader & shader) {
+                                     shader.bindUniformBlock("Frame", FrameUniforms::binding);
+                                 });
+
+    void Grid::warmShader(ShaderBuilder & builder) {
+        gridShader.warm(builder);
+    }
+
     Shader & Grid::shader() {
-        static Shader shader(vertexShaderSource, fragmentShaderSource);
-        return shader;
+        return gridShader.get();
     }
 }
@@ -1,15 +1,27 @@
 #include "glpp/extra/Line.hpp"
 
+#include <algorithm>
 #include <vector>
 
+#include "glpp/UniformBlock.hpp"
+#include "glpp/VertexArrayCache.hpp"
+#include "glpp/VertexLayout.hpp"
+
 static const char * vertexShaderSource = R"(
 #version 330 core
 layout (location = 0) in vec3 aPos;
 layout (location = 1) in vec4 aCol;
-uniform mat4 mvp;
+layout (std140) uniform Frame {
+    mat4 view;
+    mat4 projection;
+    mat4 viewProj;
+    vec3 cameraPos;
+    vec2 screenSize;
+};
+uniform mat4 model;
 out vec4 color;
 void main() {
-    gl_Position = mvp * vec4(aPos, 1.0);
+    gl_Position = viewProj * model * vec4(aPos, 1.0);
     color = aCol;
 })";
 
@@ -21,35 +33,36 @@ void main() {
     FragColor = color;
 })";
 
-#define ARRAY                                                                 \
-    make_shared<BufferArray>(vector<vector<Buffer::Attribute>> {              \
-        {Buffer::Attribute {0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), 0}}, \
-        {Buffer::Attribute {1, 4, GL_FLOAT, GL_FALSE, 4 * sizeof(float), 0}}, \
-    })
-
 namespace glpp::extra {
     using std::vector;
-    using std::make_shared;
+
+    using ColorAttributes =
+        VertexLayout<ColorVertex, &ColorVertex::pos, &ColorVertex::color>;
 
     void Line::updateBuffer() {
-        vector<glm::vec3> vertices = points;
-        vector<glm::vec4> colors;
+        n = points.size();
 
         // Ignore last point if there are an odd number of points
-        if (mode == Lines && vertices.size() % 2 == 1) {
-            vertices.pop_back();
+        if (mode == Lines && n % 2 == 1) {
+            n--;
         }
 
-        for (int i = 0; i < vertices.size(); i++) {
-            colors.push_back(color);
+        // Interleave position and color into a block of the shared arena
+        vector<ColorVertex> data;
+        data.reserve(n);
+        for (int i = 0; i < n; i++) {
+            data.push_back({points[i], color});
         }
 
-        n = vertices.size();
+        GLsizeiptr dataSize = n * sizeof(ColorVertex);
+        // Grow geometrically so frequent updates reuse the block
+        if (!block)
+            block = BufferArena::current().allocate(dataSize);
+        else if (block->size < dataSize)
+            block = BufferArena::current().allocate(
+                std::max(dataSize, 2 * block->size));
 
-        array->bind();
-        array->bufferData(0, n * sizeof(glm::vec3), vertices.data());
-        array->bufferData(1, n * sizeof(glm::vec4), colors.data());
-        array->unbind();
+        block->bufferSubData(0, dataSize, data.data());
     }
 
     Line::Line(const glm::vec4 & color, Mode mode) : Line({}, color, mode) {}
@@ -57,12 +70,18 @@ namespace glpp::extra {
     Line::Line(const std::vector<glm::vec3> & points,
                const glm::vec4 & color,
                Mode mode)
-        : n(0), mode(mode), color(color), points(points), array(ARRAY) {
+        : n(0),
+          mode(mode),
+          color(color),
+          points(points) {
         updateBuffer();
     }
 
     Line::Line(std::vector<glm::vec3> && points, const glm::vec4 & color, Mode mode)
-        : n(0), mode(mode), color(color), points(std::move(points)), array(ARRAY) {
+        : n(0),
+          mode(mode),
+          color(color),
+          points(std::move(points)) {
         updateBuffer();
     }
 
@@ -75,14 +94,14 @@ namespace glpp::extra {
     Line::~Line() {}
 
     Line::Line(Line && other)
-        : array(std::move(other.array)),
+        : block(std::move(other.block)),
           n(other.n),
           mode(other.mode),
           color(other.color),
           points(std::move(other.points)) {}
 
     Line & Line::operator=(Line && other) {
-        array = std::move(other.array);
+        block = std::move(other.block);
         n = other.n;
         mode = other.mode;
         color = other.color;
@@ -134,18 +153,33 @@ namespace glpp::extra {
     }
 
     void Line::draw() const {
-        // drawArrays calls bind
-        array->drawArrays((Buffer::Mode)mode, 0, n);
+        static const auto attributes = ColorAttributes::attributes();
+
+        // The block is looked up on each draw, so it may be moved by
+        // BufferArena::defragment. drawArrays calls bind
+        VertexArrayCache::current()
+            .get(*block->buffer, attributes, block->offset)
+            .drawArrays((Buffer::Mode)mode, 0, n);
     }
 
     void Line::draw(const glm::mat4 & transform) const {
         shader().bind();
-        shader().uniform("mvp").setMat4(transform);
+        shader().uniform<"model"_h>().setMat4(transform);
         draw();
     }
 
+    // Submitted by warmShader and created by the first call to shader()
+    static WarmShader lineShader(vertexShaderSource,
+                                 fragmentShaderSource,
+                                 [](Shader & shader) {
+                                     shader.bindUniformBlock("Frame", FrameUniforms::binding);
+                                 });
+
+    void Line::warmShader(ShaderBuilder & builder) {
+        lineShader.warm(builder);
+    }
+
     Shader & Line::shader() {
-        static Shader shader(vertexShaderSource, fragmentShaderSource);
-        return shader;
+        return lineShader.get();
     }
 }
@@ -0,0 +1,421 @@
+#include "glpp/extra/MeshFile.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace glpp::extra {
+    static const char magic[4] = {'G', 'L', 'P', 'M'};
+
+    using VertexAttributes =
+        VertexLayout<Vertex, &Vertex::pos, &Vertex::norm, &Vertex::uv>;
+
+    /**
+     * Round offset up to the next multiple of MeshFile::alignment.
+     *
+     * @param offset the offset in bytes
+     *
+     * @return the aligned offset
+     */
+    static std::size_t alignSection(std::size_t offset) {
+        return (offset + MeshFile::alignment - 1) & ~(MeshFile::alignment - 1);
+    }
+
+    static std::size_t attributeOffset() {
+        return alignSection(sizeof(MeshFileHeader));
+    }
+
+    static std::size_t vertexOffset(const MeshFileHeader & header) {
+        return alignSection(attributeOffset()
+                            + header.attributeCount * sizeof(MeshFileAttribute));
+    }
+
+    static std::size_t indexOffset(const MeshFileHeader & header) {
+        return alignSection(vertexOffset(header)
+                            + header.vertexCount * header.vertexStride);
+    }
+
+    static std::size_t indexSize(const MeshFileHeader & header) {
+        if (header.indexCount == 0)
+            return 0;
+        return header.indexCount * ElementBuffer::typeSize(header.indexType);
+    }
+
+    /**
+     * Check that every section described by header ends within size bytes.
+     * The counts come from the file, so each product is checked by division
+     * before it is computed.
+     *
+     * @param header the file header, with a valid index type
+     * @param size the file size in bytes
+     *
+     * @return true if the attributes, vertices and indices fit
+     */
+    static bool sectionsFit(const MeshFileHeader & header, std::size_t size) {
+        std::size_t offset = attributeOffset();
+        if (offset > size
+            || header.attributeCount > (size - offset) / sizeof(MeshFileAttribute))
+            return false;
+
+        offset = vertexOffset(header);
+        if (offset > size
+            || (header.vertexStride > 0
+                && header.vertexCount > (size - offset) / header.vertexStride))
+            return false;
+
+        offset = indexOffset(header);
+        if (offset > size)
+            return false;
+        return header.indexCount == 0
+               || header.indexCount
+                      <= (size - offset) / ElementBuffer::typeSize(header.indexType);
+    }
+
+    /**
+     * Get the number of bytes one vertex of an attribute reads. Packed types
+     * hold all components in 4 bytes.
+     *
+     * @param record the attribute record from the file
+     *
+     * @return the size in bytes, 0 for an invalid size or unknown type
+     */
+    static std::size_t attributeBytes(const MeshFileAttribute & record) {
+        if (record.size < 1 || record.size > 4)
+            return 0;
+
+        std::size_t size = record.size;
+        switch (record.type) {
+            case GL_BYTE:
+            case GL_UNSIGNED_BYTE:
+                return size;
+            case GL_SHORT:
+            case GL_UNSIGNED_SHORT:
+            case GL_HALF_FLOAT:
+                return 2 * size;
+            case GL_INT:
+            case GL_UNSIGNED_INT:
+            case GL_FLOAT:
+            case GL_FIXED:
+                return 4 * size;
+            case GL_DOUBLE:
+                return 8 * size;
+            case GL_INT_2_10_10_10_REV:
+            case GL_UNSIGNED_INT_2_10_10_10_REV:
+                return size == 4 ? 4 : 0;
+            case GL_UNSIGNED_INT_10F_11F_11F_REV:
+                return size == 3 ? 4 : 0;
+            default:
+                return 0;
+        }
+    }
+
+    /**
+     * Check that every attribute has a valid size and type and reads within
+     * one vertex. The records must fit in the file, see sectionsFit.
+     *
+     * @param header the file header
+     * @param mapping the start of the file
+     *
+     * @return true if all attributes are valid
+     */
+    static bool attributesFit(const MeshFileHeader & header,
+                              const unsigned char * mapping) {
+        auto * records =
+            reinterpret_cast<const MeshFileAttribute *>(mapping + attributeOffset());
+        for (std::uint32_t i = 0; i < header.attributeCount; i++) {
+            std::size_t bytes = attributeBytes(records[i]);
+            if (bytes == 0 || records[i].offset > header.vertexStride
+                || bytes > header.vertexStride - records[i].offset)
+                return false;
+        }
+        return true;
+    }
+}
+
+namespace glpp::extra {
+    MeshFile::MeshFile(const string & path)
+        : mapping(nullptr), mappingSize(0), handle(nullptr) {
+#ifdef _WIN32
+        HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ,
+                                  NULL, OPEN_EXISTING,
+                                  FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+        if (file == INVALID_HANDLE_VALUE)
+            throw MeshFileException("Failed to open mesh file " + path);
+
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(file, &size) || size.QuadPart < sizeof(MeshFileHeader)) {
+            CloseHandle(file);
+            throw MeshFileException("Mesh file is too small " + path);
+        }
+        mappingSize = size.QuadPart;
+
+        handle = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+        CloseHandle(file);
+        if (!handle)
+            throw MeshFileException("Failed to map mesh file " + path);
+
+        mapping = static_cast<const unsigned char *>(
+            MapViewOfFile(handle, FILE_MAP_READ, 0, 0, 0));
+        if (!mapping) {
+            CloseHandle(handle);
+            throw MeshFileException("Failed to map mesh file " + path);
+        }
+#else
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+            throw MeshFileException("Failed to open mesh file " + path);
+
+        struct stat info;
+        if (fstat(fd, &info) != 0 || info.st_size < (off_t)sizeof(MeshFileHeader)) {
+            close(fd);
+            throw MeshFileException("Mesh file is too small " + path);
+        }
+        mappingSize = info.st_size;
+
+        void * address = mmap(nullptr, mappingSize, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (address == MAP_FAILED)
+            throw MeshFileException("Failed to map mesh file " + path);
+
+        // The whole file is uploaded, start reading it in now
+        madvise(address, mappingSize, MADV_WILLNEED);
+        mapping = static_cast<const unsigned char *>(address);
+#endif
+
+        const MeshFileHeader & h = header();
+        if (std::memcmp(h.magic, magic, sizeof(magic)) != 0) {
+            unmap();
+            throw MeshFileException("Not a mesh file " + path);
+        }
+        if (h.version != version) {
+            unmap();
+            throw MeshFileException("Unsupported mesh file version " + path);
+        }
+        if (h.indexCount > 0 && h.indexType != GL_UNSIGNED_BYTE
+            && h.indexType != GL_UNSIGNED_SHORT && h.indexType != GL_UNSIGNED_INT) {
+            unmap();
+            throw MeshFileException("Invalid index type in mesh file " + path);
+        }
+        if (!sectionsFit(h, mappingSize)) {
+            unmap();
+            throw MeshFileException("Mesh file is truncated " + path);
+        }
+        if (!attributesFit(h, mapping)) {
+            unmap();
+            throw MeshFileException("Invalid attribute in mesh file " + path);
+        }
+    }
+
+    MeshFile::MeshFile(MeshFile && other)
+        : mapping(other.mapping),
+          mappingSize(other.mappingSize),
+          handle(other.handle) {
+        other.mapping = nullptr;
+        other.mappingSize = 0;
+        other.handle = nullptr;
+    }
+
+    MeshFile & MeshFile::operator=(MeshFile && other) {
+        unmap();
+        mapping = other.mapping;
+        mappingSize = other.mappingSize;
+        handle = other.handle;
+        other.mapping = nullptr;
+        other.mappingSize = 0;
+        other.handle = nullptr;
+        return *this;
+    }
+
+    MeshFile::~MeshFile() {
+        unmap();
+    }
+
+    void MeshFile::unmap() {
+        if (!mapping)
+            return;
+#ifdef _WIN32
+        UnmapViewOfFile(mapping);
+        CloseHandle(handle);
+#else
+        munmap(const_cast<unsigned char *>(mapping), mappingSize);
+#endif
+        mapping = nullptr;
+        mappingSize = 0;
+        handle = nullptr;
+    }
+
+    const MeshFileHeader & MeshFile::header() const {
+        return *reinterpret_cast<const MeshFileHeader *>(mapping);
+    }
+
+    vector<Buffer::Attribute> MeshFile::getAttributes() const {
+        const MeshFileHeader & h = header();
+        auto * records =
+            reinterpret_cast<const MeshFileAttribute *>(mapping + attributeOffset());
+
+        vector<Buffer::Attribute> attributes;
+        attributes.reserve(h.attributeCount);
+        for (std::uint32_t i = 0; i < h.attributeCount; i++) {
+            const MeshFileAttribute & r = records[i];
+            attributes.emplace_back(r.index, r.size, r.type, r.normalized != 0,
+                                    h.vertexStride,
+                                    reinterpret_cast<const void *>(
+                                        std::uintptr_t(r.offset)),
+                                    r.divisor, r.integer != 0);
+        }
+        return attributes;
+    }
+
+    GLsizei MeshFile::getStride() const {
+        return header().vertexStride;
+    }
+
+    std::size_t MeshFile::getVertexCount() const {
+        return header().vertexCount;
+    }
+
+    std::size_t MeshFile::getIndexCount() const {
+        return header().indexCount;
+    }
+
+    GLenum MeshFile::getIndexType() const {
+        return header().indexCount > 0 ? header().indexType : 0;
+    }
+
+    MeshBounds MeshFile::getBounds() const {
+        const MeshFileHeader & h = header();
+        return {glm::vec3(h.boundsMin[0], h.boundsMin[1], h.boundsMin[2]),
+                glm::vec3(h.boundsMax[0], h.boundsMax[1], h.boundsMax[2])};
+    }
+
+    const void * MeshFile::getVertexData() const {
+        return mapping + vertexOffset(header());
+    }
+
+    std::size_t MeshFile::getVertexDataSize() const {
+        return header().vertexCount * header().vertexStride;
+    }
+
+    const void * MeshFile::getIndexData() const {
+        return mapping + indexOffset(header());
+    }
+
+    std::size_t MeshFile::getIndexDataSize() const {
+        return indexSize(header());
+    }
+
+    void MeshFile::upload(BufferArray & array, Buffer::Usage usage) const {
+        array.bufferData(0, getVertexDataSize(), getVertexData(), usage);
+        if (getIndexCount() > 0)
+            array.bufferElements(getIndexDataSize(), getIndexData(), usage,
+                                 getIndexType());
+    }
+
+    BufferArray::Ptr MeshFile::createArray(Buffer::Usage usage) const {
+        auto array = std::make_shared<BufferArray>(
+            vector<vector<Buffer::Attribute>> {getAttributes()});
+        upload(*array, usage);
+        return array;
+    }
+
+    void MeshFile::write(const string & path,
+                         const vector<Buffer::Attribute> & attributes,
+                         GLsizei stride,
+                         std::size_t vertexCount,
+                         const void * vertices,
+                         std::size_t indexCount,
+                         GLenum indexType,
+                         const void * indices,
+                         const MeshBounds & bounds) {
+        MeshFileHeader header {};
+        std::memcpy(header.magic, magic, sizeof(magic));
+        header.version = version;
+        header.attributeCount = attributes.size();
+        header.indexType = indexCount > 0 ? indexType : 0;
+        header.vertexCount = vertexCount;
+        header.indexCount = indexCount;
+        header.vertexStride = stride;
+        for (int i = 0; i < 3; i++) {
+            header.boundsMin[i] = bounds.min[i];
+            header.boundsMax[i] = bounds.max[i];
+        }
+
+        std::ofstream os(path, std::ios::binary | std::ios::trunc);
+        if (!os)
+            throw MeshFileException("Failed to open mesh file " + path);
+
+        static const char padding[alignment] = {};
+        auto pad = [&os](std::size_t offset) {
+            os.write(padding, alignSection(offset) - offset);
+            return alignSection(offset);
+        };
+
+        os.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        std::size_t offset = pad(sizeof(header));
+
+        for (auto & attr : attributes) {
+            MeshFileAttribute record {};
+            record.index = attr.index;
+            record.size = attr.size;
+            record.type = attr.type;
+            record.normalized = attr.normalized;
+            record.offset = reinterpret_cast<std::uintptr_t>(attr.pointer);
+            record.divisor = attr.divisor;
+            record.integer = attr.integer;
+            os.write(reinterpret_cast<const char *>(&record), sizeof(record));
+        }
+        offset = pad(offset + attributes.size() * sizeof(MeshFileAttribute));
+
+        std::size_t vertexBytes = vertexCount * stride;
+        os.write(static_cast<const char *>(vertices), vertexBytes);
+        offset = pad(offset + vertexBytes);
+
+        os.write(static_cast<const char *>(indices), indexSize(header));
+
+        if (!os)
+            throw MeshFileException("Failed to write mesh file " + path);
+    }
+
+    void MeshFile::write(const string & path, const IndexedMesh & mesh) {
+        GLenum type = mesh.getIndexType();
+
+        // Narrow the indices the same way ElementBuffer does
+        vector<unsigned char> indices(mesh.indices.size()
+                                      * ElementBuffer::typeSize(type));
+        for (std::size_t i = 0; i < mesh.indices.size(); i++) {
+            GLuint index = mesh.indices[i];
+            if (type == GL_UNSIGNED_BYTE)
+                indices[i] = index;
+            else if (type == GL_UNSIGNED_SHORT)
+                reinterpret_cast<GLushort *>(indices.data())[i] = index;
+            else
+                reinterpret_cast<GLuint *>(indices.data())[i] = index;
+        }
+
+        write(path, VertexAttributes::attributes(), VertexAttributes::stride,
+              mesh.vertices.size(), mesh.vertices.data(), mesh.indices.size(),
+              type, indices.data(), boundsOf(mesh.vertices));
+    }
+
+    MeshBounds MeshFile::boundsOf(const vector<Vertex> & vertices) {
+        if (vertices.empty())
+            return {glm::vec3(0), glm::vec3(0)};
+
+        MeshBounds bounds {vertices[0].pos, vertices[0].pos};
+        for (auto & v : vertices) {
+            bounds.min = glm::min(bounds.min, v.pos);
+            bounds.max = glm::max(bounds.max, v.pos);
+        }
+        return bounds;
+    }
+}
@@ -0,0 +1,268 @@
+#include "glpp/extra/MeshOptimizer.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+namespace glpp::extra {
+    // Tuning values from Tom Forsyth's "Linear-Speed Vertex Cache
+    // Optimisation"
+    static constexpr std::size_t cacheSize = 32;
+    static constexpr float cacheDecayPower = 1.5f;
+    static constexpr float lastTriScore = 0.75f;
+    static constexpr float valenceBoostScale = 2.0f;
+    static constexpr float valenceBoostPower = 0.5f;
+
+    /**
+     * Get the score of a vertex from its position in the simulated LRU cache
+     * and the number of triangles that still use it.
+     *
+     * @param cachePos the position in the cache, -1 if not in the cache
+     * @param remaining the number of triangles not yet added using the vertex
+     *
+     * @return the vertex score
+     */
+    static float vertexScore(int cachePos, std::size_t remaining) {
+        if (remaining == 0)
+            return -1.0f;
+
+        float score = 0.0f;
+        if (cachePos >= 0) {
+            // The last triangle's vertices get a fixed score so the next
+            // triangle does not always reuse the same edge
+            if (cachePos < 3) {
+                score = lastTriScore;
+            }
+            else {
+                const float scale = 1.0f / (cacheSize - 3);
+                score = std::pow(1.0f - (cachePos - 3) * scale, cacheDecayPower);
+            }
+        }
+
+        // Favour vertices with few triangles left so they are finished and
+        // can leave the cache
+        score += valenceBoostScale
+                 * std::pow(float(remaining), -valenceBoostPower);
+        return score;
+    }
+
+    vector<GLuint> optimizeVertexCache(const vector<GLuint> & indices,
+                                       std::size_t vertexCount) {
+        const std::size_t triCount = indices.size() / 3;
+        const std::size_t none = ~std::size_t(0);
+
+        // Triangles using each vertex, stored in one array with offsets
+        vector<std::size_t> remaining(vertexCount, 0);
+        for (std::size_t i = 0; i < triCount * 3; i++) {
+            remaining[indices[i]]++;
+        }
+
+        vector<std::size_t> offsets(vertexCount + 1, 0);
+        for (std::size_t v = 0; v < vertexCount; v++) {
+            offsets[v + 1] = offsets[v] + remaining[v];
+        }
+
+        vector<std::size_t> adjacency(triCount * 3);
+        vector<std::size_t> fill(offsets.begin(), offsets.end() - 1);
+        for (std::size_t t = 0; t < triCount; t++) {
+            for (std::size_t k = 0; k < 3; k++) {
+                adjacency[fill[indices[t * 3 + k]]++] = t;
+            }
+        }
+
+        vector<int> cachePos(vertexCount, -1);
+        vector<float> score(vertexCount);
+        for (std::size_t v = 0; v < vertexCount; v++) {
+            score[v] = vertexScore(-1, remaining[v]);
+        }
+
+        vector<float> triScore(triCount);
+        vector<bool> added(triCount, false);
+        std::size_t best = none;
+        for (std::size_t t = 0; t < triCount; t++) {
+            triScore[t] = score[indices[t * 3]] + score[indices[t * 3 + 1]]
+                          + score[indices[t * 3 + 2]];
+            if (best == none || triScore[t] > triScore[best])
+                best = t;
+        }
+
+        vector<GLuint> output;
+        output.reserve(triCount * 3);
+
+        vector<GLuint> cache;
+        vector<GLuint> newCache;
+        cache.reserve(cacheSize + 3);
+        newCache.reserve(cacheSize + 3);
+        std::size_t scanCursor = 0;
+
+        while (output.size() < triCount * 3) {
+            // Dead end, continue with the next triangle not added in input
+            // order, which keeps this linear in the number of triangles
+            if (best == none) {
+                while (added[scanCursor])
+                    scanCursor++;
+                best = scanCursor;
+            }
+
+            added[best] = true;
+            newCache.clear();
+            for (std::size_t k = 0; k < 3; k++) {
+                GLuint v = indices[best * 3 + k];
+                output.push_back(v);
+                newCache.push_back(v);
+
+                // Remove the triangle from the vertex's remaining list
+                std::size_t begin = offsets[v];
+                std::size_t end = begin + remaining[v];
+                auto it = std::find(adjacency.begin() + begin,
+                                    adjacency.begin() + end, best);
+                std::iter_swap(it, adjacency.begin() + end - 1);
+                remaining[v]--;
+            }
+
+            for (GLuint v : cache) {
+                if (std::find(newCache.begin(), newCache.begin() + 3, v)
+                    == newCache.begin() + 3)
+                    newCache.push_back(v);
+            }
+
+            // Update scores of every vertex that entered, moved in or left
+            // the cache, then the triangles using them
+            for (std::size_t i = 0; i < newCache.size(); i++) {
+                GLuint v = newCache[i];
+                cachePos[v] = i < cacheSize ? int(i) : -1;
+                score[v] = vertexScore(cachePos[v], remaining[v]);
+            }
+
+            best = none;
+            for (GLuint v : newCache) {
+                for (std::size_t i = offsets[v]; i < offsets[v] + remaining[v]; i++) {
+                    std::size_t t = adjacency[i];
+                    triScore[t] = score[indices[t * 3]] + score[indices[t * 3 + 1]]
+                                  + score[indices[t * 3 + 2]];
+                    if (best == none || triScore[t] > triScore[best])
+                        best = t;
+                }
+            }
+
+            if (newCache.size() > cacheSize)
+                newCache.resize(cacheSize);
+            std::swap(cache, newCache);
+        }
+
+        return output;
+    }
+
+    vector<GLuint> optimizeOverdraw(const vector<GLuint> & indices,
+                                    const vector<glm::vec3> & positions) {
+        const std::size_t triCount = indices.size() / 3;
+
+        // A triangle that misses the cache on all vertices starts a new run
+        // in the cache optimized order, so splitting there is cheap
+        const std::size_t fifoSize = 16;
+        vector<std::size_t> stamp(positions.size(), 0);
+        std::size_t time = fifoSize + 1;
+
+        vector<std::size_t> clusters;
+        for (std::size_t t = 0; t < triCount; t++) {
+            std::size_t misses = 0;
+            for (std::size_t k = 0; k < 3; k++) {
+                GLuint v = indices[t * 3 + k];
+                if (time - stamp[v] > fifoSize) {
+                    stamp[v] = time++;
+                    misses++;
+                }
+            }
+            if (t == 0 || misses == 3)
+                clusters.push_back(t);
+        }
+        clusters.push_back(triCount);
+
+        // Area weighted centroid and normal of each cluster
+        const std::size_t clusterCount = clusters.size() - 1;
+        vector<glm::vec3> centroids(clusterCount, glm::vec3(0));
+        vector<glm::vec3> normals(clusterCount, glm::vec3(0));
+        vector<float> areas(clusterCount, 0.0f);
+        glm::vec3 meshCentroid(0);
+        float meshArea = 0.0f;
+
+        for (std::size_t c = 0; c < clusterCount; c++) {
+            for (std::size_t t = clusters[c]; t < clusters[c + 1]; t++) {
+                const glm::vec3 & a = positions[indices[t * 3]];
+                const glm::vec3 & b = positions[indices[t * 3 + 1]];
+                const glm::vec3 & d = positions[indices[t * 3 + 2]];
+
+                glm::vec3 normal = glm::cross(b - a, d - a);
+                float area = glm::length(normal);
+                glm::vec3 center = (a + b + d) / 3.0f;
+
+                centroids[c] += center * area;
+                normals[c] += normal;
+                areas[c] += area;
+            }
+            meshCentroid += centroids[c];
+            meshArea += areas[c];
+            if (areas[c] > 0.0f)
+                centroids[c] /= areas[c];
+        }
+        if (meshArea > 0.0f)
+            meshCentroid /= meshArea;
+
+        // Clusters far out along their normal are likely in front
+        vector<float> keys(clusterCount, 0.0f);
+        for (std::size_t c = 0; c < clusterCount; c++) {
+            float length = glm::length(normals[c]);
+            if (length > 0.0f)
+                keys[c] = glm::dot(centroids[c] - meshCentroid, normals[c] / length);
+        }
+
+        vector<std::size_t> order(clusterCount);
+        std::iota(order.begin(), order.end(), 0);
+        std::stable_sort(order.begin(), order.end(),
+                         [&keys](std::size_t a, std::size_t b) {
+                             return keys[a] > keys[b];
+                         });
+
+        vector<GLuint> output;
+        output.reserve(triCount * 3);
+        for (std::size_t c : order) {
+            output.insert(output.end(), indices.begin() + clusters[c] * 3,
+                          indices.begin() + clusters[c + 1] * 3);
+        }
+        return output;
+    }
+
+    vector<GLuint> vertexFetchRemap(const vector<GLuint> & indices,
+                                    std::size_t vertexCount,
+                                    std::size_t & usedCount) {
+        vector<GLuint> remap(vertexCount, ~0u);
+        usedCount = 0;
+        for (GLuint index : indices) {
+            if (remap[index] == ~0u)
+                remap[index] = GLuint(usedCount++);
+        }
+        return remap;
+    }
+
+    float averageCacheMissRatio(const vector<GLuint> & indices,
+                                std::size_t vertexCount,
+                                std::size_t cacheSize) {
+        const std::size_t triCount = indices.size() / 3;
+        if (triCount == 0)
+            return 0.0f;
+
+        // A vertex is cached while fewer than cacheSize vertices were added
+        // after it
+        vector<std::size_t> stamp(vertexCount, 0);
+        std::size_t time = cacheSize + 1;
+        std::size_t misses = 0;
+        for (std::size_t i = 0; i < triCount * 3; i++) {
+            GLuint v = indices[i];
+            if (time - stamp[v] > cacheSize) {
+                stamp[v] = time++;
+                misses++;
+            }
+        }
+        return float(misses) / triCount;
+    }
+}
@@ -1,5 +1,7 @@
 #include "glpp/extra/Quad.hpp"
 
+#include <iterator>
+
 namespace glpp::extra {
     using std::make_shared;
 
@@ -10,19 +12,31 @@ namespace glpp::extra {
         vertices[3] = vertices[5] = pos.y;
     }
 
+    void Quad::attachBlock() const {
+        void * texOffset = (void *)sizeof(vertices);
+        array->attach(*block->buffer,
+                      {
+                          {0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), 0},
+                          {1, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), texOffset},
+                      },
+                      block->offset);
+        blockVersion = block->version;
+    }
+
     Quad::Quad(const glm::vec2 & pos, const glm::vec2 & size)
-        : pos(pos),
-          size(size),
-          array(make_shared<BufferArray>(vector<vector<Buffer::Attribute>> {
-              {Buffer::Attribute {0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), 0}},
-              {Buffer::Attribute {1, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), 0}},
-          })),
-          vertices {0} {
+        : array(make_shared<BufferArray>()),
+          block(BufferArena::current().allocate(sizeof(vertices)
+                                                + sizeof(texCoords))),
+          blockVersion(0),
+          vertices {0},
+          pos(pos),
+          size(size) {
         updateBuffer();
-        array->bind();
-        array->bufferData(0, sizeof(vertices), vertices);
-        array->bufferData(1, sizeof(texCoords), texCoords);
-        array->bufferElements(sizeof(indices), indices);
+        // Positions followed by tex coords in a block of the shared arena
+        block->bufferSubData(0, sizeof(vertices), vertices);
+        block->bufferSubData(sizeof(vertices), sizeof(texCoords), texCoords);
+        attachBlock();
+        array->bufferElements(vector<GLuint>(std::begin(indices), std::end(indices)));
         array->unbind();
     }
 
@@ -44,7 +58,7 @@ namespace glpp::extra {
         this->pos = pos;
         updateBuffer();
         // bufferSubData calls bind
-        array->bufferSubData(0, 0, sizeof(vertices), vertices);
+        block->bufferSubData(0, sizeof(vertices), vertices);
     }
 
     const glm::vec2 & Quad::getSize() const {
@@ -55,11 +69,15 @@ namespace glpp::extra {
         this->size = size;
         updateBuffer();
         // bufferSubData calls bind
-        array->bufferSubData(0, 0, sizeof(vertices), vertices);
+        block->bufferSubData(0, sizeof(vertices), vertices);
     }
 
     void Quad::draw() const {
+        // Block was moved by BufferArena::defragment
+        if (block->version != blockVersion)
+            attachBlock();
+
         // drawElements calls bind
-        array->drawElements(Buffer::Triangles, 6, GL_UNSIGNED_INT, 0);
+        array->drawElements(Buffer::Triangles);
     }
 }
@@ -1,5 +1,19 @@
 #include "glpp/extra/Vertex.hpp"
 
+#include <cmath>
+#include <cstring>
+#include <unordered_map>
+
+#include "glpp/VertexLayout.hpp"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#if defined(__F16C__)
+#include <immintrin.h>
+#endif
+
 namespace glpp::extra {
     Vertex::Vertex() : pos(0), norm(0), uv(0) {}
 
@@ -38,13 +52,293 @@ namespace glpp::extra {
 }
 
 namespace glpp::extra {
-    static const vector<vector<Buffer::Attribute>> attrs {{
-        {0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), 0},
-        {1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void *)(3 * sizeof(float))},
-        {2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void *)(6 * sizeof(float))},
-    }};
+    /**
+     * Convert a float to a half float, rounding to nearest even.
+     *
+     * @param value the float value
+     *
+     * @return the half float bits
+     */
+    static std::uint16_t floatToHalf(float value) {
+        std::uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+
+        std::uint32_t sign = (bits >> 16) & 0x8000;
+        std::uint32_t exponent = (bits >> 23) & 0xFF;
+        std::uint32_t mantissa = bits & 0x7FFFFF;
+
+        // Infinity and NaN
+        if (exponent == 0xFF)
+            return sign | 0x7C00 | (mantissa ? 0x200 : 0);
+
+        int halfExponent = int(exponent) - 127 + 15;
+
+        // Too large, round to infinity
+        if (halfExponent >= 0x1F)
+            return sign | 0x7C00;
+
+        // Too small for a normal half, round to subnormal or zero
+        if (halfExponent <= 0) {
+            if (halfExponent < -10)
+                return sign;
+            mantissa |= 0x800000;
+            int shift = 14 - halfExponent;
+            std::uint32_t half = mantissa >> shift;
+            std::uint32_t rest = mantissa & ((1u << shift) - 1);
+            std::uint32_t halfway = 1u << (shift - 1);
+            if (rest > halfway || (rest == halfway && (half & 1)))
+                half++;
+            return sign | half;
+        }
+
+        // A carry out of the mantissa correctly increments the exponent
+        std::uint32_t half = (std::uint32_t(halfExponent) << 10) | (mantissa >> 13);
+        std::uint32_t rest = mantissa & 0x1FFF;
+        if (rest > 0x1000 || (rest == 0x1000 && (half & 1)))
+            half++;
+        return sign | half;
+    }
+
+    /**
+     * Convert a half float to a float.
+     *
+     * @param half the half float bits
+     *
+     * @return the float value
+     */
+    static float halfToFloat(std::uint16_t half) {
+        std::uint32_t sign = std::uint32_t(half & 0x8000) << 16;
+        std::uint32_t exponent = (half >> 10) & 0x1F;
+        std::uint32_t mantissa = half & 0x3FF;
+
+        if (exponent == 0) {
+            float value = std::ldexp(float(mantissa), -24);
+            return sign ? -value : value;
+        }
+
+        std::uint32_t bits;
+        if (exponent == 0x1F)
+            bits = sign | 0x7F800000 | (mantissa << 13);
+        else
+            bits = sign | ((exponent + 112) << 23) | (mantissa << 13);
+
+        float value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+
+    /**
+     * Convert one component to a 10 bit signed normalized integer.
+     *
+     * @param value the component
+     *
+     * @return the low 10 bits of the packed component
+     */
+    static std::uint32_t packSnorm10(float value) {
+        value = std::fmin(std::fmax(value, -1.0f), 1.0f);
+        return std::uint32_t(std::int32_t(std::nearbyint(value * 511.0f)))
+               & 0x3FF;
+    }
+
+    /**
+     * Convert a 10 bit signed normalized integer to a float.
+     *
+     * @param bits the packed component in the low 10 bits
+     *
+     * @return the component
+     */
+    static float unpackSnorm10(std::uint32_t bits) {
+        // Sign extend from 10 bits
+        std::int32_t value = std::int32_t(bits << 22) >> 22;
+        return std::fmax(value / 511.0f, -1.0f);
+    }
+
+    PackedNormal::PackedNormal() : bits(0) {}
+
+    PackedNormal::PackedNormal(const glm::vec3 & norm)
+        : bits(packSnorm10(norm.x) | (packSnorm10(norm.y) << 10)
+               | (packSnorm10(norm.z) << 20)) {}
+
+    glm::vec3 PackedNormal::unpack() const {
+        return glm::vec3(unpackSnorm10(bits), unpackSnorm10(bits >> 10),
+                         unpackSnorm10(bits >> 20));
+    }
+
+    HalfVec2::HalfVec2() : x(0), y(0) {}
+
+    HalfVec2::HalfVec2(const glm::vec2 & v)
+        : x(floatToHalf(v.x)), y(floatToHalf(v.y)) {}
+
+    glm::vec2 HalfVec2::unpack() const {
+        return glm::vec2(halfToFloat(x), halfToFloat(y));
+    }
+
+    CompactVertex::CompactVertex() : pos(0), norm(), uv() {}
+
+    CompactVertex::CompactVertex(const Vertex & vertex)
+        : pos(vertex.pos), norm(vertex.norm), uv(vertex.uv) {}
+
+    Vertex CompactVertex::unpack() const {
+        return Vertex(pos, norm.unpack(), uv.unpack());
+    }
+
+    vector<CompactVertex> CompactVertex::fromVertices(const vector<Vertex> & vertices) {
+        vector<CompactVertex> compact(vertices.size());
+        std::size_t i = 0;
+
+#if defined(__SSE2__)
+        // Pack the normals and UVs of 4 vertices at a time
+        const __m128 lower = _mm_set1_ps(-1.0f);
+        const __m128 upper = _mm_set1_ps(1.0f);
+        const __m128 scale = _mm_set1_ps(511.0f);
+        const __m128i mask = _mm_set1_epi32(0x3FF);
+
+        for (; i + 4 <= vertices.size(); i += 4) {
+            const Vertex * v = &vertices[i];
+
+            __m128 x = _mm_setr_ps(v[0].norm.x, v[1].norm.x, v[2].norm.x,
+                                   v[3].norm.x);
+            __m128 y = _mm_setr_ps(v[0].norm.y, v[1].norm.y, v[2].norm.y,
+                                   v[3].norm.y);
+            __m128 z = _mm_setr_ps(v[0].norm.z, v[1].norm.z, v[2].norm.z,
+                                   v[3].norm.z);
+
+            // Clamp, scale and round to nearest even like packSnorm10
+            x = _mm_mul_ps(_mm_min_ps(_mm_max_ps(x, lower), upper), scale);
+            y = _mm_mul_ps(_mm_min_ps(_mm_max_ps(y, lower), upper), scale);
+            z = _mm_mul_ps(_mm_min_ps(_mm_max_ps(z, lower), upper), scale);
+
+            __m128i packed = _mm_or_si128(
+                _mm_or_si128(_mm_and_si128(_mm_cvtps_epi32(x), mask),
+                             _mm_slli_epi32(_mm_and_si128(_mm_cvtps_epi32(y), mask), 10)),
+                _mm_slli_epi32(_mm_and_si128(_mm_cvtps_epi32(z), mask), 20));
+
+            alignas(16) std::uint32_t normals[4];
+            _mm_store_si128(reinterpret_cast<__m128i *>(normals), packed);
+
+#if defined(__F16C__)
+            __m128i uv01 = _mm_cvtps_ph(
+                _mm_setr_ps(v[0].uv.x, v[0].uv.y, v[1].uv.x, v[1].uv.y),
+                _MM_FROUND_TO_NEAREST_INT);
+            __m128i uv23 = _mm_cvtps_ph(
+                _mm_setr_ps(v[2].uv.x, v[2].uv.y, v[3].uv.x, v[3].uv.y),
+                _MM_FROUND_TO_NEAREST_INT);
+            alignas(16) std::uint16_t halves[16];
+            _mm_store_si128(reinterpret_cast<__m128i *>(halves), uv01);
+            _mm_store_si128(reinterpret_cast<__m128i *>(halves + 8), uv23);
+#endif
 
-    VertexBufferArray::VertexBufferArray() : BufferArray(attrs) {}
+            for (std::size_t j = 0; j < 4; j++) {
+                CompactVertex & c = compact[i + j];
+                c.pos = v[j].pos;
+                c.norm.bits = normals[j];
+#if defined(__F16C__)
+                std::size_t h = j < 2 ? j * 2 : 8 + (j - 2) * 2;
+                c.uv.x = halves[h];
+                c.uv.y = halves[h + 1];
+#else
+                c.uv = HalfVec2(v[j].uv);
+#endif
+            }
+        }
+#endif
+
+        for (; i < vertices.size(); i++) {
+            compact[i] = CompactVertex(vertices[i]);
+        }
+        return compact;
+    }
+}
+
+namespace glpp::extra {
+    /**
+     * Position of a cell in the welding grid.
+     */
+    struct WeldCell {
+        long long x, y, z;
+
+        bool operator==(const WeldCell & other) const {
+            return x == other.x && y == other.y && z == other.z;
+        }
+    };
+
+    struct WeldCellHash {
+        std::size_t operator()(const WeldCell & cell) const {
+            // Large primes from "Optimized Spatial Hashing for Collision
+            // Detection of Deformable Objects"
+            return (std::size_t(cell.x) * 73856093u) ^ (std::size_t(cell.y) * 19349663u)
+                   ^ (std::size_t(cell.z) * 83492791u);
+        }
+    };
+
+    /**
+     * Check if all components of a and b differ by at most epsilon.
+     */
+    static bool nearlyEqual(const Vertex & a, const Vertex & b, float epsilon) {
+        for (int i = 0; i < 3; i++) {
+            if (std::fabs(a.pos[i] - b.pos[i]) > epsilon
+                || std::fabs(a.norm[i] - b.norm[i]) > epsilon)
+                return false;
+        }
+        return std::fabs(a.uv.x - b.uv.x) <= epsilon
+               && std::fabs(a.uv.y - b.uv.y) <= epsilon;
+    }
+
+    GLenum IndexedMesh::getIndexType() const {
+        if (vertices.empty())
+            return GL_UNSIGNED_BYTE;
+        return ElementBuffer::typeFor(vertices.size() - 1);
+    }
+
+    IndexedMesh IndexedMesh::weld(const vector<Vertex> & soup, float epsilon) {
+        IndexedMesh mesh;
+        mesh.indices.reserve(soup.size());
+
+        // Any cell size finds exact duplicates
+        const float cellSize = epsilon > 0 ? epsilon : 1.0f;
+        std::unordered_map<WeldCell, vector<GLuint>, WeldCellHash> grid;
+
+        for (auto & vertex : soup) {
+            WeldCell cell {(long long)std::floor(vertex.pos.x / cellSize),
+                           (long long)std::floor(vertex.pos.y / cellSize),
+                           (long long)std::floor(vertex.pos.z / cellSize)};
+
+            // A match within epsilon may be across a cell border
+            GLuint match = ~0u;
+            for (long long dx = -1; dx <= 1 && match == ~0u; dx++) {
+                for (long long dy = -1; dy <= 1 && match == ~0u; dy++) {
+                    for (long long dz = -1; dz <= 1 && match == ~0u; dz++) {
+                        auto it = grid.find({cell.x + dx, cell.y + dy, cell.z + dz});
+                        if (it == grid.end())
+                            continue;
+                        for (GLuint index : it->second) {
+                            if (nearlyEqual(vertex, mesh.vertices[index], epsilon)) {
+                                match = index;
+                                break;
+                            }
+                        }
+                    }
+                }
+            }
+
+            if (match == ~0u) {
+                match = GLuint(mesh.vertices.size());
+                mesh.vertices.push_back(vertex);
+                grid[cell].push_back(match);
+            }
+            mesh.indices.push_back(match);
+        }
+
+        return mesh;
+    }
+}
+
+namespace glpp::extra {
+    using VertexAttributes =
+        VertexLayout<Vertex, &Vertex::pos, &Vertex::norm, &Vertex::uv>;
+
+    VertexBufferArray::VertexBufferArray()
+        : BufferArray({VertexAttributes::attributes()}) {}
 
     VertexBufferArray::VertexBufferArray(VertexBufferArray && other)
         : BufferArray(std::move(other)) {}
@@ -67,4 +361,41 @@ namespace glpp::extra {
                                           const Vertex * data) {
         BufferArray::bufferSubData(0, offset, size, data);
     }
+
+    void VertexBufferArray::bufferData(const IndexedMesh & mesh, Usage usage) {
+        bufferData(mesh.vertices, usage);
+        bufferElements(mesh.indices, usage);
+    }
+}
+
+namespace glpp::extra {
+    using CompactVertexAttributes =
+        VertexLayout<CompactVertex, &CompactVertex::pos, &CompactVertex::norm, &CompactVertex::uv>;
+
+    CompactVertexBufferArray::CompactVertexBufferArray()
+        : BufferArray({CompactVertexAttributes::attributes()}) {}
+
+    CompactVertexBufferArray::CompactVertexBufferArray(CompactVertexBufferArray && other)
+        : BufferArray(std::move(other)) {}
+
+    CompactVertexBufferArray & CompactVertexBufferArray::operator=(
+        CompactVertexBufferArray && other) {
+        BufferArray::operator=(std::move(other));
+        return *this;
+    }
+
+    CompactVertexBufferArray::~CompactVertexBufferArray() {}
+
+    void CompactVertexBufferArray::bufferData(GLsizeiptr size,
+                                              const CompactVertex * data,
+                                              Usage usage) {
+        BufferArray::bufferData(0, size * sizeof(CompactVertex), data, usage);
+    }
+
+    void CompactVertexBufferArray::bufferSubData(GLintptr offset,
+                                                 GLsizeiptr size,
+                                                 const CompactVertex * data) {
+        BufferArray::bufferSubData(0, offset * sizeof(CompactVertex),
+                                   size * sizeof(CompactVertex), data);
+    }
 }
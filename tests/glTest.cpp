@@ -1,5 +1,9 @@
 #include "glTest.hpp"
 
+#include <glpp/BufferArena.hpp>
+#include <glpp/StateCache.hpp>
+#include <glpp/VertexArrayCache.hpp>
+
 #include <iostream>
 #include <stdexcept>
 using namespace std;
@@ -32,9 +36,15 @@ GLTest::GLTest() {
     if (glewInit() != GLEW_OK) {
         throw runtime_error("Could not initialize GLEW");
     }
+
+    // Each test has a new context, forget bindings from the last one
+    glpp::StateCache::current().invalidate();
 }
 
 GLTest::~GLTest() {
+    // Cached vertex arrays and arena pages belong to this context
+    glpp::VertexArrayCache::current().clear();
+    glpp::BufferArena::current().clear();
     glfwDestroyWindow(window);
     glfwTerminate();
 }
\ No newline at end of file
@@ -0,0 +1,109 @@
+#include <glpp/Buffer.hpp>
+using namespace glpp;
+
+#include <gtest/gtest.h>
+
+#include <iostream>
+#include <stdexcept>
+
+#include "glTest.hpp"
+
+namespace {
+    class BufferTest : public GLTest {
+    protected:
+        Buffer buffer;
+
+        BufferTest() : GLTest(), buffer(Buffer::Array) {}
+    };
+
+    TEST_F(BufferTest, Buffer) {
+        EXPECT_EQ(0, buffer.getSize());
+        EXPECT_EQ(0, buffer.getCapacity());
+        EXPECT_EQ(0, buffer.getReallocations());
+    }
+
+    TEST_F(BufferTest, bufferData_reuse) {
+        buffer.bufferData(100, nullptr, Buffer::Dynamic);
+        EXPECT_EQ(100, buffer.getSize());
+        EXPECT_EQ(100, buffer.getCapacity());
+        EXPECT_EQ(1, buffer.getReallocations());
+
+        buffer.bufferData(100, nullptr, Buffer::Dynamic);
+        buffer.bufferData(50, nullptr, Buffer::Dynamic);
+        EXPECT_EQ(50, buffer.getSize());
+        EXPECT_EQ(100, buffer.getCapacity());
+        EXPECT_EQ(1, buffer.getReallocations());
+    }
+
+    TEST_F(BufferTest, bufferData_grow) {
+        buffer.bufferData(100, nullptr, Buffer::Dynamic);
+        buffer.bufferData(101, nullptr, Buffer::Dynamic);
+        EXPECT_EQ(101, buffer.getSize());
+        EXPECT_EQ(200, buffer.getCapacity());
+        EXPECT_EQ(2, buffer.getReallocations());
+
+        buffer.bufferData(500, nullptr, Buffer::Dynamic);
+        EXPECT_EQ(500, buffer.getCapacity());
+        EXPECT_EQ(3, buffer.getReallocations());
+    }
+
+    TEST_F(BufferTest, bufferData_usage) {
+        buffer.bufferData(100, nullptr, Buffer::Static);
+        buffer.bufferData(100, nullptr, Buffer::Stream);
+        EXPECT_EQ(Buffer::Stream, buffer.getUsage());
+        EXPECT_EQ(2, buffer.getReallocations());
+    }
+
+    TEST_F(BufferTest, reserve) {
+        buffer.reserve(256, Buffer::Dynamic);
+        EXPECT_EQ(0, buffer.getSize());
+        EXPECT_EQ(256, buffer.getCapacity());
+        EXPECT_EQ(1, buffer.getReallocations());
+
+        buffer.bufferData(200, nullptr, Buffer::Dynamic);
+        buffer.reserve(128, Buffer::Dynamic);
+        EXPECT_EQ(256, buffer.getCapacity());
+        EXPECT_EQ(1, buffer.getReallocations());
+    }
+
+    TEST(ElementBufferTest, typeFor) {
+        EXPECT_EQ(GL_UNSIGNED_BYTE, ElementBuffer::typeFor(0));
+        EXPECT_EQ(GL_UNSIGNED_BYTE, ElementBuffer::typeFor(255));
+        EXPECT_EQ(GL_UNSIGNED_SHORT, ElementBuffer::typeFor(256));
+        EXPECT_EQ(GL_UNSIGNED_SHORT, ElementBuffer::typeFor(65535));
+        EXPECT_EQ(GL_UNSIGNED_INT, ElementBuffer::typeFor(65536));
+    }
+
+    TEST_F(BufferTest, ElementBuffer_bufferElements) {
+        ElementBuffer elements;
+        elements.bufferElements({0, 1, 2, 2, 1, 3});
+        EXPECT_EQ(6, elements.getCount());
+        EXPECT_EQ(GL_UNSIGNED_BYTE, elements.getType());
+        EXPECT_EQ(6, elements.getSize());
+
+        elements.bufferElements({0, 1, 300});
+        EXPECT_EQ(3, elements.getCount());
+        EXPECT_EQ(GL_UNSIGNED_SHORT, elements.getType());
+        EXPECT_EQ(6, elements.getSize());
+
+        elements.bufferElements({0, 70000});
+        EXPECT_EQ(2, elements.getCount());
+        EXPECT_EQ(GL_UNSIGNED_INT, elements.getType());
+        EXPECT_EQ(8, elements.getSize());
+    }
+
+    TEST_F(BufferTest, BufferArray_bufferElements) {
+        BufferArray array;
+        EXPECT_EQ(nullptr, array.getElementBuffer());
+
+        array.bufferElements({0, 1, 2});
+        ASSERT_NE(nullptr, array.getElementBuffer());
+        EXPECT_EQ(3, array.getElementBuffer()->getCount());
+        EXPECT_EQ(GL_UNSIGNED_BYTE, array.getElementBuffer()->getType());
+
+        const GLuint indices[] = {0, 1, 2, 3};
+        array.bufferElements(sizeof(indices), indices);
+        EXPECT_EQ(4, array.getElementBuffer()->getCount());
+        EXPECT_EQ(GL_UNSIGNED_INT, array.getElementBuffer()->getType());
+    }
+}
@@ -0,0 +1,107 @@
+#include <glpp/BufferArena.hpp>
+using namespace glpp;
+
+#include <gtest/gtest.h>
+
+#include <iostream>
+#include <stdexcept>
+
+#include "glTest.hpp"
+
+namespace {
+    class BufferArenaTest : public GLTest {
+    protected:
+        BufferArena arena;
+
+        BufferArenaTest() : GLTest(), arena(1024) {}
+    };
+
+    TEST_F(BufferArenaTest, BufferArena) {
+        EXPECT_EQ(1024, arena.getPageSize());
+        EXPECT_EQ(0, arena.getPageCount());
+        EXPECT_EQ(0, arena.getCapacity());
+        EXPECT_EQ(0, arena.getBlockCount());
+    }
+
+    TEST_F(BufferArenaTest, allocate) {
+        auto a = arena.allocate(100);
+        auto b = arena.allocate(100);
+        EXPECT_EQ(1, arena.getPageCount());
+        EXPECT_EQ(2, arena.getBlockCount());
+        EXPECT_EQ(200, arena.getAllocated());
+        EXPECT_EQ(a->buffer, b->buffer);
+        EXPECT_EQ(0, a->offset);
+        EXPECT_EQ(112, b->offset);
+    }
+
+    TEST_F(BufferArenaTest, allocate_alignment) {
+        auto a = arena.allocate(10, 1);
+        auto b = arena.allocate(12, 12);
+        EXPECT_EQ(0, a->offset);
+        EXPECT_EQ(12, b->offset);
+    }
+
+    TEST_F(BufferArenaTest, allocate_large) {
+        auto a = arena.allocate(4000);
+        EXPECT_EQ(1, arena.getPageCount());
+        EXPECT_EQ(4000, arena.getCapacity());
+    }
+
+    TEST_F(BufferArenaTest, allocate_new_page) {
+        auto a = arena.allocate(1000);
+        auto b = arena.allocate(100);
+        EXPECT_EQ(2, arena.getPageCount());
+        EXPECT_NE(a->buffer, b->buffer);
+    }
+
+    TEST_F(BufferArenaTest, release) {
+        auto a = arena.allocate(100);
+        auto b = arena.allocate(100);
+        a.reset();
+        EXPECT_EQ(1, arena.getBlockCount());
+
+        // Freed range is reused
+        auto c = arena.allocate(100);
+        EXPECT_EQ(0, c->offset);
+    }
+
+    TEST_F(BufferArenaTest, release_merge) {
+        auto a = arena.allocate(512);
+        auto b = arena.allocate(512);
+        a.reset();
+        b.reset();
+
+        // Both ranges merged back into a single page sized range
+        auto c = arena.allocate(1024);
+        EXPECT_EQ(1, arena.getPageCount());
+        EXPECT_EQ(0, c->offset);
+    }
+
+    TEST_F(BufferArenaTest, defragment) {
+        auto a = arena.allocate(100);
+        auto b = arena.allocate(100);
+        a.reset();
+        arena.defragment();
+        EXPECT_EQ(0, b->offset);
+        EXPECT_EQ(1, b->version);
+
+        auto c = arena.allocate(900);
+        EXPECT_EQ(1, arena.getPageCount());
+    }
+
+    TEST_F(BufferArenaTest, clear) {
+        auto a = arena.allocate(100);
+        arena.clear();
+        EXPECT_EQ(0, arena.getPageCount());
+        EXPECT_EQ(0, arena.getBlockCount());
+
+        // The outstanding block keeps its page until released
+        EXPECT_NE(0, a->buffer->getBufferId());
+        a.reset();
+        EXPECT_EQ(0, arena.getPageCount());
+    }
+
+    TEST_F(BufferArenaTest, current) {
+        EXPECT_EQ(&BufferArena::current(), &BufferArena::current());
+    }
+}
@@ -0,0 +1,175 @@
+#include <glpp/extra/MeshFile.hpp>
+#include <glpp/extra/Vertex.hpp>
+using namespace glpp;
+using namespace glpp::extra;
+
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+
+namespace {
+    class MeshFileTest : public ::testing::Test {
+    protected:
+        const string path = "test_extra_MeshFile.mesh";
+        IndexedMesh mesh;
+
+        MeshFileTest() {
+            mesh.vertices = {
+                Vertex({-1, 0, 2}, {0, 0, 1}, {0, 0}),
+                Vertex({1, 0, 0}, {0, 0, 1}, {1, 0}),
+                Vertex({0, 3, -2}, {0, 0, 1}, {0, 1}),
+            };
+            mesh.indices = {0, 1, 2, 2, 1, 0};
+        }
+
+        ~MeshFileTest() override {
+            std::remove(path.c_str());
+        }
+    };
+
+    TEST_F(MeshFileTest, write) {
+        MeshFile::write(path, mesh);
+
+        MeshFile file(path);
+        EXPECT_EQ(3, file.getVertexCount());
+        EXPECT_EQ(6, file.getIndexCount());
+        EXPECT_EQ(GL_UNSIGNED_BYTE, file.getIndexType());
+        EXPECT_EQ(sizeof(Vertex), file.getStride());
+        EXPECT_EQ(3 * sizeof(Vertex), file.getVertexDataSize());
+        EXPECT_EQ(6, file.getIndexDataSize());
+
+        auto bounds = file.getBounds();
+        EXPECT_EQ(glm::vec3(-1, 0, -2), bounds.min);
+        EXPECT_EQ(glm::vec3(1, 3, 2), bounds.max);
+    }
+
+    TEST_F(MeshFileTest, alignment) {
+        MeshFile::write(path, mesh);
+
+        MeshFile file(path);
+        auto vertices = reinterpret_cast<std::uintptr_t>(file.getVertexData());
+        auto indices = reinterpret_cast<std::uintptr_t>(file.getIndexData());
+        EXPECT_EQ(0, vertices % MeshFile::alignment);
+        EXPECT_EQ(0, indices % MeshFile::alignment);
+    }
+
+    TEST_F(MeshFileTest, data) {
+        MeshFile::write(path, mesh);
+
+        MeshFile file(path);
+        auto * vertices = static_cast<const Vertex *>(file.getVertexData());
+        EXPECT_EQ(mesh.vertices[2].pos, vertices[2].pos);
+        EXPECT_EQ(mesh.vertices[1].uv, vertices[1].uv);
+
+        auto * indices = static_cast<const GLubyte *>(file.getIndexData());
+        for (std::size_t i = 0; i < mesh.indices.size(); i++) {
+            EXPECT_EQ(mesh.indices[i], indices[i]);
+        }
+    }
+
+    TEST_F(MeshFileTest, getAttributes) {
+        MeshFile::write(path, mesh);
+
+        MeshFile file(path);
+        auto attributes = file.getAttributes();
+        ASSERT_EQ(3, attributes.size());
+        EXPECT_EQ(0, attributes[0].index);
+        EXPECT_EQ(3, attributes[0].size);
+        EXPECT_EQ(GL_FLOAT, attributes[0].type);
+        EXPECT_EQ(sizeof(Vertex), attributes[0].stride);
+        EXPECT_EQ(2, attributes[2].index);
+        EXPECT_EQ(2, attributes[2].size);
+        EXPECT_EQ(reinterpret_cast<const void *>(offsetof(Vertex, uv)),
+                  attributes[2].pointer);
+    }
+
+    TEST_F(MeshFileTest, no_indices) {
+        vector<Buffer::Attribute> attributes {
+            Buffer::Attribute(0, 3, GL_FLOAT, false, sizeof(Vertex)),
+        };
+        MeshFile::write(path, attributes, sizeof(Vertex), mesh.vertices.size(),
+                        mesh.vertices.data(), 0, 0, nullptr,
+                        MeshFile::boundsOf(mesh.vertices));
+
+        MeshFile file(path);
+        EXPECT_EQ(3, file.getVertexCount());
+        EXPECT_EQ(0, file.getIndexCount());
+        EXPECT_EQ(0, file.getIndexType());
+        EXPECT_EQ(0, file.getIndexDataSize());
+        EXPECT_EQ(1, file.getAttributes().size());
+    }
+
+    TEST_F(MeshFileTest, Move) {
+        MeshFile::write(path, mesh);
+
+        MeshFile file(path);
+        const void * data = file.getVertexData();
+        MeshFile moved(std::move(file));
+        EXPECT_EQ(data, moved.getVertexData());
+    }
+
+    TEST_F(MeshFileTest, missing) {
+        EXPECT_THROW(MeshFile("missing.mesh"), MeshFileException);
+    }
+
+    TEST_F(MeshFileTest, invalid) {
+        {
+            std::ofstream os(path, std::ios::binary);
+            char junk[128] = {};
+            std::strcpy(junk, "junk");
+            os.write(junk, sizeof(junk));
+        }
+        EXPECT_THROW(MeshFile file(path), MeshFileException);
+    }
+
+    TEST_F(MeshFileTest, truncated) {
+        MeshFile::write(path, mesh);
+        {
+            std::ifstream is(path, std::ios::binary);
+            vector<char> data(200);
+            is.read(data.data(), data.size());
+            std::ofstream os(path, std::ios::binary | std::ios::trunc);
+            os.write(data.data(), data.size());
+        }
+        EXPECT_THROW(MeshFile file(path), MeshFileException);
+    }
+
+    TEST_F(MeshFileTest, overflow) {
+        MeshFile::write(path, mesh);
+        {
+            // A count whose byte size wraps around to the real size
+            std::uint64_t count = (std::uint64_t(1) << 59) + mesh.vertices.size();
+            std::fstream fs(path, std::ios::binary | std::ios::in | std::ios::out);
+            fs.seekp(offsetof(MeshFileHeader, vertexCount));
+            fs.write(reinterpret_cast<const char *>(&count), sizeof(count));
+        }
+        EXPECT_THROW(MeshFile file(path), MeshFileException);
+    }
+
+    TEST_F(MeshFileTest, attribute_outsideVertex) {
+        vector<Buffer::Attribute> attributes {
+            Buffer::Attribute(0, 3, GL_FLOAT, false, sizeof(Vertex),
+                              (void *)(sizeof(Vertex) - 4)),
+        };
+        MeshFile::write(path, attributes, sizeof(Vertex), mesh.vertices.size(),
+                        mesh.vertices.data(), 0, 0, nullptr,
+                        MeshFile::boundsOf(mesh.vertices));
+        EXPECT_THROW(MeshFile file(path), MeshFileException);
+    }
+
+    TEST_F(MeshFileTest, attribute_size) {
+        vector<Buffer::Attribute> attributes {
+            Buffer::Attribute(0, 5, GL_FLOAT, false, sizeof(Vertex)),
+        };
+        MeshFile::write(path, attributes, sizeof(Vertex), mesh.vertices.size(),
+                        mesh.vertices.data(), 0, 0, nullptr,
+                        MeshFile::boundsOf(mesh.vertices));
+        EXPECT_THROW(MeshFile file(path), MeshFileException);
+    }
+}
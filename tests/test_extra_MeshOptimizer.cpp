@@ -0,0 +1,116 @@
+#include <glpp/extra/MeshOptimizer.hpp>
+#include <glpp/extra/Vertex.hpp>
+using namespace glpp::extra;
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <array>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+
+namespace {
+    class MeshOptimizerTest : public ::testing::Test {
+    protected:
+        static constexpr GLuint n = 32;
+
+        vector<Vertex> vertices;
+        vector<GLuint> indices;
+
+        // A flat n by n grid with triangles in random order
+        MeshOptimizerTest() {
+            for (GLuint y = 0; y <= n; y++) {
+                for (GLuint x = 0; x <= n; x++) {
+                    vertices.emplace_back(glm::vec3(x, y, 0), glm::vec3(0, 0, 1),
+                                          glm::vec2(x, y) / float(n));
+                }
+            }
+
+            vector<std::array<GLuint, 3>> triangles;
+            for (GLuint y = 0; y < n; y++) {
+                for (GLuint x = 0; x < n; x++) {
+                    GLuint i = y * (n + 1) + x;
+                    triangles.push_back({i, i + 1, i + n + 2});
+                    triangles.push_back({i, i + n + 2, i + n + 1});
+                }
+            }
+
+            std::mt19937 rng(1234);
+            std::shuffle(triangles.begin(), triangles.end(), rng);
+            for (auto & t : triangles) {
+                indices.insert(indices.end(), t.begin(), t.end());
+            }
+        }
+
+        static vector<std::array<GLuint, 3>> sortedTriangles(
+            const vector<GLuint> & indices, const vector<Vertex> & vertices) {
+            // Compare by position so remapped vertices still match
+            vector<std::array<GLuint, 3>> triangles;
+            for (std::size_t i = 0; i < indices.size(); i += 3) {
+                std::array<GLuint, 3> t;
+                for (std::size_t k = 0; k < 3; k++) {
+                    auto & pos = vertices[indices[i + k]].pos;
+                    t[k] = GLuint(pos.y * (n + 1) + pos.x);
+                }
+                triangles.push_back(t);
+            }
+            std::sort(triangles.begin(), triangles.end());
+            return triangles;
+        }
+    };
+
+    TEST_F(MeshOptimizerTest, averageCacheMissRatio) {
+        EXPECT_EQ(0.0f, averageCacheMissRatio({}, 0));
+        EXPECT_EQ(3.0f, averageCacheMissRatio({0, 1, 2}, 3));
+        EXPECT_EQ(2.0f, averageCacheMissRatio({0, 1, 2, 2, 1, 3}, 4));
+    }
+
+    TEST_F(MeshOptimizerTest, optimizeVertexCache) {
+        float before = averageCacheMissRatio(indices, vertices.size());
+        auto optimized = optimizeVertexCache(indices, vertices.size());
+        float after = averageCacheMissRatio(optimized, vertices.size());
+
+        EXPECT_EQ(indices.size(), optimized.size());
+        EXPECT_EQ(sortedTriangles(indices, vertices),
+                  sortedTriangles(optimized, vertices));
+        EXPECT_LT(after, before);
+        EXPECT_LT(after, 1.0f);
+    }
+
+    TEST_F(MeshOptimizerTest, optimizeOverdraw) {
+        vector<glm::vec3> positions;
+        for (auto & v : vertices) {
+            positions.push_back(v.pos);
+        }
+
+        auto cached = optimizeVertexCache(indices, vertices.size());
+        auto optimized = optimizeOverdraw(cached, positions);
+        EXPECT_EQ(sortedTriangles(indices, vertices),
+                  sortedTriangles(optimized, vertices));
+    }
+
+    TEST_F(MeshOptimizerTest, optimizeVertexFetch) {
+        vector<Vertex> original = vertices;
+        vertices.push_back(Vertex()); // Unused
+        indices = optimizeVertexCache(indices, vertices.size());
+        optimizeVertexFetch(vertices, indices);
+
+        EXPECT_EQ(original.size(), vertices.size());
+        EXPECT_EQ(sortedTriangles(indices, vertices).size(), indices.size() / 3);
+
+        // Each vertex is first used in order
+        GLuint next = 0;
+        for (GLuint index : indices) {
+            EXPECT_LE(index, next);
+            if (index == next)
+                next++;
+        }
+    }
+
+    TEST_F(MeshOptimizerTest, optimizeMesh) {
+        auto triangles = sortedTriangles(indices, vertices);
+        optimizeMesh(vertices, indices, true);
+        EXPECT_EQ(triangles, sortedTriangles(indices, vertices));
+    }
+}
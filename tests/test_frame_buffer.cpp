@@ -0,0 +1,60 @@
+#include <glpp/FrameBuffer.hpp>
+using namespace glpp;
+
+#include <gtest/gtest.h>
+
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+
+#include "glTest.hpp"
+
+namespace {
+    class FrameBufferTest : public GLTest {
+    protected:
+        FrameBuffer fbo;
+
+        FrameBufferTest() : GLTest(), fbo({4, 2}) {
+            fbo.attach(std::make_shared<Texture>(glm::uvec2(4, 2)));
+        }
+    };
+
+    TEST_F(FrameBufferTest, readPixelsAsync) {
+        fbo.bind();
+        glClearColor(1, 0, 0, 1);
+        fbo.clear(GL_COLOR_BUFFER_BIT);
+
+        auto readback = fbo.readPixelsAsync({0, 0, 4, 2});
+        EXPECT_EQ(16, readback.getRowSize());
+        EXPECT_EQ(32, readback.getSize());
+        EXPECT_TRUE(readback.wait());
+        EXPECT_TRUE(readback.isReady());
+
+        auto * pixels = static_cast<const unsigned char *>(readback.map());
+        ASSERT_NE(nullptr, pixels);
+        EXPECT_EQ(255, pixels[0]);
+        EXPECT_EQ(0, pixels[1]);
+        EXPECT_EQ(0, pixels[2]);
+        EXPECT_EQ(255, pixels[3]);
+        readback.unmap();
+    }
+
+    TEST_F(FrameBufferTest, readPixelsAsync_rowPadding) {
+        auto readback = fbo.readPixelsAsync({0, 0, 3, 2}, GL_RGB);
+        EXPECT_EQ(12, readback.getRowSize());
+
+        auto gray = fbo.readPixelsAsync({0, 0, 3, 2}, GL_RED);
+        EXPECT_EQ(4, gray.getRowSize());
+    }
+
+    TEST_F(FrameBufferTest, readPixelsAsync_held) {
+        // More handles than ring buffers, none may share a buffer
+        vector<PixelReadback> readbacks;
+        for (int i = 0; i < 5; i++) {
+            readbacks.push_back(fbo.readPixelsAsync({0, 0, 4, 2}));
+        }
+        for (auto & readback : readbacks) {
+            EXPECT_NE(nullptr, readback.map());
+        }
+    }
+}
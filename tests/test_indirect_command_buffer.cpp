@@ -0,0 +1,94 @@
+#include <glpp/IndirectCommandBuffer.hpp>
+#include <glpp/Shader.hpp>
+using namespace glpp;
+
+#include <gtest/gtest.h>
+
+#include <iostream>
+#include <stdexcept>
+
+#include "glTest.hpp"
+
+static const char * vertexShaderSource = R"(
+#version 330 core
+void main() {
+    gl_Position = vec4(float(gl_VertexID % 3), float(gl_InstanceID), 0.0, 1.0);
+})";
+
+static const char * fragmentShaderSource = R"(
+#version 330 core
+out vec4 FragColor;
+void main() {
+    FragColor = vec4(1.0);
+})";
+
+namespace {
+    class IndirectCommandBufferTest : public GLTest {
+    protected:
+        IndirectCommandBuffer commands;
+
+        IndirectCommandBufferTest() : GLTest() {}
+    };
+
+    TEST_F(IndirectCommandBufferTest, IndirectCommandBuffer) {
+        EXPECT_EQ(Buffer::DrawIndirect, commands.getTarget());
+        EXPECT_EQ(Buffer::Stream, commands.getUsage());
+        EXPECT_TRUE(commands.getArrayCommands().empty());
+        EXPECT_TRUE(commands.getElementCommands().empty());
+        EXPECT_EQ(0, commands.getElementOffset());
+    }
+
+    TEST_F(IndirectCommandBufferTest, addArrays) {
+        commands.addArrays(3, 6, 2, 1);
+        ASSERT_EQ(1, commands.getArrayCommands().size());
+        auto & cmd = commands.getArrayCommands()[0];
+        EXPECT_EQ(3, cmd.count);
+        EXPECT_EQ(6, cmd.first);
+        EXPECT_EQ(2, cmd.instanceCount);
+        EXPECT_EQ(1, cmd.baseInstance);
+        EXPECT_EQ(sizeof(DrawArraysIndirectCommand), commands.getElementOffset());
+    }
+
+    TEST_F(IndirectCommandBufferTest, addElements) {
+        commands.addElements(6, 12, 4);
+        ASSERT_EQ(1, commands.getElementCommands().size());
+        auto & cmd = commands.getElementCommands()[0];
+        EXPECT_EQ(6, cmd.count);
+        EXPECT_EQ(12, cmd.firstIndex);
+        EXPECT_EQ(4, cmd.baseVertex);
+        EXPECT_EQ(1, cmd.instanceCount);
+        EXPECT_EQ(0, cmd.baseInstance);
+    }
+
+    TEST_F(IndirectCommandBufferTest, clear) {
+        commands.addArrays(3);
+        commands.addElements(3);
+        commands.clear();
+        EXPECT_TRUE(commands.getArrayCommands().empty());
+        EXPECT_TRUE(commands.getElementCommands().empty());
+    }
+
+    TEST_F(IndirectCommandBufferTest, draw) {
+        Shader shader(vertexShaderSource, fragmentShaderSource);
+        shader.bind();
+        BufferArray array;
+        commands.addArrays(3);
+        commands.addArrays(6, 3, 2);
+
+        GLuint query;
+        glGenQueries(1, &query);
+        glEnable(GL_RASTERIZER_DISCARD);
+        glBeginQuery(GL_PRIMITIVES_GENERATED, query);
+        array.multiDrawArraysIndirect(Buffer::Triangles, commands);
+        glEndQuery(GL_PRIMITIVES_GENERATED);
+        glDisable(GL_RASTERIZER_DISCARD);
+
+        GLuint primitives = 0;
+        glGetQueryObjectuiv(query, GL_QUERY_RESULT, &primitives);
+        glDeleteQueries(1, &query);
+
+        // One triangle, then two triangles for each of two instances
+        EXPECT_EQ(5, primitives);
+        EXPECT_EQ(GL_NO_ERROR, glGetError());
+    }
+}
@@ -0,0 +1,120 @@
+#include <glpp/InstanceBuffer.hpp>
+#include <glpp/VertexLayout.hpp>
+using namespace glpp;
+
+#include <gtest/gtest.h>
+
+#include <iostream>
+#include <stdexcept>
+
+#include "glTest.hpp"
+
+namespace {
+    struct Instance {
+        glm::vec2 offset;
+        float scale;
+    };
+
+    using InstanceLayout =
+        VertexLayout<Instance, &Instance::offset, &Instance::scale>;
+
+    class InstanceBufferTest : public GLTest {
+    protected:
+        InstanceBuffer<Instance> buffer;
+
+        InstanceBufferTest()
+            : GLTest(), buffer(InstanceLayout::attributes(2, 1)) {
+            buffer.assign(vector<Instance>(100, {glm::vec2(0), 1.0f}));
+        }
+    };
+
+    TEST_F(InstanceBufferTest, InstanceBuffer) {
+        EXPECT_TRUE(buffer.isInstanced());
+        EXPECT_EQ(100, buffer.size());
+        ASSERT_EQ(1, buffer.getDirtyRanges().size());
+        EXPECT_EQ(0, buffer.getDirtyRanges()[0].first);
+        EXPECT_EQ(100, buffer.getDirtyRanges()[0].count);
+    }
+
+    TEST_F(InstanceBufferTest, upload_full) {
+        buffer.upload();
+        EXPECT_EQ(100 * sizeof(Instance), buffer.getUploadedBytes());
+        EXPECT_EQ(1, buffer.getUploadCalls());
+        EXPECT_EQ(100 * sizeof(Instance), buffer.getSize());
+        EXPECT_EQ(0, buffer.getDirtyRanges().size());
+    }
+
+    TEST_F(InstanceBufferTest, upload_ranges) {
+        buffer.upload();
+
+        buffer.edit(10).scale = 2.0f;
+        buffer.edit(11).scale = 3.0f;
+        buffer.edit(50).scale = 4.0f;
+        buffer.upload();
+
+        EXPECT_EQ(3 * sizeof(Instance), buffer.getUploadedBytes());
+        EXPECT_EQ(2, buffer.getUploadCalls());
+        EXPECT_EQ(1, buffer.getReallocations());
+
+        Instance value;
+        buffer.bind();
+        glGetBufferSubData(GL_ARRAY_BUFFER, 11 * sizeof(Instance),
+                           sizeof(Instance), &value);
+        EXPECT_EQ(3.0f, value.scale);
+    }
+
+    TEST_F(InstanceBufferTest, upload_mostly_changed) {
+        buffer.upload();
+        for (std::size_t i = 0; i < 100; i += 2) {
+            buffer.edit(i).scale = 2.0f;
+        }
+        buffer.edit(1).scale = 2.0f;
+        buffer.upload();
+        EXPECT_EQ(1, buffer.getUploadCalls());
+        EXPECT_EQ(100 * sizeof(Instance), buffer.getUploadedBytes());
+    }
+
+    TEST_F(InstanceBufferTest, upload_grow) {
+        buffer.upload();
+        buffer.push_back({glm::vec2(1), 1.0f});
+        buffer.upload();
+        EXPECT_EQ(101 * sizeof(Instance), buffer.getUploadedBytes());
+        EXPECT_EQ(2, buffer.getReallocations());
+    }
+
+    TEST_F(InstanceBufferTest, getDirtyRanges) {
+        buffer.upload();
+        buffer.markDirty(20, 5);
+        buffer.markDirty(2, 3);
+        buffer.markDirty(22, 10);
+        buffer.markDirty(4, 1);
+
+        auto & ranges = buffer.getDirtyRanges();
+        ASSERT_EQ(2, ranges.size());
+        EXPECT_EQ(2, ranges[0].first);
+        EXPECT_EQ(3, ranges[0].count);
+        EXPECT_EQ(20, ranges[1].first);
+        EXPECT_EQ(12, ranges[1].count);
+    }
+
+    TEST_F(InstanceBufferTest, setMergeGap) {
+        buffer.upload();
+        buffer.setMergeGap(4);
+        buffer.markDirty(10, 1);
+        buffer.markDirty(15, 1);
+        buffer.markDirty(30, 1);
+
+        auto & ranges = buffer.getDirtyRanges();
+        ASSERT_EQ(2, ranges.size());
+        EXPECT_EQ(10, ranges[0].first);
+        EXPECT_EQ(6, ranges[0].count);
+        EXPECT_EQ(30, ranges[1].first);
+    }
+
+    TEST_F(InstanceBufferTest, upload_clean) {
+        buffer.upload();
+        buffer.upload();
+        EXPECT_EQ(1, buffer.getReallocations());
+        EXPECT_EQ(100 * sizeof(Instance), buffer.getUploadedBytes());
+    }
+}
@@ -0,0 +1,147 @@
+#include <glpp/ProgramCache.hpp>
+#include <glpp/Shader.hpp>
+using namespace glpp;
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+
+#include "glTest.hpp"
+
+namespace {
+    static const char * vertexSource = R"(
+#version 330 core
+layout (location = 0) in vec3 aPos;
+void main() {
+    gl_Position = vec4(aPos, 1.0);
+})";
+
+    static const char * fragmentSource = R"(
+#version 330 core
+out vec4 FragColor;
+void main() {
+    FragColor = vec4(1.0);
+})";
+
+    TEST(ProgramCacheHashTest, fnv1a) {
+        // Reference values of 64 bit FNV-1a
+        EXPECT_EQ(0xcbf29ce484222325ull, ProgramCache::hash(""));
+        EXPECT_EQ(0xaf63dc4c8601ec8cull, ProgramCache::hash("a"));
+        EXPECT_EQ(0x85944171f73967e8ull, ProgramCache::hash("foobar"));
+    }
+
+    TEST(ProgramCacheHashTest, seed) {
+        EXPECT_EQ(ProgramCache::hash("foobar"),
+                  ProgramCache::hash("bar", ProgramCache::hash("foo")));
+    }
+
+    TEST(ProgramCacheHashTest, constexpr) {
+        static_assert(ProgramCache::hash("a") == 0xaf63dc4c8601ec8cull);
+    }
+
+    class ProgramCacheTest : public GLTest {
+    protected:
+        std::filesystem::path directory;
+        ProgramCache::Ptr cache;
+
+        ProgramCacheTest()
+            : GLTest(),
+              directory(std::filesystem::temp_directory_path()
+                        / "glpp_test_program_cache"),
+              cache(std::make_shared<ProgramCache>(directory)) {
+            cache->clear();
+            ProgramCache::setDefault(cache);
+        }
+
+        ~ProgramCacheTest() {
+            ProgramCache::setDefault(nullptr);
+            std::filesystem::remove_all(directory);
+        }
+    };
+
+    TEST_F(ProgramCacheTest, getDefault) {
+        EXPECT_EQ(cache, ProgramCache::getDefault());
+        EXPECT_TRUE(std::filesystem::is_directory(directory));
+    }
+
+    TEST_F(ProgramCacheTest, key) {
+        auto a = cache->key({vertexSource, fragmentSource});
+        EXPECT_EQ(a, cache->key({vertexSource, fragmentSource}));
+        EXPECT_NE(a, cache->key({fragmentSource, vertexSource}));
+        EXPECT_NE(a, cache->key({vertexSource}));
+        EXPECT_NE(a, cache->key({vertexSource, fragmentSource}, {"aPos"}));
+    }
+
+    TEST_F(ProgramCacheTest, load_missing) {
+        EXPECT_EQ(0, cache->load(1));
+        EXPECT_EQ(1, cache->getCounters().misses);
+        EXPECT_EQ(0, cache->getCounters().rejected);
+    }
+
+    TEST_F(ProgramCacheTest, load_badLength) {
+        // Same layout as the header written by ProgramCache::store
+        struct {
+            char magic[4] = {'G', 'L', 'P', 'B'};
+            std::uint32_t version = 1;
+            std::uint64_t key = 2;
+            std::uint32_t format = 0;
+            std::uint32_t length = 0xFFFFFFFF;
+        } header;
+        {
+            std::ofstream os(cache->pathOf(2), std::ios::binary);
+            os.write(reinterpret_cast<const char *>(&header), sizeof(header));
+            os << "short";
+        }
+
+        EXPECT_EQ(0, cache->load(2));
+        EXPECT_EQ(1, cache->getCounters().misses);
+        EXPECT_EQ(1, cache->getCounters().rejected);
+        EXPECT_FALSE(std::filesystem::exists(cache->pathOf(2)));
+    }
+
+    TEST_F(ProgramCacheTest, shader_storeAndLoad) {
+        if (!ProgramCache::isSupported())
+            GTEST_SKIP();
+
+        auto key = cache->key({vertexSource, fragmentSource});
+        {
+            Shader shader(vertexSource, fragmentSource);
+            EXPECT_NE(0, shader.getProgram());
+        }
+        EXPECT_TRUE(std::filesystem::exists(cache->pathOf(key)));
+        EXPECT_EQ(1, cache->getCounters().misses);
+
+        Shader shader(vertexSource, fragmentSource);
+        EXPECT_NE(0, shader.getProgram());
+        EXPECT_EQ(1, cache->getCounters().hits);
+    }
+
+    TEST_F(ProgramCacheTest, shader_corrupt) {
+        if (!ProgramCache::isSupported())
+            GTEST_SKIP();
+
+        auto key = cache->key({vertexSource, fragmentSource});
+        {
+            std::ofstream os(cache->pathOf(key), std::ios::binary);
+            os << "not a program binary";
+        }
+
+        // Falls back to compiling and replaces the file
+        Shader shader(vertexSource, fragmentSource);
+        EXPECT_NE(0, shader.getProgram());
+        EXPECT_EQ(1, cache->getCounters().rejected);
+        EXPECT_TRUE(std::filesystem::exists(cache->pathOf(key)));
+    }
+
+    TEST_F(ProgramCacheTest, clear) {
+        {
+            std::ofstream os(cache->pathOf(1), std::ios::binary);
+        }
+        cache->clear();
+        EXPECT_FALSE(std::filesystem::exists(cache->pathOf(1)));
+    }
+}
@@ -0,0 +1,129 @@
+#include <glpp/ResourceTracker.hpp>
+using namespace glpp;
+
+#include <glpp/Buffer.hpp>
+
+#include <gtest/gtest.h>
+
+#include <sstream>
+
+#include "glTest.hpp"
+
+namespace {
+    ResourceTracker::Record bufferRecord(GLuint id, GLenum target, GLenum usage, std::size_t bytes) {
+        return {ResourceTracker::BufferMemory, id, target, usage, 0, 0, 0, 0, 0, bytes};
+    }
+
+    ResourceTracker::Record textureRecord(GLuint id, GLenum format, std::size_t bytes) {
+        return {ResourceTracker::TextureMemory, id, GL_TEXTURE_2D, 0, format, 1, 1, 0, 1, bytes};
+    }
+
+    TEST(ResourceTrackerTest, track) {
+        ResourceTracker tracker;
+        tracker.track(bufferRecord(1, GL_ARRAY_BUFFER, GL_STATIC_DRAW, 100));
+        tracker.track(textureRecord(1, GL_RGBA8, 50));
+
+        EXPECT_EQ(150, tracker.getTotals().current);
+        EXPECT_EQ(100, tracker.getTotals(ResourceTracker::BufferMemory).current);
+        EXPECT_EQ(50, tracker.getTotals(ResourceTracker::TextureMemory).current);
+        EXPECT_EQ(100, tracker.getBytes(ResourceTracker::BufferMemory, 1));
+        EXPECT_EQ(50, tracker.getBytes(ResourceTracker::TextureMemory, 1));
+        EXPECT_EQ(0, tracker.getBytes(ResourceTracker::BufferMemory, 2));
+        EXPECT_EQ(2, tracker.getRecords().size());
+    }
+
+    TEST(ResourceTrackerTest, track_replace) {
+        ResourceTracker tracker;
+        tracker.track(bufferRecord(1, GL_ARRAY_BUFFER, GL_STATIC_DRAW, 100));
+        tracker.track(bufferRecord(1, GL_ARRAY_BUFFER, GL_STATIC_DRAW, 200));
+
+        EXPECT_EQ(200, tracker.getTotals().current);
+        EXPECT_EQ(200, tracker.getTotals().peak);
+        EXPECT_EQ(1, tracker.getRecords().size());
+    }
+
+    TEST(ResourceTrackerTest, untrack) {
+        ResourceTracker tracker;
+        tracker.track(bufferRecord(1, GL_ARRAY_BUFFER, GL_STATIC_DRAW, 100));
+        tracker.untrack(ResourceTracker::BufferMemory, 1);
+        tracker.untrack(ResourceTracker::BufferMemory, 2);
+
+        EXPECT_EQ(0, tracker.getTotals().current);
+        EXPECT_EQ(100, tracker.getTotals().peak);
+        EXPECT_EQ(0, tracker.getRecords().size());
+    }
+
+    TEST(ResourceTrackerTest, resetPeak) {
+        ResourceTracker tracker;
+        tracker.track(bufferRecord(1, GL_ARRAY_BUFFER, GL_STATIC_DRAW, 100));
+        tracker.track(bufferRecord(2, GL_ARRAY_BUFFER, GL_STATIC_DRAW, 100));
+        tracker.untrack(ResourceTracker::BufferMemory, 1);
+
+        EXPECT_EQ(200, tracker.getTotals().peak);
+        tracker.resetPeak();
+        EXPECT_EQ(100, tracker.getTotals().peak);
+        EXPECT_EQ(100, tracker.getTotals(ResourceTracker::BufferMemory).peak);
+    }
+
+    TEST(ResourceTrackerTest, getBytesBy) {
+        ResourceTracker tracker;
+        tracker.track(bufferRecord(1, GL_ARRAY_BUFFER, GL_STATIC_DRAW, 100));
+        tracker.track(bufferRecord(2, GL_ARRAY_BUFFER, GL_DYNAMIC_DRAW, 20));
+        tracker.track(bufferRecord(3, GL_UNIFORM_BUFFER, GL_DYNAMIC_DRAW, 3));
+        tracker.track(textureRecord(1, GL_RGBA8, 50));
+        tracker.track(textureRecord(2, GL_R8, 5));
+
+        auto byTarget = tracker.getBytesByTarget();
+        EXPECT_EQ(2, byTarget.size());
+        EXPECT_EQ(120, byTarget[GL_ARRAY_BUFFER]);
+        EXPECT_EQ(3, byTarget[GL_UNIFORM_BUFFER]);
+
+        auto byUsage = tracker.getBytesByUsage();
+        EXPECT_EQ(2, byUsage.size());
+        EXPECT_EQ(100, byUsage[GL_STATIC_DRAW]);
+        EXPECT_EQ(23, byUsage[GL_DYNAMIC_DRAW]);
+
+        auto byFormat = tracker.getBytesByFormat();
+        EXPECT_EQ(2, byFormat.size());
+        EXPECT_EQ(50, byFormat[GL_RGBA8]);
+        EXPECT_EQ(5, byFormat[GL_R8]);
+    }
+
+    TEST(ResourceTrackerTest, dump) {
+        ResourceTracker tracker;
+        tracker.track(bufferRecord(1, GL_ARRAY_BUFFER, GL_STATIC_DRAW, 100));
+
+        std::stringstream ss;
+        tracker.dump(ss);
+        EXPECT_NE(std::string::npos, ss.str().find("Buffer 1"));
+        EXPECT_NE(std::string::npos, ss.str().find("Total 100 bytes"));
+    }
+
+    TEST(ResourceTrackerTest, imageSize) {
+        EXPECT_EQ(4 * 4 * 4, ResourceTracker::imageSize(GL_RGBA8, 4, 4));
+        EXPECT_EQ((16 + 4 + 1) * 4, ResourceTracker::imageSize(GL_RGBA8, 4, 4, 3));
+        EXPECT_EQ((8 + 4 + 2 + 1) * 2, ResourceTracker::imageSize(GL_R16F, 8, 1, 4));
+        EXPECT_EQ(4 * 4 * 4 * 4, ResourceTracker::imageSize(GL_RGBA8, 4, 4, 1, 4));
+        EXPECT_EQ(4 * 4 * 16, ResourceTracker::imageSize(GL_RGBA32F, 4, 4));
+    }
+
+    class ResourceTrackerBufferTest : public GLTest {};
+
+    TEST_F(ResourceTrackerBufferTest, Buffer) {
+        auto & tracker = ResourceTracker::getDefault();
+        std::size_t before = tracker.getTotals(ResourceTracker::BufferMemory).current;
+        {
+            Buffer buffer(Buffer::Array);
+            buffer.bufferData(100, nullptr, Buffer::Dynamic);
+            EXPECT_EQ(100, tracker.getBytes(ResourceTracker::BufferMemory,
+                                            buffer.getBufferId()));
+
+            buffer.bufferData(101, nullptr, Buffer::Dynamic);
+            EXPECT_EQ(200, tracker.getBytes(ResourceTracker::BufferMemory,
+                                            buffer.getBufferId()));
+            EXPECT_EQ(before + 200,
+                      tracker.getTotals(ResourceTracker::BufferMemory).current);
+        }
+        EXPECT_EQ(before, tracker.getTotals(ResourceTracker::BufferMemory).current);
+    }
+}
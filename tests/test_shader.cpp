@@ -19,6 +19,37 @@ static const char * fragmentShaderSource = R"(
 void main() {
 })";
 
+static const char * layoutVertexSource = R"(
+#version 330 core
+layout (location = 0) in vec3 aPos;
+layout (location = 1) in mat2 aRot;
+layout (location = 3) in int aId;
+layout (std140) uniform Frame {
+    mat4 viewProj;
+};
+flat out int id;
+void main() {
+    id = aId;
+    gl_Position = viewProj * vec4(vec2(aRot * aPos.xy), aPos.z, 1.0);
+})";
+
+static const char * layoutFragmentSource = R"(
+#version 330 core
+flat in int id;
+out vec4 FragColor;
+void main() {
+    FragColor = vec4(float(id));
+})";
+
+static const char * uniformFragmentSource = R"(
+#version 330 core
+uniform vec4 color;
+uniform float weights[3];
+out vec4 FragColor;
+void main() {
+    FragColor = color * (weights[0] + weights[1] + weights[2]);
+})";
+
 namespace {
     class ShaderTest : public GLTest {
     protected:
@@ -143,4 +174,151 @@ namespace {
         Shader s = Shader::fromFragmentSource(fragmentShaderSource);
         EXPECT_GT(s.getProgram(), 0);
     }
-}
\ No newline at end of file
+
+    TEST(UniformHashTest, literal) {
+        static_assert("model"_h == uniformHash("model"));
+        EXPECT_NE("model"_h, "modle"_h);
+    }
+
+    TEST_F(ShaderTest, uniform_hash) {
+        Shader s = Shader::fromFragmentSource(uniformFragmentSource);
+        EXPECT_TRUE(s.uniform<"color"_h>().exists());
+        EXPECT_EQ(s.uniform("color").getLocation(),
+                  s.uniform<"color"_h>().getLocation());
+        EXPECT_EQ(glGetUniformLocation(s.getProgram(), "color"),
+                  GLint(s.uniform("color").getLocation()));
+        EXPECT_FALSE(s.uniform<"bad"_h>().exists());
+    }
+
+    TEST_F(ShaderTest, uniform_array) {
+        Shader s = Shader::fromFragmentSource(uniformFragmentSource);
+        GLuint first = s.uniform("weights[0]").getLocation();
+        EXPECT_EQ(first, s.uniform("weights").getLocation());
+        for (const char * name : {"weights[0]", "weights[1]", "weights[2]"}) {
+            EXPECT_EQ(glGetUniformLocation(s.getProgram(), name),
+                      GLint(s.uniform(name).getLocation()));
+        }
+        EXPECT_FALSE(s.uniform("weights[3]").exists());
+    }
+
+    TEST_F(ShaderTest, uniform_move) {
+        Shader s = Shader::fromFragmentSource(uniformFragmentSource);
+        GLuint location = s.uniform("color").getLocation();
+        Shader s2(std::move(s));
+        EXPECT_EQ(location, s2.uniform("color").getLocation());
+    }
+
+    TEST_F(ShaderTest, getAttributes) {
+        Shader s(layoutVertexSource, layoutFragmentSource);
+        auto attributes = s.getAttributes();
+        ASSERT_EQ(3, attributes.size());
+        EXPECT_EQ("aPos", attributes[0].name);
+        EXPECT_EQ(GL_FLOAT_VEC3, attributes[0].type);
+        EXPECT_EQ(0, attributes[0].location);
+        EXPECT_EQ("aRot", attributes[1].name);
+        EXPECT_EQ(GL_FLOAT_MAT2, attributes[1].type);
+        EXPECT_EQ(1, attributes[1].location);
+        EXPECT_EQ("aId", attributes[2].name);
+        EXPECT_EQ(3, attributes[2].location);
+    }
+
+    TEST_F(ShaderTest, getUniforms) {
+        Shader s = Shader::fromFragmentSource(uniformFragmentSource);
+        bool foundWeights = false;
+        for (auto & uniform : s.getUniforms()) {
+            if (uniform.name == "weights[0]") {
+                foundWeights = true;
+                EXPECT_EQ(GL_FLOAT, uniform.type);
+                EXPECT_EQ(3, uniform.size);
+                EXPECT_GE(uniform.location, 0);
+            }
+        }
+        EXPECT_TRUE(foundWeights);
+    }
+
+    TEST_F(ShaderTest, getUniformBlocks) {
+        Shader s(layoutVertexSource, layoutFragmentSource);
+        s.bindUniformBlock("Frame", 2);
+        auto blocks = s.getUniformBlocks();
+        ASSERT_EQ(1, blocks.size());
+        EXPECT_EQ("Frame", blocks[0].name);
+        EXPECT_EQ(2, blocks[0].binding);
+        EXPECT_EQ(64, blocks[0].size);
+    }
+
+    TEST_F(ShaderTest, getStorageBlocks_none) {
+        Shader s(layoutVertexSource, layoutFragmentSource);
+        EXPECT_TRUE(s.getStorageBlocks().empty());
+    }
+
+    TEST_F(ShaderTest, checkLayout) {
+        Shader s = Shader::fromFragmentSource(fragmentShaderSource);
+        // Default shader inputs are vec3 pos, vec3 norm and vec2 tex
+        vector<Buffer::Attribute> attributes {
+            {0, 3, GL_FLOAT, false, 8 * sizeof(float), 0},
+            {1, 3, GL_FLOAT, false, 8 * sizeof(float), (void *)(3 * sizeof(float))},
+            {2, 2, GL_FLOAT, false, 8 * sizeof(float), (void *)(6 * sizeof(float))},
+        };
+        EXPECT_TRUE(s.checkLayout(attributes).empty());
+        EXPECT_NO_THROW(s.validateLayout(attributes));
+    }
+
+    TEST_F(ShaderTest, checkLayout_problems) {
+        Shader s(layoutVertexSource, layoutFragmentSource);
+        vector<Buffer::Attribute> attributes {
+            {0, 3, GL_FLOAT, false, 0, 0},
+            {0, 3, GL_FLOAT, false, 0, 0},
+            {1, 2, GL_FLOAT, false, 0, 0},
+            {3, 1, GL_INT, false, 0, 0},
+        };
+        // Duplicate index 0, missing second column of aRot and integer aId
+        EXPECT_EQ(3, s.checkLayout(attributes).size());
+        EXPECT_THROW(s.validateLayout(attributes), ShaderLayoutException);
+    }
+
+    TEST_F(ShaderTest, checkLayout_components) {
+        Shader s(layoutVertexSource, layoutFragmentSource);
+        vector<Buffer::Attribute> attributes {
+            {0, 2, GL_FLOAT, false, 0, 0},
+            {1, 2, GL_FLOAT, false, 0, 0},
+            {2, 2, GL_FLOAT, false, 0, 0},
+            {3, 1, GL_INT, false, 0, 0, 0, true},
+        };
+        // aPos is a vec3 fed by 2 components, valid but warned about
+        vector<string> warnings;
+        EXPECT_TRUE(s.checkLayout(attributes, &warnings).empty());
+        EXPECT_EQ(1, warnings.size());
+        EXPECT_NO_THROW(s.validateLayout(attributes));
+
+        warnings.clear();
+        attributes[0].size = 3;
+        EXPECT_TRUE(s.checkLayout(attributes, &warnings).empty());
+        EXPECT_TRUE(warnings.empty());
+    }
+
+    TEST_F(ShaderTest, checkLayout_normalized) {
+        Shader s(layoutVertexSource, layoutFragmentSource);
+        vector<Buffer::Attribute> attributes {
+            {0, 3, GL_UNSIGNED_BYTE, false, 0, 0},
+            {1, 2, GL_FLOAT, false, 0, 0},
+            {2, 2, GL_FLOAT, false, 0, 0},
+            {3, 1, GL_INT, false, 0, 0, 0, true},
+        };
+        // Bytes read as 0 to 255 by the float aPos, valid but warned about
+        vector<string> warnings;
+        EXPECT_TRUE(s.checkLayout(attributes, &warnings).empty());
+        EXPECT_EQ(1, warnings.size());
+        EXPECT_NO_THROW(s.validateLayout(attributes));
+
+        warnings.clear();
+        attributes[0].normalized = true;
+        EXPECT_TRUE(s.checkLayout(attributes, &warnings).empty());
+        EXPECT_TRUE(warnings.empty());
+    }
+
+    TEST_F(ShaderTest, validateLayout_array) {
+        Shader s(layoutVertexSource, layoutFragmentSource);
+        BufferArray array({{{0, 3, GL_FLOAT, false, 0, 0}}});
+        EXPECT_THROW(s.validateLayout(array), ShaderLayoutException);
+    }
+}
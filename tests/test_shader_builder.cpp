@@ -0,0 +1,110 @@
+#include <glpp/ShaderBuilder.hpp>
+#include <glpp/extra/Line.hpp>
+using namespace glpp;
+
+#include <gtest/gtest.h>
+
+#include <iostream>
+#include <stdexcept>
+
+#include "glTest.hpp"
+
+static const char * vertexShaderSource = R"(
+#version 330 core
+layout (location = 0) in vec3 aPos;
+out vec3 outPos;
+void main() {
+    outPos = aPos;
+    gl_Position = vec4(aPos, 1.0);
+})";
+
+static const char * fragmentShaderSource = R"(
+#version 330 core
+out vec4 FragColor;
+void main() {
+    FragColor = vec4(1.0);
+})";
+
+static const char * badShaderSource = R"(
+#version 330 core
+void main() {
+    not glsl
+})";
+
+namespace {
+    class ShaderBuilderTest : public GLTest {
+    protected:
+        ShaderBuilder builder;
+    };
+
+    TEST_F(ShaderBuilderTest, Handle_empty) {
+        ShaderBuilder::Handle handle;
+        EXPECT_FALSE(handle);
+        EXPECT_FALSE(handle.ready());
+    }
+
+    TEST_F(ShaderBuilderTest, add) {
+        auto handle = builder.add(vertexShaderSource, fragmentShaderSource);
+        EXPECT_TRUE(handle);
+        Shader & shader = handle.get();
+        EXPECT_GT(shader.getProgram(), 0);
+        EXPECT_TRUE(handle.ready());
+        EXPECT_EQ(&shader, &handle.get());
+    }
+
+    TEST_F(ShaderBuilderTest, addVertex) {
+        auto handle = builder.addVertex(vertexShaderSource, {"outPos"});
+        EXPECT_GT(handle.get().getProgram(), 0);
+    }
+
+    TEST_F(ShaderBuilderTest, many) {
+        vector<ShaderBuilder::Handle> handles;
+        for (int i = 0; i < 8; i++) {
+            handles.push_back(builder.add(vertexShaderSource, fragmentShaderSource));
+        }
+        builder.finish();
+        EXPECT_EQ(0, builder.getPending());
+        for (auto & handle : handles) {
+            EXPECT_TRUE(handle.ready());
+            EXPECT_GT(handle.get().getProgram(), 0);
+        }
+    }
+
+    TEST_F(ShaderBuilderTest, compileError) {
+        auto handle = builder.add(vertexShaderSource, badShaderSource);
+        EXPECT_THROW(handle.get(), ShaderCompileException);
+        // The same error is reported again
+        EXPECT_THROW(handle.get(), ShaderCompileException);
+        EXPECT_TRUE(handle.ready());
+    }
+
+    TEST_F(ShaderBuilderTest, finish_error) {
+        auto good = builder.add(vertexShaderSource, fragmentShaderSource);
+        builder.add(vertexShaderSource, badShaderSource);
+        EXPECT_THROW(builder.finish(), ShaderCompileException);
+        EXPECT_GT(good.get().getProgram(), 0);
+    }
+
+    TEST_F(ShaderBuilderTest, warmShader) {
+        extra::Line::warmShader(builder);
+        EXPECT_GT(extra::Line::shader().getProgram(), 0);
+    }
+
+    TEST_F(ShaderBuilderTest, WarmShader) {
+        int setups = 0;
+        WarmShader warm(vertexShaderSource, fragmentShaderSource,
+                        [&setups](Shader &) { setups++; });
+        warm.warm(builder);
+        warm.warm(builder);
+
+        Shader & shader = warm.get();
+        EXPECT_GT(shader.getProgram(), 0);
+        EXPECT_EQ(&shader, &warm.get());
+        EXPECT_EQ(1, setups);
+    }
+
+    TEST_F(ShaderBuilderTest, WarmShader_cold) {
+        WarmShader warm(vertexShaderSource, fragmentShaderSource);
+        EXPECT_GT(warm.get().getProgram(), 0);
+    }
+}
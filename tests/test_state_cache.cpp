@@ -0,0 +1,127 @@
+#include <glpp/Buffer.hpp>
+#include <glpp/StateCache.hpp>
+#include <glpp/Texture.hpp>
+using namespace glpp;
+
+#include <gtest/gtest.h>
+
+#include <iostream>
+#include <stdexcept>
+#include <thread>
+
+#include "glTest.hpp"
+
+namespace {
+    class StateCacheTest : public GLTest {
+    protected:
+        StateCache & cache;
+
+        StateCacheTest() : GLTest(), cache(StateCache::current()) {
+            cache.resetCounters();
+        }
+    };
+
+    TEST_F(StateCacheTest, current) {
+        EXPECT_EQ(&cache, &StateCache::current());
+    }
+
+    TEST_F(StateCacheTest, existing) {
+        EXPECT_EQ(&cache, StateCache::existing());
+
+        // A thread has no cache until current is called
+        StateCache * other = &cache;
+        std::thread([&other] { other = StateCache::existing(); }).join();
+        EXPECT_EQ(nullptr, other);
+    }
+
+    TEST_F(StateCacheTest, bindBuffer_skip) {
+        Buffer buffer;
+        buffer.bind();
+        buffer.bind();
+        EXPECT_EQ(1, cache.getCounters(StateCache::BufferBind).issued);
+        EXPECT_EQ(1, cache.getCounters(StateCache::BufferBind).skipped);
+    }
+
+    TEST_F(StateCacheTest, bindBuffer_targets) {
+        Buffer array(Buffer::Array);
+        Buffer uniform(Buffer::Uniform);
+        array.bind();
+        uniform.bind();
+        EXPECT_EQ(2, cache.getCounters(StateCache::BufferBind).issued);
+        EXPECT_EQ(0, cache.getSkipped());
+    }
+
+    TEST_F(StateCacheTest, bindVertexArray_element) {
+        BufferArray array;
+        Buffer elements(Buffer::Index);
+        array.bind();
+        elements.bind();
+        BufferArray::unbind();
+        array.bind();
+        // Element buffer binding is vertex array state
+        elements.bind();
+        EXPECT_EQ(2, cache.getCounters(StateCache::BufferBind).issued);
+    }
+
+    TEST_F(StateCacheTest, deleteBuffer) {
+        {
+            Buffer buffer;
+            buffer.bind();
+        }
+        Buffer buffer;
+        buffer.bind();
+        EXPECT_EQ(2, cache.getCounters(StateCache::BufferBind).issued);
+    }
+
+    TEST_F(StateCacheTest, bindTexture) {
+        Texture texture({1, 1});
+        cache.resetCounters();
+        texture.bind(1);
+        texture.bind(1);
+        EXPECT_EQ(1, cache.getCounters(StateCache::TextureBind).issued);
+        EXPECT_EQ(1, cache.getCounters(StateCache::TextureBind).skipped);
+        EXPECT_EQ(1, cache.getActiveTexture());
+    }
+
+    TEST_F(StateCacheTest, invalidate) {
+        Buffer buffer;
+        buffer.bind();
+        cache.invalidate();
+        buffer.bind();
+        EXPECT_EQ(2, cache.getCounters(StateCache::BufferBind).issued);
+    }
+
+    TEST_F(StateCacheTest, resetCounters) {
+        Buffer buffer;
+        buffer.bind();
+        buffer.bind();
+        cache.resetCounters();
+        EXPECT_EQ(0, cache.getCounters(StateCache::BufferBind).issued);
+        EXPECT_EQ(0, cache.getSkipped());
+    }
+
+    TEST_F(StateCacheTest, setDirectStateAccess) {
+        cache.setDirectStateAccess(false);
+        EXPECT_FALSE(cache.hasDirectStateAccess());
+        cache.setDirectStateAccess(true);
+        EXPECT_EQ(bool(GLEW_VERSION_4_5 || GLEW_ARB_direct_state_access),
+                  cache.hasDirectStateAccess());
+    }
+
+    TEST_F(StateCacheTest, directStateAccess_bufferData) {
+        if (!cache.hasDirectStateAccess())
+            GTEST_SKIP();
+        Buffer buffer;
+        buffer.bufferData(16, nullptr, Buffer::Dynamic);
+        buffer.bufferSubData(0, 4, "abc");
+        EXPECT_EQ(0, cache.getCounters(StateCache::BufferBind).issued);
+    }
+
+    TEST_F(StateCacheTest, bindToEdit_bufferData) {
+        cache.setDirectStateAccess(false);
+        Buffer buffer;
+        buffer.bufferData(16, nullptr, Buffer::Dynamic);
+        EXPECT_EQ(1, cache.getCounters(StateCache::BufferBind).issued);
+        cache.setDirectStateAccess(true);
+    }
+}
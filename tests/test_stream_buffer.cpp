@@ -0,0 +1,147 @@
+#include <glpp/StreamBuffer.hpp>
+using namespace glpp;
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+
+#include "glTest.hpp"
+
+namespace {
+    class StreamBufferTest : public GLTest {
+    protected:
+        bool supported;
+
+        StreamBufferTest()
+            : GLTest(), supported(GLEW_VERSION_4_4 || GLEW_ARB_buffer_storage) {}
+    };
+
+    TEST_F(StreamBufferTest, StreamBuffer) {
+        if (!supported)
+            GTEST_SKIP();
+
+        StreamBuffer buffer(256, 3);
+        EXPECT_NE(0, buffer.getBufferId());
+        EXPECT_EQ(256, buffer.getRegionSize());
+        EXPECT_EQ(3, buffer.getRegionCount());
+        EXPECT_EQ(0, buffer.getRegion());
+        EXPECT_EQ(0, buffer.getRegionOffset());
+        EXPECT_EQ(256, buffer.getRemaining());
+        EXPECT_EQ(768, buffer.getSize());
+        EXPECT_EQ(768, buffer.getCapacity());
+    }
+
+    TEST_F(StreamBufferTest, no_regions) {
+        if (!supported)
+            GTEST_SKIP();
+
+        EXPECT_THROW(StreamBuffer(256, 0), StreamBufferException);
+    }
+
+    TEST_F(StreamBufferTest, allocate) {
+        if (!supported)
+            GTEST_SKIP();
+
+        StreamBuffer buffer(256, 3);
+        auto a = buffer.allocate(10, 1);
+        EXPECT_EQ(0, a.offset);
+        EXPECT_EQ(10, a.size);
+        EXPECT_NE(nullptr, a.data);
+
+        auto b = buffer.allocate(12, 12);
+        EXPECT_EQ(12, b.offset);
+        EXPECT_EQ(static_cast<unsigned char *>(a.data) + 12, b.data);
+        EXPECT_EQ(232, buffer.getRemaining());
+    }
+
+    TEST_F(StreamBufferTest, allocate_full) {
+        if (!supported)
+            GTEST_SKIP();
+
+        StreamBuffer buffer(256, 3);
+        buffer.allocate(200);
+        EXPECT_THROW(buffer.allocate(100), StreamBufferException);
+        EXPECT_NO_THROW(buffer.allocate(56));
+        EXPECT_EQ(0, buffer.getRemaining());
+    }
+
+    TEST_F(StreamBufferTest, nextFrame) {
+        if (!supported)
+            GTEST_SKIP();
+
+        StreamBuffer buffer(256, 3);
+        buffer.allocate(16);
+        buffer.nextFrame();
+        EXPECT_EQ(1, buffer.getRegion());
+        EXPECT_EQ(256, buffer.getRegionOffset());
+        EXPECT_EQ(256, buffer.getRemaining());
+
+        auto a = buffer.allocate(16, 12);
+        EXPECT_EQ(264, a.offset);
+
+        buffer.nextFrame();
+        buffer.nextFrame();
+        EXPECT_EQ(0, buffer.getRegion());
+        EXPECT_EQ(0, buffer.getRegionOffset());
+    }
+
+    TEST_F(StreamBufferTest, fence) {
+        if (!supported)
+            GTEST_SKIP();
+
+        StreamBuffer buffer(16, 2);
+        int values[] = {1, 2, 3, 4};
+
+        // Fill both regions, then wrap around to the fenced first region
+        for (int frame = 0; frame < 3; frame++) {
+            auto alloc = buffer.allocate(sizeof(values));
+            EXPECT_EQ((frame % 2) * 16, alloc.offset);
+            std::memcpy(alloc.data, values, sizeof(values));
+            values[0]++;
+            buffer.nextFrame();
+        }
+
+        int read[4] = {0};
+        buffer.bind();
+        glGetBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(read), read);
+        EXPECT_EQ(3, read[0]);
+        EXPECT_EQ(4, read[3]);
+        glGetBufferSubData(GL_ARRAY_BUFFER, 16, sizeof(read), read);
+        EXPECT_EQ(2, read[0]);
+    }
+
+    TEST_F(StreamBufferTest, moveAssign) {
+        if (!supported)
+            GTEST_SKIP();
+
+        StreamBuffer a(64, 2);
+        StreamBuffer b(128, 3);
+        a.allocate(16);
+        a.nextFrame();
+        a = std::move(b);
+        EXPECT_EQ(128, a.getRegionSize());
+        EXPECT_EQ(3, a.getRegionCount());
+        EXPECT_NO_THROW(a.allocate(16));
+
+        EXPECT_EQ(0, b.getRegionCount());
+        EXPECT_THROW(b.allocate(16), StreamBufferException);
+        EXPECT_NO_THROW(b.nextFrame());
+        EXPECT_EQ(GL_NO_ERROR, glGetError());
+    }
+
+    TEST_F(StreamBufferTest, immutable) {
+        if (!supported)
+            GTEST_SKIP();
+
+        StreamBuffer buffer(64, 2);
+        Buffer & base = buffer;
+        EXPECT_TRUE(base.isImmutable());
+        EXPECT_THROW(base.reserve(256), BufferException);
+        EXPECT_THROW(base.bufferData(16, nullptr), BufferException);
+        EXPECT_THROW(base.bufferSubData(0, 16, nullptr), BufferException);
+        EXPECT_EQ(128, base.getCapacity());
+        EXPECT_EQ(GL_NO_ERROR, glGetError());
+    }
+}
@@ -1,3 +1,5 @@
+#include <glpp/ResourceTracker.hpp>
+#include <glpp/StateCache.hpp>
 #include <glpp/Texture.hpp>
 using namespace glpp;
 
@@ -42,6 +44,31 @@ namespace {
         EXPECT_EQ(size, texture.getSize());
     }
 
+    TEST_F(TextureTest, resize_bindToEdit) {
+        StateCache::current().setDirectStateAccess(false);
+        Texture t(size);
+        GLuint id = t.getTextureId();
+        t.resize({20, 10});
+        EXPECT_EQ(id, t.getTextureId());
+        StateCache::current().setDirectStateAccess(true);
+    }
+
+    TEST_F(TextureTest, mipmaps_emptySize) {
+        StateCache::current().setDirectStateAccess(false);
+        Texture t(glm::uvec2(0, 0));
+        StateCache::current().setDirectStateAccess(true);
+
+        bool found = false;
+        for (auto & record : ResourceTracker::getDefault().getRecords()) {
+            if (record.kind == ResourceTracker::TextureMemory
+                && record.id == t.getTextureId()) {
+                EXPECT_EQ(1, record.levels);
+                found = true;
+            }
+        }
+        EXPECT_TRUE(found);
+    }
+
     TEST_F(TextureTest, Move) {
         GLuint id = texture.getTextureId();
         Texture t(std::move(texture));
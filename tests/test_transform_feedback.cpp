@@ -0,0 +1,102 @@
+#include <glpp/Buffer.hpp>
+#include <glpp/Shader.hpp>
+#include <glpp/StateCache.hpp>
+#include <glpp/TransformFeedback.hpp>
+using namespace glpp;
+
+#include <gtest/gtest.h>
+
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+
+#include "glTest.hpp"
+
+static const char * feedbackShaderSource = R"(
+#version 330 core
+out float outValue;
+void main() {
+    outValue = float(gl_VertexID) * 2.0;
+})";
+
+namespace {
+    class TransformFeedbackTest : public GLTest {
+    protected:
+        TransformFeedback::Ptr feedback;
+        Buffer output;
+
+        TransformFeedbackTest() : GLTest(), output(Buffer::TransformFeedback) {}
+
+        void SetUp() override {
+            if (!TransformFeedback::isSupported())
+                GTEST_SKIP();
+            feedback = std::make_shared<TransformFeedback>();
+        }
+    };
+
+    TEST_F(TransformFeedbackTest, TransformFeedback) {
+        EXPECT_NE(0, feedback->getFeedbackId());
+        EXPECT_FALSE(feedback->isActive());
+        EXPECT_FALSE(feedback->isPaused());
+    }
+
+    TEST_F(TransformFeedbackTest, bind) {
+        auto & cache = StateCache::current();
+        cache.resetCounters();
+        feedback->bind();
+        feedback->bind();
+        EXPECT_EQ(1, cache.getCounters(StateCache::TransformFeedbackBind).issued);
+        EXPECT_EQ(1, cache.getCounters(StateCache::TransformFeedbackBind).skipped);
+        feedback->unbind();
+    }
+
+    TEST_F(TransformFeedbackTest, capture) {
+        Shader shader = Shader::fromVertexSource(feedbackShaderSource, {"outValue"});
+        BufferArray array;
+        output.bufferData(4 * sizeof(float), nullptr, Buffer::StreamRead);
+        feedback->bindBuffer(0, output);
+
+        shader.bind();
+        array.bind();
+        glEnable(GL_RASTERIZER_DISCARD);
+        feedback->begin(Buffer::Points);
+        EXPECT_TRUE(feedback->isActive());
+        array.drawArrays(Buffer::Points, 0, 4);
+        feedback->end();
+        glDisable(GL_RASTERIZER_DISCARD);
+
+        EXPECT_FALSE(feedback->isActive());
+        EXPECT_EQ(4, feedback->getPrimitivesWritten());
+        EXPECT_TRUE(feedback->isResultAvailable());
+
+        float values[4] {};
+        output.bind();
+        glGetBufferSubData(GL_TRANSFORM_FEEDBACK_BUFFER, 0, sizeof(values), values);
+        EXPECT_EQ(0.0f, values[0]);
+        EXPECT_EQ(2.0f, values[1]);
+        EXPECT_EQ(6.0f, values[3]);
+    }
+
+    TEST_F(TransformFeedbackTest, pause) {
+        Shader shader = Shader::fromVertexSource(feedbackShaderSource, {"outValue"});
+        BufferArray array;
+        output.bufferData(4 * sizeof(float), nullptr, Buffer::StreamRead);
+        feedback->bindBuffer(0, output);
+
+        shader.bind();
+        array.bind();
+        glEnable(GL_RASTERIZER_DISCARD);
+        feedback->begin(Buffer::Points);
+        array.drawArrays(Buffer::Points, 0, 2);
+        feedback->pause();
+        EXPECT_TRUE(feedback->isPaused());
+        array.drawArrays(Buffer::Points, 0, 2);
+        feedback->resume();
+        EXPECT_FALSE(feedback->isPaused());
+        array.drawArrays(Buffer::Points, 0, 1);
+        feedback->end();
+        glDisable(GL_RASTERIZER_DISCARD);
+
+        EXPECT_EQ(3, feedback->getPrimitivesWritten());
+    }
+}
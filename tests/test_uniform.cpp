@@ -8,6 +8,15 @@ using namespace glpp;
 
 #include "glTest.hpp"
 
+static const char * fragmentShaderSource = R"(
+#version 330 core
+uniform vec4 color;
+uniform float weight;
+out vec4 FragColor;
+void main() {
+    FragColor = color * weight;
+})";
+
 namespace {
     TEST(UniformTest, Uniform) {
         Uniform u;
@@ -18,4 +27,88 @@ namespace {
         Uniform u(1);
         EXPECT_EQ(1, u.getLocation());
     }
-}
\ No newline at end of file
+
+    class UniformShadowTest : public GLTest {
+    protected:
+        Shader shader;
+
+        UniformShadowTest()
+            : GLTest(), shader(Shader::fromFragmentSource(fragmentShaderSource)) {
+            shader.bind();
+        }
+    };
+
+    TEST_F(UniformShadowTest, skip) {
+        auto color = shader.uniform("color");
+        color.setVec4({1, 2, 3, 4});
+        color.setVec4({1, 2, 3, 4});
+        EXPECT_EQ(1, shader.getUniformCounters().issued);
+        EXPECT_EQ(1, shader.getUniformCounters().skipped);
+
+        glm::vec4 value;
+        glGetUniformfv(shader.getProgram(), color.getLocation(), &value.x);
+        EXPECT_EQ(glm::vec4(1, 2, 3, 4), value);
+    }
+
+    TEST_F(UniformShadowTest, changed) {
+        auto weight = shader.uniform<"weight"_h>();
+        weight.setFloat(1);
+        weight.setFloat(2);
+        EXPECT_EQ(2, shader.getUniformCounters().issued);
+        EXPECT_EQ(0, shader.getUniformCounters().skipped);
+
+        float value = 0;
+        glGetUniformfv(shader.getProgram(), weight.getLocation(), &value);
+        EXPECT_EQ(2, value);
+    }
+
+    TEST_F(UniformShadowTest, sharedBetweenCopies) {
+        shader.uniform("weight").setFloat(1);
+        shader.uniform("weight").setFloat(1);
+        EXPECT_EQ(1, shader.getUniformCounters().skipped);
+    }
+
+    TEST_F(UniformShadowTest, invalidateUniforms) {
+        auto weight = shader.uniform("weight");
+        weight.setFloat(1);
+        shader.invalidateUniforms();
+        weight.setFloat(1);
+        EXPECT_EQ(2, shader.getUniformCounters().issued);
+    }
+
+    TEST_F(UniformShadowTest, resetUniformCounters) {
+        shader.uniform("weight").setFloat(1);
+        shader.resetUniformCounters();
+        EXPECT_EQ(0, shader.getUniformCounters().issued);
+        EXPECT_EQ(0, shader.getUniformCounters().skipped);
+    }
+
+    TEST_F(UniformShadowTest, move) {
+        auto weight = shader.uniform("weight");
+        weight.setFloat(1);
+        Shader moved(std::move(shader));
+        weight.setFloat(1);
+        EXPECT_EQ(1, moved.getUniformCounters().skipped);
+    }
+
+    TEST_F(UniformShadowTest, moveAssign) {
+        auto weight = shader.uniform("weight");
+        weight.setFloat(1);
+
+        // The old shadow stays alive for weight
+        shader = Shader::fromFragmentSource(fragmentShaderSource);
+        weight.setFloat(1);
+        weight.setFloat(2);
+        EXPECT_EQ(0, shader.getUniformCounters().issued);
+        EXPECT_EQ(0, shader.getUniformCounters().skipped);
+    }
+
+    TEST_F(UniformShadowTest, notShadowed) {
+        // Uniforms created from a location always call OpenGL
+        Uniform weight(shader.uniform("weight").getLocation());
+        weight.setFloat(1);
+        weight.setFloat(1);
+        EXPECT_EQ(0, shader.getUniformCounters().issued);
+        EXPECT_EQ(0, shader.getUniformCounters().skipped);
+    }
+}
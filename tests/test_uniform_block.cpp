@@ -0,0 +1,203 @@
+#include <glpp/Shader.hpp>
+#include <glpp/UniformBlock.hpp>
+using namespace glpp;
+
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <iostream>
+#include <stdexcept>
+
+#include "glTest.hpp"
+
+namespace {
+    struct Material {
+        std140::vec4 color;
+        float roughness;
+        std140::vec2 scale;
+        std140::vec3 emissive;
+        std140::mat3 normal;
+        std140::array<float, 3> weights;
+    };
+
+    struct alignas(16) Light {
+        std430::vec3 position;
+        std430::vec4 color;
+        float radius;
+    };
+
+    struct Particles {
+        std430::array<float, 3> mass;
+        std430::vec2 velocity;
+        std430::mat2 rotation;
+    };
+
+    static const char * blockShaderSource = R"(
+#version 330 core
+layout (std140) uniform Material {
+    vec4 color;
+};
+void main() {
+    gl_Position = color;
+})";
+
+    static const char * materialShaderSource = R"(
+#version 330 core
+layout (std140) uniform Material {
+    vec4 color;
+    float roughness;
+    vec2 scale;
+    vec3 emissive;
+    mat3 normal;
+    float weights[3];
+};
+void main() {
+    gl_Position = color * roughness + vec4(scale, emissive.x, normal[0].x)
+                  + vec4(weights[0]);
+})";
+
+    static const char * fragmentShaderSource = R"(
+#version 330 core
+out vec4 FragColor;
+void main() {
+    FragColor = vec4(1.0);
+})";
+
+    TEST(UniformBlockTest, std140) {
+        EXPECT_EQ(0, offsetof(Material, color));
+        EXPECT_EQ(16, offsetof(Material, roughness));
+        EXPECT_EQ(24, offsetof(Material, scale));
+        EXPECT_EQ(32, offsetof(Material, emissive));
+        EXPECT_EQ(48, offsetof(Material, normal));
+        EXPECT_EQ(96, offsetof(Material, weights));
+        EXPECT_EQ(144, sizeof(Material));
+    }
+
+    TEST(UniformBlockTest, std430) {
+        EXPECT_EQ(0, offsetof(Light, position));
+        EXPECT_EQ(16, offsetof(Light, color));
+        EXPECT_EQ(32, offsetof(Light, radius));
+        EXPECT_EQ(48, sizeof(Light));
+
+        EXPECT_EQ(0, offsetof(Particles, mass));
+        EXPECT_EQ(16, offsetof(Particles, velocity));
+        EXPECT_EQ(24, offsetof(Particles, rotation));
+        EXPECT_EQ(40, sizeof(Particles));
+    }
+
+    TEST(UniformBlockTest, FrameUniforms) {
+        EXPECT_EQ(0, offsetof(FrameUniforms, view));
+        EXPECT_EQ(64, offsetof(FrameUniforms, projection));
+        EXPECT_EQ(128, offsetof(FrameUniforms, viewProj));
+        EXPECT_EQ(192, offsetof(FrameUniforms, cameraPos));
+        EXPECT_EQ(208, offsetof(FrameUniforms, screenSize));
+    }
+
+    TEST(UniformBlockTest, BlockMatrix) {
+        glm::mat3 value(1, 2, 3, 4, 5, 6, 7, 8, 9);
+        std140::mat3 block = value;
+        EXPECT_EQ(glm::vec3(4, 5, 6), block.columns[1].value);
+        EXPECT_EQ(value, glm::mat3(block));
+    }
+
+    TEST(UniformBlockTest, BlockArray) {
+        std140::array<float, 3> values;
+        values[1] = 2.0f;
+        EXPECT_EQ(3, values.size());
+        EXPECT_EQ(2.0f, values[1]);
+        EXPECT_EQ(reinterpret_cast<const char *>(&values[1]),
+                  reinterpret_cast<const char *>(&values[0]) + 16);
+    }
+
+    class UniformBlockGLTest : public GLTest {};
+
+    TEST_F(UniformBlockGLTest, UniformBlock) {
+        UniformBlock<Material> block;
+        EXPECT_EQ(Buffer::Uniform, block.getTarget());
+        EXPECT_EQ(sizeof(Material), block.getCapacity());
+
+        Material material {};
+        material.roughness = 0.5f;
+        block.set(material);
+        block.set(&Material::roughness, 0.25f);
+        block.set(&Material::color, glm::vec4(1, 2, 3, 4));
+
+        float roughness = 0;
+        glm::vec4 color(0);
+        block.bind();
+        glGetBufferSubData(GL_UNIFORM_BUFFER, offsetof(Material, roughness),
+                           sizeof(float), &roughness);
+        glGetBufferSubData(GL_UNIFORM_BUFFER, offsetof(Material, color),
+                           sizeof(color), &color);
+        EXPECT_EQ(0.25f, roughness);
+        EXPECT_EQ(glm::vec4(1, 2, 3, 4), color);
+    }
+
+    TEST_F(UniformBlockGLTest, Material_shader) {
+        Shader shader(materialShaderSource, fragmentShaderSource);
+        GLuint program = shader.getProgram();
+
+        GLuint block = glGetUniformBlockIndex(program, "Material");
+        ASSERT_NE(GL_INVALID_INDEX, block);
+        GLint size = 0;
+        glGetActiveUniformBlockiv(program, block, GL_UNIFORM_BLOCK_DATA_SIZE, &size);
+        EXPECT_EQ(sizeof(Material), size);
+
+        const char * names[] = {"color", "roughness", "scale", "emissive", "normal", "weights[0]"};
+        GLuint indices[6];
+        GLint offsets[6];
+        glGetUniformIndices(program, 6, names, indices);
+        glGetActiveUniformsiv(program, 6, indices, GL_UNIFORM_OFFSET, offsets);
+        EXPECT_EQ(offsetof(Material, color), offsets[0]);
+        EXPECT_EQ(offsetof(Material, roughness), offsets[1]);
+        EXPECT_EQ(offsetof(Material, scale), offsets[2]);
+        EXPECT_EQ(offsetof(Material, emissive), offsets[3]);
+        EXPECT_EQ(offsetof(Material, normal), offsets[4]);
+        EXPECT_EQ(offsetof(Material, weights), offsets[5]);
+    }
+
+    TEST_F(UniformBlockGLTest, StorageBlock) {
+        StorageBlock<Light> block(4);
+        EXPECT_EQ(Buffer::ShaderStorage, block.getTarget());
+        EXPECT_EQ(4, block.getCount());
+        EXPECT_EQ(4 * sizeof(Light), block.getCapacity());
+
+        block.set(vector<Light>(2));
+        EXPECT_EQ(2, block.getCount());
+    }
+
+    TEST_F(UniformBlockGLTest, bindUniformBlock) {
+        Shader shader(blockShaderSource, fragmentShaderSource);
+        EXPECT_TRUE(shader.bindUniformBlock("Material", 2));
+        EXPECT_FALSE(shader.bindUniformBlock("Missing", 2));
+        EXPECT_FALSE(shader.bindStorageBlock("Missing", 2));
+
+        GLuint index = glGetUniformBlockIndex(shader.getProgram(), "Material");
+        GLint binding = 0;
+        glGetActiveUniformBlockiv(shader.getProgram(), index,
+                                  GL_UNIFORM_BLOCK_BINDING, &binding);
+        EXPECT_EQ(2, binding);
+    }
+
+    TEST_F(UniformBlockGLTest, FrameUniforms_shader) {
+        Shader shader = Shader::fromFragmentSource(fragmentShaderSource);
+        GLuint program = shader.getProgram();
+
+        GLuint block = glGetUniformBlockIndex(program, "Frame");
+        ASSERT_NE(GL_INVALID_INDEX, block);
+        GLint binding = -1;
+        glGetActiveUniformBlockiv(program, block, GL_UNIFORM_BLOCK_BINDING, &binding);
+        EXPECT_EQ(FrameUniforms::binding, binding);
+
+        const char * names[] = {"view", "projection", "viewProj", "cameraPos", "screenSize"};
+        GLuint indices[5];
+        GLint offsets[5];
+        glGetUniformIndices(program, 5, names, indices);
+        glGetActiveUniformsiv(program, 5, indices, GL_UNIFORM_OFFSET, offsets);
+        EXPECT_EQ(offsetof(FrameUniforms, view), offsets[0]);
+        EXPECT_EQ(offsetof(FrameUniforms, projection), offsets[1]);
+        EXPECT_EQ(offsetof(FrameUniforms, viewProj), offsets[2]);
+        EXPECT_EQ(offsetof(FrameUniforms, cameraPos), offsets[3]);
+        EXPECT_EQ(offsetof(FrameUniforms, screenSize), offsets[4]);
+    }
+}
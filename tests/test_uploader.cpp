@@ -0,0 +1,109 @@
+#include <glpp/Uploader.hpp>
+using namespace glpp;
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+
+#include "glTest.hpp"
+
+namespace {
+    class UploaderTest : public GLTest {
+    protected:
+        GLFWwindow * shared;
+        std::unique_ptr<Uploader> uploader;
+
+        UploaderTest() : GLTest() {
+            shared = glfwCreateWindow(1, 1, "Uploader", NULL, window);
+            if (!shared) {
+                throw std::runtime_error("Failed to create shared GLFW Window");
+            }
+            GLFWwindow * context = shared;
+            uploader = std::make_unique<Uploader>(
+                [context] { glfwMakeContextCurrent(context); },
+                [] { glfwMakeContextCurrent(NULL); });
+        }
+
+        ~UploaderTest() override {
+            uploader.reset();
+            glfwDestroyWindow(shared);
+        }
+    };
+
+    TEST_F(UploaderTest, submit) {
+        std::atomic<std::thread::id> worker;
+        auto ticket = uploader->submit([&worker] {
+            worker = std::this_thread::get_id();
+        });
+        ticket.wait();
+        EXPECT_TRUE(ticket.isReady());
+        EXPECT_NE(std::this_thread::get_id(), worker.load());
+    }
+
+    TEST_F(UploaderTest, Ticket_default) {
+        Uploader::Ticket ticket;
+        EXPECT_TRUE(ticket.isReady());
+        EXPECT_NO_THROW(ticket.wait());
+    }
+
+    TEST_F(UploaderTest, submit_error) {
+        auto ticket = uploader->submit([] {
+            throw std::runtime_error("upload failed");
+        });
+        EXPECT_THROW(ticket.wait(), std::runtime_error);
+    }
+
+    TEST_F(UploaderTest, bufferData) {
+        auto buffer = std::make_shared<Buffer>(Buffer::Array);
+        vector<float> data {1, 2, 3, 4};
+        auto ticket = uploader->bufferData(buffer, data);
+        ticket.wait();
+
+        EXPECT_EQ(4 * sizeof(float), buffer->getSize());
+        float values[4] {};
+        buffer->bind();
+        glGetBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(values), values);
+        EXPECT_EQ(1.0f, values[0]);
+        EXPECT_EQ(4.0f, values[3]);
+    }
+
+    TEST_F(UploaderTest, loadTexture) {
+        auto texture = std::make_shared<Texture>(glm::uvec2(1, 1));
+        // Cache a binding of the old texture on the render thread
+        texture->bind();
+
+        vector<unsigned char> data(2 * 2 * 4);
+        for (std::size_t i = 0; i < data.size(); i++) {
+            data[i] = i * 10;
+        }
+        auto ticket = uploader->loadTexture(texture, data, {2, 2}, 4);
+        ticket.wait();
+        EXPECT_EQ(glm::uvec2(2, 2), texture->getSize());
+
+        vector<unsigned char> pixels(data.size());
+        texture->bind();
+        glGetTexImage(GL_TEXTURE_2D, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+        EXPECT_EQ(data, pixels);
+    }
+
+    TEST_F(UploaderTest, loadTexture_missing) {
+        auto texture = std::make_shared<Texture>(glm::uvec2(1, 1));
+        auto ticket = uploader->loadTexture(texture, "missing.png");
+        EXPECT_THROW(ticket.wait(), TextureLoadException);
+    }
+
+    TEST_F(UploaderTest, finish) {
+        for (int i = 0; i < 4; i++) {
+            uploader->submit([] {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            });
+        }
+        uploader->finish();
+        EXPECT_EQ(0, uploader->getPending());
+    }
+}
@@ -156,4 +156,102 @@ namespace {
         EXPECT_EQ(glm::vec3(0), v2.norm);
         EXPECT_EQ(glm::vec2(0), v2.uv);
     }
-}
\ No newline at end of file
+
+    TEST(CompactVertexTest, size) {
+        EXPECT_EQ(20, sizeof(CompactVertex));
+    }
+
+    TEST(CompactVertexTest, PackedNormal) {
+        EXPECT_EQ(0, PackedNormal().bits);
+        EXPECT_EQ(0x1FF, PackedNormal({1, 0, 0}).bits);
+        EXPECT_EQ(0x201u << 10, PackedNormal({0, -1, 0}).bits);
+        EXPECT_EQ(0x1FFu << 20, PackedNormal({0, 0, 2}).bits);
+
+        glm::vec3 norm = PackedNormal({0.5f, -0.25f, 0.75f}).unpack();
+        EXPECT_NEAR(0.5f, norm.x, 1.0f / 511);
+        EXPECT_NEAR(-0.25f, norm.y, 1.0f / 511);
+        EXPECT_NEAR(0.75f, norm.z, 1.0f / 511);
+    }
+
+    TEST(CompactVertexTest, HalfVec2) {
+        HalfVec2 half({1, -2});
+        EXPECT_EQ(0x3C00, half.x);
+        EXPECT_EQ(0xC000, half.y);
+        EXPECT_EQ(glm::vec2(1, -2), half.unpack());
+
+        EXPECT_EQ(0x7C00, HalfVec2({70000, 0}).x);
+        EXPECT_EQ(0x0001, HalfVec2({5.96e-8f, 0}).x);
+        EXPECT_NEAR(0.1f, HalfVec2({0.1f, 0}).unpack().x, 1e-4f);
+    }
+
+    TEST(CompactVertexTest, CompactVertex_Vertex) {
+        Vertex v({1, 2, 3}, {0, 1, 0}, {0.5f, 0.25f});
+        Vertex u = CompactVertex(v).unpack();
+        EXPECT_EQ(v.pos, u.pos);
+        EXPECT_EQ(v.norm, u.norm);
+        EXPECT_EQ(v.uv, u.uv);
+    }
+
+    TEST(CompactVertexTest, fromVertices) {
+        // Not a multiple of 4 to cover the bulk and remaining vertices
+        vector<Vertex> vertices;
+        for (int i = 0; i < 7; i++) {
+            vertices.emplace_back(glm::vec3(i),
+                                  glm::vec3(i * 0.3f - 1, 0.5f, i * -0.25f),
+                                  glm::vec2(i * 0.1f, 1.0f / (i + 1)));
+        }
+
+        auto compact = CompactVertex::fromVertices(vertices);
+        ASSERT_EQ(vertices.size(), compact.size());
+        for (std::size_t i = 0; i < vertices.size(); i++) {
+            CompactVertex expected(vertices[i]);
+            EXPECT_EQ(expected.pos, compact[i].pos);
+            EXPECT_EQ(expected.norm.bits, compact[i].norm.bits);
+            EXPECT_EQ(expected.uv.x, compact[i].uv.x);
+            EXPECT_EQ(expected.uv.y, compact[i].uv.y);
+        }
+    }
+
+    TEST(IndexedMeshTest, weld) {
+        Vertex a({0, 0, 0}, {0, 0, 1}, {0, 0});
+        Vertex b({1, 0, 0}, {0, 0, 1}, {1, 0});
+        Vertex c({1, 1, 0}, {0, 0, 1}, {1, 1});
+        Vertex d({0, 1, 0}, {0, 0, 1}, {0, 1});
+
+        auto mesh = IndexedMesh::weld({a, b, c, a, c, d});
+        EXPECT_EQ(4, mesh.vertices.size());
+        EXPECT_EQ(vector<GLuint>({0, 1, 2, 0, 2, 3}), mesh.indices);
+        EXPECT_EQ(GL_UNSIGNED_BYTE, mesh.getIndexType());
+    }
+
+    TEST(IndexedMeshTest, weld_epsilon) {
+        // Within epsilon across a cell border, and just outside epsilon
+        Vertex a({0.99999f, 0, 0}, {0, 0, 1}, {0, 0});
+        Vertex b({1.00001f, 0, 0}, {0, 0, 1}, {0, 0});
+        Vertex c({1.1f, 0, 0}, {0, 0, 1}, {0, 0});
+
+        auto mesh = IndexedMesh::weld({a, b, c}, 0.001f);
+        EXPECT_EQ(2, mesh.vertices.size());
+        EXPECT_EQ(vector<GLuint>({0, 0, 1}), mesh.indices);
+    }
+
+    TEST(IndexedMeshTest, weld_attributes) {
+        // Same position with a different normal or uv is not merged
+        Vertex a({0, 0, 0}, {0, 0, 1}, {0, 0});
+        Vertex b({0, 0, 0}, {0, 1, 0}, {0, 0});
+        Vertex c({0, 0, 0}, {0, 0, 1}, {0.5f, 0});
+
+        auto mesh = IndexedMesh::weld({a, b, c});
+        EXPECT_EQ(3, mesh.vertices.size());
+    }
+
+    TEST(IndexedMeshTest, getIndexType) {
+        IndexedMesh mesh;
+        mesh.vertices.resize(256);
+        EXPECT_EQ(GL_UNSIGNED_BYTE, mesh.getIndexType());
+        mesh.vertices.resize(65536);
+        EXPECT_EQ(GL_UNSIGNED_SHORT, mesh.getIndexType());
+        mesh.vertices.resize(65537);
+        EXPECT_EQ(GL_UNSIGNED_INT, mesh.getIndexType());
+    }
+}
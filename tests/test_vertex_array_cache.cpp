@@ -0,0 +1,164 @@
+#include <glpp/Buffer.hpp>
+#include <glpp/BufferArena.hpp>
+#include <glpp/VertexArrayCache.hpp>
+using namespace glpp;
+
+#include <gtest/gtest.h>
+
+#include <iostream>
+#include <stdexcept>
+
+#include "glTest.hpp"
+
+namespace {
+    class VertexArrayCacheTest : public GLTest {
+    protected:
+        VertexArrayCache & cache;
+        vector<Buffer::Attribute> attributes;
+
+        VertexArrayCacheTest()
+            : GLTest(),
+              cache(VertexArrayCache::current()),
+              attributes({
+                  {0, 3, GL_FLOAT, false, 7 * sizeof(float), 0},
+                  {1, 4, GL_FLOAT, false, 7 * sizeof(float),
+                   (void *)(3 * sizeof(float))},
+              }) {
+            cache.setVertexAttribBinding(true);
+            cache.resetCounters();
+        }
+    };
+
+    TEST_F(VertexArrayCacheTest, current) {
+        EXPECT_EQ(&cache, &VertexArrayCache::current());
+        EXPECT_EQ(&cache, VertexArrayCache::existing());
+    }
+
+    TEST_F(VertexArrayCacheTest, get_same) {
+        Buffer buffer;
+        buffer.bufferData(256, nullptr);
+        auto & a = cache.get(buffer, attributes, 28);
+        auto & b = cache.get(buffer, attributes, 28);
+        EXPECT_EQ(&a, &b);
+        EXPECT_NE(0, a.getArrayId());
+        EXPECT_EQ(1, cache.size());
+        EXPECT_EQ(1, cache.getCounters().hits);
+        EXPECT_EQ(1, cache.getCounters().misses);
+    }
+
+    TEST_F(VertexArrayCacheTest, get_otherLayout) {
+        Buffer buffer;
+        buffer.bufferData(256, nullptr);
+        cache.get(buffer, attributes);
+        cache.get(buffer, {{0, 3, GL_FLOAT, false, 3 * sizeof(float), 0}});
+        EXPECT_EQ(2, cache.size());
+        EXPECT_EQ(2, cache.getCounters().misses);
+    }
+
+    TEST_F(VertexArrayCacheTest, get_integer) {
+        Buffer buffer;
+        buffer.bufferData(256, nullptr);
+        cache.get(buffer, {{0, 4, GL_UNSIGNED_INT, false, 16, 0}});
+        auto & array =
+            cache.get(buffer, {{0, 4, GL_UNSIGNED_INT, false, 16, 0, 0, true}});
+        EXPECT_EQ(2, cache.size());
+        EXPECT_EQ(2, cache.getCounters().misses);
+
+        GLint integer = GL_FALSE;
+        array.bind();
+        glGetVertexAttribiv(0, GL_VERTEX_ATTRIB_ARRAY_INTEGER, &integer);
+        EXPECT_EQ(GL_TRUE, integer);
+    }
+
+    TEST_F(VertexArrayCacheTest, get_otherBuffer) {
+        Buffer a, b;
+        a.bufferData(256, nullptr);
+        b.bufferData(256, nullptr);
+        cache.get(a, attributes);
+        cache.get(b, attributes, 28);
+        // One array per layout when the buffer can be swapped
+        std::size_t expected = cache.hasVertexAttribBinding() ? 1 : 2;
+        EXPECT_EQ(expected, cache.size());
+    }
+
+    TEST_F(VertexArrayCacheTest, get_withoutAttribBinding) {
+        cache.setVertexAttribBinding(false);
+        EXPECT_FALSE(cache.hasVertexAttribBinding());
+        EXPECT_EQ(0, cache.size());
+
+        Buffer buffer;
+        buffer.bufferData(256, nullptr);
+        cache.get(buffer, attributes);
+        cache.get(buffer, attributes, 28);
+        cache.get(buffer, attributes, 28);
+        EXPECT_EQ(2, cache.size());
+        EXPECT_EQ(1, cache.getCounters().hits);
+    }
+
+    TEST_F(VertexArrayCacheTest, get_packedNotShared) {
+        // Stride 0 can not be used with glBindVertexBuffer
+        vector<Buffer::Attribute> packed {{0, 3, GL_FLOAT, false, 0, 0}};
+        Buffer a, b;
+        a.bufferData(256, nullptr);
+        b.bufferData(256, nullptr);
+        cache.get(a, packed);
+        cache.get(b, packed);
+        EXPECT_EQ(2, cache.size());
+    }
+
+    TEST_F(VertexArrayCacheTest, deleteBuffer) {
+        cache.setVertexAttribBinding(false);
+        {
+            Buffer buffer;
+            buffer.bufferData(256, nullptr);
+            cache.get(buffer, attributes);
+            EXPECT_EQ(1, cache.size());
+        }
+        EXPECT_EQ(0, cache.size());
+    }
+
+    TEST_F(VertexArrayCacheTest, releaseRange) {
+        cache.setVertexAttribBinding(false);
+        Buffer buffer;
+        buffer.bufferData(256, nullptr);
+        cache.get(buffer, attributes, 0);
+        cache.get(buffer, attributes, 128);
+        EXPECT_EQ(2, cache.size());
+
+        cache.releaseRange(buffer.getBufferId(), 100, 28);
+        EXPECT_EQ(2, cache.size());
+        cache.releaseRange(buffer.getBufferId(), 128, 64);
+        EXPECT_EQ(1, cache.size());
+    }
+
+    TEST_F(VertexArrayCacheTest, releaseRange_arenaBlock) {
+        cache.setVertexAttribBinding(false);
+        BufferArena arena(1024);
+        auto a = arena.allocate(128);
+        auto b = arena.allocate(128);
+        cache.get(*a->buffer, attributes, a->offset);
+        cache.get(*b->buffer, attributes, b->offset);
+        EXPECT_EQ(2, cache.size());
+
+        a.reset();
+        EXPECT_EQ(1, cache.size());
+        // Moving b drops the array at its old offset
+        arena.defragment();
+        EXPECT_EQ(0, cache.size());
+    }
+
+    TEST_F(VertexArrayCacheTest, clear) {
+        Buffer buffer;
+        buffer.bufferData(256, nullptr);
+        cache.get(buffer, attributes);
+        cache.clear();
+        EXPECT_EQ(0, cache.size());
+    }
+
+    TEST_F(VertexArrayCacheTest, drawArrays) {
+        Buffer buffer;
+        buffer.bufferData(7 * sizeof(float) * 3, nullptr);
+        cache.get(buffer, attributes).drawArrays(Buffer::Triangles, 0, 3);
+        EXPECT_EQ(GL_NO_ERROR, glGetError());
+    }
+}
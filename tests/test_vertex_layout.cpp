@@ -0,0 +1,132 @@
+#include <glpp/Shader.hpp>
+#include <glpp/TransformFeedback.hpp>
+#include <glpp/VertexLayout.hpp>
+#include <glpp/extra/Vertex.hpp>
+using namespace glpp;
+using namespace glpp::extra;
+
+#include <gtest/gtest.h>
+
+#include <iostream>
+#include <stdexcept>
+
+#include "glTest.hpp"
+
+static const char * integerShaderSource = R"(
+#version 330 core
+layout (location = 2) in uvec4 ids;
+layout (location = 3) in uint flags;
+flat out uvec4 outIds;
+flat out uint outFlags;
+void main() {
+    outIds = ids;
+    outFlags = flags;
+})";
+
+namespace {
+    struct Instance {
+        glm::vec2 offset;
+        float scale;
+        glm::uvec4 ids;
+        std::uint8_t flags;
+    };
+
+    using VertexAttributes =
+        VertexLayout<Vertex, &Vertex::pos, &Vertex::norm, &Vertex::uv>;
+
+    using InstanceAttributes = VertexLayout<Instance,
+                                            &Instance::offset,
+                                            &Instance::scale,
+                                            &Instance::ids,
+                                            &Instance::flags>;
+
+    TEST(VertexLayoutTest, compile_time) {
+        static_assert(VertexAttributes::count == 3);
+        static_assert(VertexAttributes::stride == sizeof(Vertex));
+        static_assert(VertexAttributes::sizes[0] == 3);
+        static_assert(VertexAttributes::sizes[2] == 2);
+        static_assert(VertexAttributes::types[1] == GL_FLOAT);
+        static_assert(InstanceAttributes::types[2] == GL_UNSIGNED_INT);
+        static_assert(InstanceAttributes::types[3] == GL_UNSIGNED_BYTE);
+        static_assert(!VertexAttributes::integers[0]);
+        static_assert(!InstanceAttributes::integers[1]);
+        static_assert(InstanceAttributes::integers[2]);
+        static_assert(InstanceAttributes::integers[3]);
+    }
+
+    TEST(VertexLayoutTest, Vertex_attributes) {
+        auto attrs = VertexAttributes::attributes();
+        ASSERT_EQ(3, attrs.size());
+
+        EXPECT_EQ(0, attrs[0].index);
+        EXPECT_EQ(3, attrs[0].size);
+        EXPECT_EQ(GL_FLOAT, attrs[0].type);
+        EXPECT_EQ(sizeof(Vertex), attrs[0].stride);
+        EXPECT_EQ((const void *)0, attrs[0].pointer);
+
+        EXPECT_EQ(1, attrs[1].index);
+        EXPECT_EQ((const void *)(3 * sizeof(float)), attrs[1].pointer);
+
+        EXPECT_EQ(2, attrs[2].index);
+        EXPECT_EQ(2, attrs[2].size);
+        EXPECT_EQ((const void *)(6 * sizeof(float)), attrs[2].pointer);
+    }
+
+    TEST(VertexLayoutTest, firstIndex_divisor) {
+        auto attrs = InstanceAttributes::attributes(3, 1);
+        ASSERT_EQ(4, attrs.size());
+        for (std::size_t i = 0; i < attrs.size(); i++) {
+            EXPECT_EQ(3 + i, attrs[i].index);
+            EXPECT_EQ(1, attrs[i].divisor);
+            EXPECT_EQ(sizeof(Instance), attrs[i].stride);
+        }
+        EXPECT_EQ((const void *)offsetof(Instance, scale), attrs[1].pointer);
+        EXPECT_EQ((const void *)offsetof(Instance, ids), attrs[2].pointer);
+        EXPECT_EQ((const void *)offsetof(Instance, flags), attrs[3].pointer);
+    }
+
+    TEST(VertexLayoutTest, integer_attributes) {
+        auto attrs = InstanceAttributes::attributes();
+        EXPECT_FALSE(attrs[0].integer);
+        EXPECT_FALSE(attrs[1].integer);
+        EXPECT_TRUE(attrs[2].integer);
+        EXPECT_TRUE(attrs[3].integer);
+    }
+
+    class VertexLayoutGLTest : public GLTest {};
+
+    TEST_F(VertexLayoutGLTest, integer_capture) {
+        if (!TransformFeedback::isSupported())
+            GTEST_SKIP();
+
+        // Values that do not survive a round trip through float
+        Instance instance {glm::vec2(0), 1.0f, glm::uvec4(1, 70001, 0xFFFFFFF1u, 3), 200};
+
+        BufferArray array({InstanceAttributes::attributes()});
+        array.bufferData(0, sizeof(instance), &instance);
+
+        Shader shader =
+            Shader::fromVertexSource(integerShaderSource, {"outIds", "outFlags"});
+        Buffer output(Buffer::TransformFeedback);
+        output.bufferData(5 * sizeof(GLuint), nullptr, Buffer::StreamRead);
+        TransformFeedback feedback;
+        feedback.bindBuffer(0, output);
+
+        shader.bind();
+        array.bind();
+        glEnable(GL_RASTERIZER_DISCARD);
+        feedback.begin(Buffer::Points);
+        array.drawArrays(Buffer::Points, 0, 1);
+        feedback.end();
+        glDisable(GL_RASTERIZER_DISCARD);
+
+        GLuint values[5] {};
+        output.bind();
+        glGetBufferSubData(GL_TRANSFORM_FEEDBACK_BUFFER, 0, sizeof(values), values);
+        EXPECT_EQ(1, values[0]);
+        EXPECT_EQ(70001, values[1]);
+        EXPECT_EQ(0xFFFFFFF1u, values[2]);
+        EXPECT_EQ(3, values[3]);
+        EXPECT_EQ(200, values[4]);
+    }
+}